@@ -31,12 +31,9 @@ SpaceshipAudioEngine::SpaceshipAudioEngine() : m_impl(std::make_unique<Impl>())
             float* leftChannel = (float*)outputData->mBuffers[0].mData;
             float* rightChannel = outputData->mNumberBuffers > 1 ? (float*)outputData->mBuffers[1].mData : leftChannel;
             
-            for (AVAudioFrameCount i = 0; i < frameCount; i++)
-            {
-                float sample = synthPtr->processSample();
-                leftChannel[i] = sample;
-                rightChannel[i] = sample;
-            }
+            synthPtr->renderMono(leftChannel, (int)frameCount);
+            if (rightChannel != leftChannel)
+                memcpy(rightChannel, leftChannel, frameCount * sizeof(float));
             
             *isSilence = NO;
             return noErr;
@@ -0,0 +1,190 @@
+//
+//  RMDLAnimationCompression.cpp
+//  Spammy
+//
+//  Created by Rémy on 17/10/2026.
+//
+
+#include "RMDLAnimationCompression.hpp"
+#include "RMDLBlender.hpp"
+
+#include <algorithm>
+
+namespace animcompression
+{
+
+static simd::float3 interpolate(simd::float3 a, simd::float3 b, float t) { return simd_mix(a, b, t); }
+static simd::quatf interpolate(simd::quatf a, simd::quatf b, float t) { return simd::slerp(a, b, t); }
+
+static float keyError(simd::float3 a, simd::float3 b) { return simd::length(a - b); }
+static float keyError(simd::quatf a, simd::quatf b)
+{
+    float d = std::fabs(simd_dot(a, b));
+    return 2.0f * std::acos(std::fmin(d, 1.0f));
+}
+
+// Garde la première et la dernière clé, et étend chaque segment tant que l'interpolation
+// entre ses extrémités reproduit toutes les clés retirées à tolerance près.
+template<typename T>
+static void reduceKeys(const std::vector<KeyFrame<T>>& keys, float tolerance, std::vector<uint32_t>& kept)
+{
+    kept.clear();
+    if (keys.empty())
+        return;
+
+    kept.push_back(0);
+    const uint32_t last = (uint32_t)keys.size() - 1;
+    uint32_t anchor = 0;
+    uint32_t end = 1;
+
+    while (end < last)
+    {
+        uint32_t candidate = end + 1;
+        float span = keys[candidate].time - keys[anchor].time;
+        bool fits = true;
+
+        for (uint32_t k = anchor + 1; k < candidate && fits; k++)
+        {
+            float t = span > 0.0f ? (keys[k].time - keys[anchor].time) / span : 0.0f;
+            fits = keyError(interpolate(keys[anchor].value, keys[candidate].value, t), keys[k].value) <= tolerance;
+        }
+        if (!fits)
+        {
+            kept.push_back(end);
+            anchor = end;
+        }
+        end = candidate;
+    }
+    if (last > 0)
+        kept.push_back(last);
+}
+
+static void encodeRotation(simd::quatf q, uint16_t* out)
+{
+    simd::float4 v = simd::normalize(q.vector);
+    uint32_t largest = 0;
+    for (uint32_t i = 1; i < 4; i++)
+        if (std::fabs(v[i]) > std::fabs(v[largest]))
+            largest = i;
+    // q et -q sont la même rotation : la plus grande composante reste positive
+    if (v[largest] < 0.0f)
+        v = -v;
+
+    for (uint32_t i = 0, s = 0; i < 4; i++)
+    {
+        if (i == largest)
+            continue;
+        float n = std::clamp(v[i] / SMALLEST_THREE_RANGE * 0.5f + 0.5f, 0.0f, 1.0f);
+        out[s++] = (uint16_t)std::lround(n * 32767.0f);
+    }
+    out[0] |= (uint16_t)((largest >> 1) << 15);
+    out[1] |= (uint16_t)((largest & 1) << 15);
+}
+
+// Pools du clip en construction, confiés à CompressedAnimation une fois tous les canaux encodés
+struct PoolBuilder
+{
+    std::vector<CompressedChannel> channels;
+    std::vector<float> times;
+    std::vector<uint16_t> values;
+};
+
+static void appendVec3Track(const std::vector<KeyFrame<simd::float3>>& keys, float tolerance, std::vector<uint32_t>& kept, QuantizedTrack& track, PoolBuilder& out)
+{
+    reduceKeys(keys, tolerance, kept);
+    track.firstKey = (uint32_t)out.times.size();
+    track.keyCount = (uint32_t)kept.size();
+    if (kept.empty())
+        return;
+
+    simd::float3 lo = keys[kept[0]].value;
+    simd::float3 hi = lo;
+    for (uint32_t k : kept)
+    {
+        lo = simd::min(lo, keys[k].value);
+        hi = simd::max(hi, keys[k].value);
+    }
+    track.rangeMin = lo;
+    track.rangeExtent = hi - lo;
+
+    for (uint32_t k : kept)
+    {
+        out.times.push_back(keys[k].time);
+        for (int a = 0; a < 3; a++)
+        {
+            float n = track.rangeExtent[a] > 0.0f ? (keys[k].value[a] - lo[a]) / track.rangeExtent[a] : 0.0f;
+            out.values.push_back((uint16_t)std::lround(std::clamp(n, 0.0f, 1.0f) * 65535.0f));
+        }
+    }
+}
+
+static void appendRotationTrack(const std::vector<KeyFrame<simd::quatf>>& keys, float tolerance, std::vector<uint32_t>& kept, QuantizedTrack& track, PoolBuilder& out)
+{
+    reduceKeys(keys, tolerance, kept);
+    track.firstKey = (uint32_t)out.times.size();
+    track.keyCount = (uint32_t)kept.size();
+
+    for (uint32_t k : kept)
+    {
+        uint16_t q[3] = {};
+        encodeRotation(keys[k].value, q);
+        out.times.push_back(keys[k].time);
+        out.values.insert(out.values.end(), q, q + 3);
+    }
+}
+
+// Même choix de clés que le sampler runtime, par recherche binaire
+template<typename Decode>
+static auto sampleTrack(const PoolBuilder& clip, const QuantizedTrack& track, float time, Decode decode)
+{
+    const float* times = clip.times.data() + track.firstKey;
+    const uint16_t* values = clip.values.data() + 3 * (size_t)track.firstKey;
+    if (track.keyCount == 1)
+        return decode(values);
+
+    uint32_t i = (uint32_t)(std::lower_bound(times + 1, times + track.keyCount, time) - times) - 1;
+    uint32_t j = (i + 1) % track.keyCount;
+    float dt = times[j] - times[i];
+    float t = dt > 0.0f ? (time - times[i]) / dt : 0.0f;
+    return interpolate(decode(values + 3 * i), decode(values + 3 * j), t);
+}
+
+Stats compress(const Animation& anim, const Settings& settings, CompressedAnimation& out)
+{
+    Stats stats;
+    PoolBuilder pools;
+    pools.channels.assign(anim.channels.size(), CompressedChannel{});
+    std::vector<uint32_t> kept;
+
+    for (size_t c = 0; c < anim.channels.size(); c++)
+    {
+        const BoneAnimation& ch = anim.channels[c];
+        CompressedChannel& cc = pools.channels[c];
+
+        appendVec3Track(ch.positions, settings.positionTolerance, kept, cc.position, pools);
+        appendRotationTrack(ch.rotations, settings.rotationTolerance, kept, cc.rotation, pools);
+        appendVec3Track(ch.scales, settings.scaleTolerance, kept, cc.scale, pools);
+
+        stats.rawKeys += ch.positions.size() + ch.rotations.size() + ch.scales.size();
+        stats.rawBytes += ch.positions.size() * sizeof(KeyFrame<simd::float3>) + ch.rotations.size() * sizeof(KeyFrame<simd::quatf>) + ch.scales.size() * sizeof(KeyFrame<simd::float3>);
+
+        auto decodePosition = [&cc](const uint16_t* q) { return decodeVec3(q, cc.position); };
+        auto decodeScale = [&cc](const uint16_t* q) { return decodeVec3(q, cc.scale); };
+
+        for (const auto& key : ch.positions)
+            stats.maxPositionError = std::max(stats.maxPositionError, keyError(sampleTrack(pools, cc.position, key.time, decodePosition), key.value));
+        for (const auto& key : ch.rotations)
+            stats.maxRotationError = std::max(stats.maxRotationError, keyError(sampleTrack(pools, cc.rotation, key.time, decodeRotation), key.value));
+        for (const auto& key : ch.scales)
+            stats.maxScaleError = std::max(stats.maxScaleError, keyError(sampleTrack(pools, cc.scale, key.time, decodeScale), key.value));
+    }
+
+    stats.keptKeys = pools.times.size();
+    stats.compressedBytes = pools.channels.size() * sizeof(CompressedChannel) + pools.times.size() * sizeof(float) + pools.values.size() * sizeof(uint16_t);
+    out.channels.assign(std::move(pools.channels));
+    out.times.assign(std::move(pools.times));
+    out.values.assign(std::move(pools.values));
+    return stats;
+}
+
+}
@@ -0,0 +1,156 @@
+//
+//  RMDLAnimationCompression.hpp
+//  Spammy
+//
+//  Created by Rémy on 17/10/2026.
+//
+
+#ifndef RMDLAnimationCompression_hpp
+#define RMDLAnimationCompression_hpp
+
+#include <simd/simd.h>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <cmath>
+#include <utility>
+
+struct Animation;
+
+// Compression hors-ligne des pistes de clés : réduction des clés redondantes à erreur bornée,
+// puis quantification (vec3 sur 3 x 16 bits dans la plage de la piste, rotations en
+// smallest-three sur 48 bits). Les décodeurs sont inline, ils tournent dans le sampler.
+namespace animcompression
+{
+
+constexpr float SMALLEST_THREE_RANGE = 0.70710678f; // |composante| max hors la plus grande
+
+// Clés [firstKey, firstKey + keyCount) dans les pools du clip
+struct QuantizedTrack
+{
+    uint32_t firstKey = 0;
+    uint32_t keyCount = 0;
+    simd::float3 rangeMin = {};     // translations / échelles uniquement
+    simd::float3 rangeExtent = {};
+};
+
+struct CompressedChannel
+{
+    QuantizedTrack position;
+    QuantizedTrack rotation;
+    QuantizedTrack scale;
+};
+
+// Tableau en lecture seule : possédé quand il sort de compress(), simple vue sur la section
+// du cache mappé au chargement (le modèle garde le fichier ouvert, aucune copie)
+template<typename T>
+class Pool
+{
+public:
+    Pool() = default;
+    Pool(const Pool& other) { *this = other; }
+    Pool(Pool&& other) noexcept { *this = std::move(other); }
+
+    Pool& operator=(const Pool& other)
+    {
+        m_owned = other.m_owned;
+        m_data = m_owned.empty() ? other.m_data : m_owned.data();
+        m_size = other.m_size;
+        return *this;
+    }
+
+    Pool& operator=(Pool&& other) noexcept
+    {
+        m_owned = std::move(other.m_owned);
+        m_data = m_owned.empty() ? other.m_data : m_owned.data();
+        m_size = other.m_size;
+        other.m_owned.clear();
+        other.m_data = nullptr;
+        other.m_size = 0;
+        return *this;
+    }
+
+    void assign(std::vector<T> values)
+    {
+        m_owned = std::move(values);
+        m_data = m_owned.data();
+        m_size = m_owned.size();
+    }
+
+    void view(const T* data, size_t size)
+    {
+        std::vector<T>().swap(m_owned);
+        m_data = data;
+        m_size = size;
+    }
+
+    const T* data() const { return m_data; }
+    size_t size() const { return m_size; }
+    bool empty() const { return m_size == 0; }
+    const T& operator[](size_t i) const { return m_data[i]; }
+    const T* begin() const { return m_data; }
+    const T* end() const { return m_data + m_size; }
+
+private:
+    std::vector<T>  m_owned;
+    const T*        m_data = nullptr;
+    size_t          m_size = 0;
+};
+
+// Une clé = un temps + 3 x uint16, quel que soit le type de piste
+struct CompressedAnimation
+{
+    Pool<CompressedChannel> channels;
+    Pool<float> times;
+    Pool<uint16_t> values;
+
+    bool empty() const { return channels.empty(); }
+};
+
+struct Settings
+{
+    float positionTolerance = 1e-3f;    // unités du modèle
+    float rotationTolerance = 1e-3f;    // radians
+    float scaleTolerance = 1e-3f;
+};
+
+struct Stats
+{
+    size_t rawKeys = 0;
+    size_t keptKeys = 0;
+    size_t rawBytes = 0;
+    size_t compressedBytes = 0;
+    float maxPositionError = 0.0f;
+    float maxRotationError = 0.0f;      // radians
+    float maxScaleError = 0.0f;
+
+    float ratio() const { return compressedBytes ? (float)rawBytes / (float)compressedBytes : 0.0f; }
+};
+
+// Les erreurs sont mesurées en rééchantillonnant le résultat décodé à chaque clé d'origine
+Stats compress(const Animation& anim, const Settings& settings, CompressedAnimation& out);
+
+inline simd::float3 decodeVec3(const uint16_t* q, const QuantizedTrack& track)
+{
+    simd::float3 n = simd::float3{ (float)q[0], (float)q[1], (float)q[2] } * (1.0f / 65535.0f);
+    return track.rangeMin + n * track.rangeExtent;
+}
+
+// 15 bits par composante ; l'index de la plus grande est dans le bit de poids fort de q[0] et q[1]
+inline simd::quatf decodeRotation(const uint16_t* q)
+{
+    uint32_t largest = ((q[0] >> 15) << 1) | (q[1] >> 15);
+    float small[3];
+    for (int i = 0; i < 3; i++)
+        small[i] = ((q[i] & 0x7FFF) * (2.0f / 32767.0f) - 1.0f) * SMALLEST_THREE_RANGE;
+
+    float w = std::sqrt(std::fmax(0.0f, 1.0f - small[0] * small[0] - small[1] * small[1] - small[2] * small[2]));
+    simd::float4 v;
+    for (uint32_t i = 0, s = 0; i < 4; i++)
+        v[i] = (i == largest) ? w : small[s++];
+    return simd_quaternion(v);
+}
+
+}
+
+#endif /* RMDLAnimationCompression_hpp */
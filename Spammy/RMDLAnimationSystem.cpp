@@ -0,0 +1,281 @@
+//
+//  RMDLAnimationSystem.cpp
+//  Spammy
+//
+//  Created by Rémy on 17/10/2026.
+//
+
+#include "RMDLAnimationSystem.hpp"
+
+#include <chrono>
+#include <cmath>
+#include <algorithm>
+
+AnimationSystem::AnimationSystem(uint32_t workerCount)
+: _nextJob(0)
+{
+    _workerCount = workerCount ? workerCount : std::max(1u, std::thread::hardware_concurrency()) - 1;
+    _scratch.resize(_workerCount + 1);
+}
+
+AnimationSystem::~AnimationSystem()
+{
+    stopWorkers();
+}
+
+uint32_t AnimationSystem::addInstance(const Blender* rig, size_t clip)
+{
+    AnimationInstance instance;
+    instance.rig = rig;
+    instance.paletteOffset = (uint32_t)_palette.size();
+    _palette.insert(_palette.end(), rig->boneOffsets.begin(), rig->boneOffsets.end());
+
+    // Les scratchs suivent le plus gros skeleton : aucune allocation pendant update
+    if (rig->skeleton.size() > _maxNodeCount)
+    {
+        _maxNodeCount = rig->skeleton.size();
+        for (auto& scratch : _scratch)
+        {
+            scratch.pose.resize(_maxNodeCount);
+            scratch.fadePose.resize(_maxNodeCount);
+            scratch.globals.resize(_maxNodeCount);
+        }
+    }
+
+    _instances.push_back(std::move(instance));
+    uint32_t index = (uint32_t)_instances.size() - 1;
+    play(index, clip);
+    return index;
+}
+
+void AnimationSystem::clear()
+{
+    _instances.clear();
+    _palette.clear();
+    _evaluated.clear();
+}
+
+void AnimationSystem::play(uint32_t index, size_t clip, bool loop, float fadeDuration)
+{
+    AnimationInstance& instance = _instances[index];
+    if (clip >= instance.rig->animations.size())
+        return;
+
+    size_t channelCount = instance.rig->animations[clip].channels.size();
+    instance.loop = loop;
+    instance.playing = true;
+
+    if (fadeDuration > 0.0f)
+    {
+        instance.fading = true;
+        instance.targetClip = clip;
+        instance.targetTime = 0.0f;
+        instance.fadeTime = 0.0f;
+        instance.fadeDuration = fadeDuration;
+        instance.targetCursors.assign(channelCount, KeyCursor{});
+    }
+    else
+    {
+        instance.fading = false;
+        instance.clip = clip;
+        instance.time = 0.0f;
+        instance.cursors.assign(channelCount, KeyCursor{});
+    }
+}
+
+void AnimationSystem::setState(uint32_t index, uint32_t state, size_t clip, float fadeDuration)
+{
+    AnimationInstance& instance = _instances[index];
+    if (instance.state == state)
+        return;
+
+    instance.state = state;
+    play(index, clip, true, fadeDuration);
+}
+
+void AnimationSystem::setSpeed(uint32_t index, float speed)
+{
+    _instances[index].speed = speed;
+}
+
+void AnimationSystem::setPosition(uint32_t index, simd::float3 position)
+{
+    _instances[index].position = position;
+}
+
+void AnimationSystem::setLodDistances(float lodNear, float lodFar)
+{
+    _lodNearSq = lodNear * lodNear;
+    _lodFarSq = lodFar * lodFar;
+}
+
+void AnimationSystem::setWorkerCount(uint32_t workerCount)
+{
+    stopWorkers();
+    _workerCount = workerCount;
+    _scratch.resize(_workerCount + 1);
+    for (auto& scratch : _scratch)
+    {
+        scratch.pose.resize(_maxNodeCount);
+        scratch.fadePose.resize(_maxNodeCount);
+        scratch.globals.resize(_maxNodeCount);
+    }
+}
+
+void AnimationSystem::update(float deltaTime, simd::float3 viewPosition)
+{
+    auto start = std::chrono::steady_clock::now();
+    _frame++;
+    _evaluated.clear();
+
+    for (uint32_t i = 0; i < _instances.size(); i++)
+    {
+        AnimationInstance& instance = _instances[i];
+        advance(instance, deltaTime);
+
+        float distanceSq = simd::length_squared(instance.position - viewPosition);
+        instance.updateInterval = distanceSq > _lodFarSq ? 4 : (distanceSq > _lodNearSq ? 2 : 1);
+
+        // Décalé par instance pour étaler les évaluations des instances lointaines
+        if ((_frame + i) % instance.updateInterval == 0)
+            _evaluated.push_back(i);
+    }
+
+    _jobCount = ((uint32_t)_evaluated.size() + INSTANCES_PER_JOB - 1) / INSTANCES_PER_JOB;
+    _nextJob = 0;
+
+    if (_jobCount > 1 && _workerCount > 0)
+    {
+        if (!_running)
+            startWorkers();
+        {
+            std::lock_guard<std::mutex> lock(_jobMutex);
+            _busyWorkers = _workerCount;
+            _jobGeneration++;
+        }
+        _jobCondition.notify_all();
+
+        runJobs(0);
+
+        std::unique_lock<std::mutex> lock(_jobMutex);
+        _doneCondition.wait(lock, [this] { return _busyWorkers == 0; });
+    }
+    else
+        runJobs(0);
+
+    _lastUpdateMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+void AnimationSystem::advance(AnimationInstance& instance, float deltaTime)
+{
+    if (!instance.playing)
+        return;
+
+    const Blender& rig = *instance.rig;
+    const Animation& anim = rig.animations[instance.clip];
+    instance.time += deltaTime * anim.ticksPerSec * instance.speed;
+
+    if (instance.time > anim.duration)
+    {
+        if (instance.loop)
+            instance.time = fmod(instance.time, anim.duration);
+        else
+        {
+            instance.time = anim.duration;
+            instance.playing = instance.fading;
+        }
+    }
+
+    if (!instance.fading)
+        return;
+
+    const Animation& target = rig.animations[instance.targetClip];
+    instance.fadeTime += deltaTime;
+    instance.targetTime += deltaTime * target.ticksPerSec * instance.speed;
+    if (instance.targetTime > target.duration)
+        instance.targetTime = instance.loop ? fmod(instance.targetTime, target.duration) : target.duration;
+
+    if (instance.fadeTime >= instance.fadeDuration)
+    {
+        instance.fading = false;
+        instance.playing = true;
+        instance.clip = instance.targetClip;
+        instance.time = instance.targetTime;
+        std::swap(instance.cursors, instance.targetCursors);
+    }
+}
+
+void AnimationSystem::evaluate(AnimationInstance& instance, WorkerScratch& scratch)
+{
+    const Blender& rig = *instance.rig;
+    RMDLBlender::samplePose(instance.time, rig.animations[instance.clip], instance.cursors, rig.bindPose, scratch.pose);
+
+    if (instance.fading)
+    {
+        float t = instance.fadeTime / instance.fadeDuration;
+        float w = t * t * (3.0f - 2.0f * t);
+        RMDLBlender::samplePose(instance.targetTime, rig.animations[instance.targetClip], instance.targetCursors, rig.bindPose, scratch.fadePose);
+        RMDLBlender::blendPose(scratch.pose, scratch.fadePose, w, nullptr);
+    }
+
+    RMDLBlender::computePalette(rig, scratch.pose, scratch.globals.data(), _palette.data() + instance.paletteOffset);
+}
+
+// Chaque thread prend des paquets d'instances jusqu'à épuisement : les instances n'ont
+// aucune donnée en commun à part le rig en lecture seule et leur tranche de palette
+void AnimationSystem::runJobs(uint32_t scratchIndex)
+{
+    WorkerScratch& scratch = _scratch[scratchIndex];
+
+    for (uint32_t job = _nextJob++; job < _jobCount; job = _nextJob++)
+    {
+        uint32_t begin = job * INSTANCES_PER_JOB;
+        uint32_t end = std::min(begin + INSTANCES_PER_JOB, (uint32_t)_evaluated.size());
+        for (uint32_t i = begin; i < end; i++)
+            evaluate(_instances[_evaluated[i]], scratch);
+    }
+}
+
+void AnimationSystem::startWorkers()
+{
+    _running = true;
+    for (uint32_t i = 0; i < _workerCount; i++)
+        _workers.emplace_back(&AnimationSystem::workerThread, this, i + 1, _jobGeneration);
+}
+
+void AnimationSystem::stopWorkers()
+{
+    {
+        std::lock_guard<std::mutex> lock(_jobMutex);
+        _running = false;
+    }
+    _jobCondition.notify_all();
+
+    for (auto& worker : _workers)
+    {
+        if (worker.joinable())
+            worker.join();
+    }
+    _workers.clear();
+}
+
+// seenGeneration est fixé au lancement : un worker démarré en retard ne rate pas la frame en cours
+void AnimationSystem::workerThread(uint32_t scratchIndex, uint64_t seenGeneration)
+{
+    while (true)
+    {
+        {
+            std::unique_lock<std::mutex> lock(_jobMutex);
+            _jobCondition.wait(lock, [&] { return !_running || _jobGeneration != seenGeneration; });
+            if (!_running)
+                return;
+            seenGeneration = _jobGeneration;
+        }
+
+        runJobs(scratchIndex);
+
+        std::lock_guard<std::mutex> lock(_jobMutex);
+        if (--_busyWorkers == 0)
+            _doneCondition.notify_one();
+    }
+}
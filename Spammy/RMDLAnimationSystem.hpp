@@ -0,0 +1,129 @@
+//
+//  RMDLAnimationSystem.hpp
+//  Spammy
+//
+//  Created by Rémy on 17/10/2026.
+//
+
+#ifndef RMDLAnimationSystem_hpp
+#define RMDLAnimationSystem_hpp
+
+#include <simd/simd.h>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <cstdint>
+
+#include "RMDLBlender.hpp"
+
+// État propre à une instance animée ; le rig (skeleton, clips) est partagé en lecture seule
+struct AnimationInstance
+{
+    const Blender*  rig = nullptr;
+    uint32_t        state = UINT32_MAX;     // état courant de la machine à états de l'appelant
+    size_t          clip = 0;
+    float           time = 0.0f;
+    float           speed = 1.0f;
+    bool            loop = true;
+    bool            playing = true;
+
+    bool            fading = false;
+    size_t          targetClip = 0;
+    float           targetTime = 0.0f;
+    float           fadeTime = 0.0f;
+    float           fadeDuration = 0.0f;
+
+    simd::float3    position = {};          // pour la LOD
+    uint32_t        paletteOffset = 0;      // première matrice dans la palette commune
+    uint32_t        updateInterval = 1;     // évaluée une frame sur updateInterval
+
+    std::vector<KeyCursor> cursors;
+    std::vector<KeyCursor> targetCursors;
+};
+
+// Anime de nombreuses instances skinnées sur un pool de workers. Chaque frame avance le temps
+// de toutes les instances, puis évalue celles dues selon leur LOD ; les bone matrices sont
+// écrites dans une palette contiguë (boneCount matrices par instance).
+// Pas encore appelé par GameCoordinator : aucun draw instancié ne lit la palette, les modèles
+// de RMDLBlender restent animés par updateBlender. Seuls les tests et benchs l'utilisent.
+// Le propriétaire le détruit avant les rigs (membre déclaré après RMDLBlender) : les workers
+// sont joints dans le destructeur et lisent les Blender jusque-là.
+class AnimationSystem
+{
+public:
+    // workerCount = 0 : hardware_concurrency - 1 ; le thread appelant participe toujours
+    explicit AnimationSystem(uint32_t workerCount = 0);
+    ~AnimationSystem();
+    AnimationSystem(const AnimationSystem&) = delete;
+    AnimationSystem& operator=(const AnimationSystem&) = delete;
+
+    // rig doit rester valide (et ne plus être déplacé) tant que l'instance existe
+    uint32_t addInstance(const Blender* rig, size_t clip = 0);
+    void clear();
+
+    void play(uint32_t instance, size_t clip, bool loop = true, float fadeDuration = 0.0f);
+    // Ne relance le clip que si state change, comme AnimationStateMachine::setState
+    void setState(uint32_t instance, uint32_t state, size_t clip, float fadeDuration = 0.2f);
+    void setSpeed(uint32_t instance, float speed);
+    void setPosition(uint32_t instance, simd::float3 position);
+
+    // Au-delà de lodNear une frame sur 2, au-delà de lodFar une frame sur 4
+    void setLodDistances(float lodNear, float lodFar);
+    void setWorkerCount(uint32_t workerCount);
+
+    void update(float deltaTime, simd::float3 viewPosition);
+
+    const AnimationInstance& getInstance(uint32_t instance) const { return _instances[instance]; }
+    const simd::float4x4* getPalette(uint32_t instance) const { return _palette.data() + _instances[instance].paletteOffset; }
+    const std::vector<simd::float4x4>& getPaletteBuffer() const { return _palette; }
+    size_t getInstanceCount() const { return _instances.size(); }
+    uint32_t getWorkerCount() const { return _workerCount; }
+
+    // Statistiques de la dernière frame
+    uint32_t getEvaluatedCount() const { return (uint32_t)_evaluated.size(); }
+    double getLastUpdateMs() const { return _lastUpdateMs; }
+
+private:
+    struct WorkerScratch
+    {
+        LocalPose pose;
+        LocalPose fadePose;
+        std::vector<simd::float4x4> globals;
+    };
+
+    static constexpr uint32_t INSTANCES_PER_JOB = 16;
+
+    void startWorkers();
+    void stopWorkers();
+    void workerThread(uint32_t scratchIndex, uint64_t seenGeneration);
+    void runJobs(uint32_t scratchIndex);
+    void advance(AnimationInstance& instance, float deltaTime);
+    void evaluate(AnimationInstance& instance, WorkerScratch& scratch);
+
+    std::vector<AnimationInstance>  _instances;
+    std::vector<simd::float4x4>     _palette;
+    std::vector<uint32_t>           _evaluated;     // instances à évaluer cette frame
+    std::vector<WorkerScratch>      _scratch;       // [0] pour le thread appelant
+    uint32_t                        _maxNodeCount = 0;
+
+    float                           _lodNearSq = 30.0f * 30.0f;
+    float                           _lodFarSq = 80.0f * 80.0f;
+    uint64_t                        _frame = 0;
+    double                          _lastUpdateMs = 0.0;
+
+    // Threading : les workers démarrent au premier update qui a assez de travail
+    uint32_t                        _workerCount;
+    std::vector<std::thread>        _workers;
+    std::mutex                      _jobMutex;
+    std::condition_variable         _jobCondition;
+    std::condition_variable         _doneCondition;
+    uint64_t                        _jobGeneration = 0;
+    uint32_t                        _busyWorkers = 0;
+    std::atomic<uint32_t>           _nextJob;
+    uint32_t                        _jobCount = 0;
+    bool                            _running = false;
+};
+
+#endif /* RMDLAnimationSystem_hpp */
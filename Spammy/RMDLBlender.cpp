@@ -6,6 +6,8 @@
 //
 
 #include "RMDLBlender.hpp"
+#include "RMDLModelCache.hpp"
+#include "RMDLFrustumCulling.hpp"
 
 static simd::float4x4 aiToSimd(const aiMatrix4x4& m)
 {
@@ -28,6 +30,46 @@ static simd::float4x4 makeTRS(simd::float3 t, simd::quatf r, simd::float3 s)
     return T * simd::float4x4(r) * S;
 }
 
+// Inverse de makeTRS pour une matrice affine sans cisaillement.
+static void decomposeTRS(const simd::float4x4& m, simd::float3& t, simd::quatf& r, simd::float3& s)
+{
+    t = m.columns[3].xyz;
+    s = simd::float3{ simd::length(m.columns[0].xyz), simd::length(m.columns[1].xyz), simd::length(m.columns[2].xyz) };
+    simd::float3x3 rotation(m.columns[0].xyz / s.x, m.columns[1].xyz / s.y, m.columns[2].xyz / s.z);
+    r = simd_quaternion(rotation);
+}
+
+// dst = mix(dst, src, weight * mask[n]) ; mask nul = tous les noeuds.
+void RMDLBlender::blendPose(LocalPose& dst, const LocalPose& src, float weight, const float* mask)
+{
+    for (size_t n = 0; n < dst.translations.size(); n++)
+    {
+        float w = mask ? weight * mask[n] : weight;
+        if (w <= 0.0f)
+            continue;
+        dst.translations[n] = simd_mix(dst.translations[n], src.translations[n], w);
+        dst.rotations[n] = simd::slerp(dst.rotations[n], src.rotations[n], w);
+        dst.scales[n] = simd_mix(dst.scales[n], src.scales[n], w);
+    }
+}
+
+// Applique sur dst l'écart entre src et la pose de référence, pondéré.
+void RMDLBlender::addPose(LocalPose& dst, const LocalPose& src, const LocalPose& reference, float weight, const float* mask)
+{
+    const simd::quatf identity = simd_quaternion(0.0f, 0.0f, 0.0f, 1.0f);
+    
+    for (size_t n = 0; n < dst.translations.size(); n++)
+    {
+        float w = mask ? weight * mask[n] : weight;
+        if (w <= 0.0f)
+            continue;
+        simd::quatf delta = src.rotations[n] * simd::inverse(reference.rotations[n]);
+        dst.translations[n] += (src.translations[n] - reference.translations[n]) * w;
+        dst.rotations[n] = simd::normalize(simd::slerp(identity, delta, w) * dst.rotations[n]);
+        dst.scales[n] *= simd_mix(simd::float3{ 1.0f, 1.0f, 1.0f }, src.scales[n] / reference.scales[n], w);
+    }
+}
+
 RMDLBlender::RMDLBlender(MTL::Device* device, MTL::PixelFormat pixelFormat, MTL::PixelFormat depthPixelFormat, const std::string& resourcesPath, MTL::Library* pShaderLibrary)
 : m_device(device->retain()),
 m_frame(0), _pCurrentTime(0.0f), _pAnimationDuration(12.0f)
@@ -38,6 +80,12 @@ m_frame(0), _pCurrentTime(0.0f), _pAnimationDuration(12.0f)
     createSampler();
 }
 
+RMDLBlender::RMDLBlender(MTL::Device* device)
+: m_device(device->retain()),
+m_frame(0), _pCurrentTime(0.0f), _pAnimationDuration(12.0f)
+{
+}
+
 RMDLBlender::~RMDLBlender()
 {
     for (auto& model : m_models) model.release();
@@ -74,14 +122,58 @@ bool RMDLBlender::doTheImportThing(const std::string& resourcesPath)
     return true;
 }
 
+static void compressClips(Blender& model, const animcompression::Settings& settings)
+{
+    for (auto& anim : model.animations)
+    {
+        if (!anim.compressed.empty())
+            continue;
+        
+        animcompression::Stats stats = animcompression::compress(anim, settings, anim.compressed);
+        printf("  %-20s %zu -> %zu keys  %.1fKB -> %.1fKB (x%.1f)  max err: pos %.5f rot %.5f rad scale %.5f\n",
+               anim.name.c_str(), stats.rawKeys, stats.keptKeys, stats.rawBytes / 1024.f, stats.compressedBytes / 1024.f,
+               stats.ratio(), stats.maxPositionError, stats.maxRotationError, stats.maxScaleError);
+        
+        for (auto& ch : anim.channels)
+        {
+            std::vector<KeyFrame<simd::float3>>().swap(ch.positions);
+            std::vector<KeyFrame<simd::quatf>>().swap(ch.rotations);
+            std::vector<KeyFrame<simd::float3>>().swap(ch.scales);
+        }
+    }
+}
+
 size_t RMDLBlender::loadModel(const std::string& resourcesPath, const std::string& name)
+{
+    Blender model;
+    model.name = name.empty() ? resourcesPath : name;
+    
+    if (!loadModelCache(resourcesPath, model))
+    {
+        // Un cache rejeté en cours de lecture a pu remplir une partie du modèle
+        model = Blender();
+        model.name = name.empty() ? resourcesPath : name;
+        importModel(resourcesPath, model);
+    }
+    
+    if (!model.indices.empty())
+        model.indexBuffer = m_device->newBuffer(model.indices.data(), model.indices.size() * sizeof(uint32_t), MTL::ResourceStorageModeShared);
+    
+    m_models.push_back(std::move(model));
+    return m_models.size() - 1;
+}
+
+void RMDLBlender::importModel(const std::string& resourcesPath, Blender& model)
 {
     Assimp::Importer importer;
     const aiScene* scene = importer.ReadFile(resourcesPath, aiProcess_Triangulate | aiProcess_FlipUVs | aiProcess_CalcTangentSpace | aiProcess_GenNormals | aiProcess_JoinIdenticalVertices | aiProcess_LimitBoneWeights | aiProcess_SortByPType | aiProcess_GenSmoothNormals);
+    if (!scene || !scene->mRootNode)
+    {
+        printf("Warning: cannot import '%s': %s\n", resourcesPath.c_str(), importer.GetErrorString());
+        return;
+    }
 
-    Blender model;
-    model.name = name.empty() ? resourcesPath : name;
-    model.rootNode = copyNodeHierarchy(scene->mRootNode);
+    flattenHierarchy(scene->mRootNode, -1, model.skeleton);
     
     bool hasBones = modelHasBones(scene->mRootNode, scene);
     
@@ -93,6 +185,9 @@ size_t RMDLBlender::loadModel(const std::string& resourcesPath, const std::strin
         model.uniformBuffer = m_device->newBuffer(sizeof(BlenderUniformsFull), MTL::ResourceStorageModeShared);
         loadAnimations(scene, model);
         
+        bindSkeleton(model);
+        preparePoses(model);
+        
         model.vertexBuffer = m_device->newBuffer(model.verticesFull.data(), model.verticesFull.size() * sizeof(VertexBlenderFull), MTL::ResourceStorageModeShared);
     }
     else
@@ -104,13 +199,206 @@ size_t RMDLBlender::loadModel(const std::string& resourcesPath, const std::strin
         model.vertexBuffer = m_device->newBuffer(model.vertices.data(), model.vertices.size() * sizeof(VertexBlender), MTL::ResourceStorageModeShared);
     }
     
-    std::string path = resourcesPath.substr(0, resourcesPath.find_last_of('/'));
     loadTextures(scene, model, resourcesPath);
+}
+
+// Les sections sont déjà dans la disposition des types runtime : copies en bloc, aucun parsing.
+// Le vertex buffer est créé directement depuis le fichier mappé, les clips compressés y restent.
+bool RMDLBlender::loadModelCache(const std::string& resourcesPath, Blender& model)
+{
+    using namespace modelcache;
+    
+    // Source et textures externes : taille et date suffisent, le contenu n'est relu que si la date a bougé
+    Reader reader;
+    if (!reader.open(cachePathFor(resourcesPath)))
+        return false;
+    std::string directory = directoryOf(resourcesPath);
+    std::vector<Dependency> dependencies = reader.dependencies();
+    if (dependencies.empty())
+        return false;
+    for (Dependency& dependency : dependencies)
+    {
+        dependency.path = directory + dependency.path;
+        if (!isUnchanged(dependency))
+            return false;
+    }
     
-    model.indexBuffer = m_device->newBuffer(model.indices.data(), model.indices.size() * sizeof(uint32_t), MTL::ResourceStorageModeShared);
+    Span<VertexBlenderFull> vertices = reader.section<VertexBlenderFull>(SectionType::Vertices);
+    Span<uint32_t> indices = reader.section<uint32_t>(SectionType::Indices);
+    Span<int32_t> parents = reader.section<int32_t>(SectionType::NodeParents);
+    Span<simd::float4x4> localBind = reader.section<simd::float4x4>(SectionType::NodeLocalBind);
+    Span<int32_t> nodeBones = reader.section<int32_t>(SectionType::NodeBones);
+    Span<NameRef> nodeNames = reader.section<NameRef>(SectionType::NodeNames);
+    Span<simd::float4x4> boneOffsets = reader.section<simd::float4x4>(SectionType::BoneOffsets);
+    Span<NameRef> boneNames = reader.section<NameRef>(SectionType::BoneNames);
+    Span<ClipRecord> clips = reader.section<ClipRecord>(SectionType::Clips);
+    Span<ChannelRecord> channels = reader.section<ChannelRecord>(SectionType::Channels);
+    Span<int32_t> nodeChannels = reader.section<int32_t>(SectionType::NodeChannels);
+    Span<KeyFrame<simd::float3>> positions = reader.section<KeyFrame<simd::float3>>(SectionType::PositionKeys);
+    Span<KeyFrame<simd::quatf>> rotations = reader.section<KeyFrame<simd::quatf>>(SectionType::RotationKeys);
+    Span<KeyFrame<simd::float3>> scales = reader.section<KeyFrame<simd::float3>>(SectionType::ScaleKeys);
+    Span<animcompression::CompressedChannel> compressedChannels = reader.section<animcompression::CompressedChannel>(SectionType::CompressedChannels);
+    Span<float> compressedTimes = reader.section<float>(SectionType::CompressedTimes);
+    Span<uint16_t> compressedValues = reader.section<uint16_t>(SectionType::CompressedValues);
+    Span<TextureRecord> textures = reader.section<TextureRecord>(SectionType::Textures);
+    Span<uint8_t> pixels = reader.section<uint8_t>(SectionType::Pixels);
     
-    m_models.push_back(std::move(model));
-    return m_models.size() - 1;
+    const size_t nodeCount = parents.count;
+    if (localBind.count != nodeCount || nodeBones.count != nodeCount || nodeNames.count != nodeCount ||
+        boneNames.count != boneOffsets.count || nodeChannels.count != clips.count * nodeCount ||
+        compressedChannels.count != channels.count || compressedValues.count != compressedTimes.count * 3)
+        return false;
+    
+    // Index croisés : computeBoneTransforms et computePalette les suivent sans vérifier.
+    // Un parent doit précéder son noeud (ordre préfixe), un bone exister ; négatif = aucun
+    for (size_t n = 0; n < nodeCount; n++)
+    {
+        if (parents[n] >= (int64_t)n || nodeBones[n] >= (int64_t)boneOffsets.count)
+            return false;
+    }
+    
+    Skeleton& skeleton = model.skeleton;
+    skeleton.parents.assign(parents.data, parents.data + nodeCount);
+    skeleton.localBind.assign(localBind.data, localBind.data + nodeCount);
+    skeleton.nodeBones.assign(nodeBones.data, nodeBones.data + nodeCount);
+    for (size_t n = 0; n < nodeCount; n++)
+        skeleton.names.push_back(reader.name(nodeNames[n]));
+    
+    model.boneCount = (int)boneOffsets.count;
+    model.boneOffsets.assign(boneOffsets.data, boneOffsets.data + boneOffsets.count);
+    for (size_t b = 0; b < boneOffsets.count; b++)
+        model.boneMap[reader.name(boneNames[b])] = { (int)b, boneOffsets[b] };
+    
+    for (size_t i = 0; i < clips.count; i++)
+    {
+        const ClipRecord& clip = clips[i];
+        if (!channels.contains(clip.firstChannel, clip.channelCount))
+            return false;
+        for (size_t n = 0; n < nodeCount; n++)
+        {
+            if (nodeChannels[i * nodeCount + n] >= (int64_t)clip.channelCount)
+                return false;
+        }
+        
+        Animation a;
+        a.name = reader.name(clip.name);
+        a.duration = clip.duration;
+        a.ticksPerSec = clip.ticksPerSec;
+        a.nodeChannels.assign(nodeChannels.data + i * nodeCount, nodeChannels.data + (i + 1) * nodeCount);
+        a.channels.resize(clip.channelCount);
+        
+        if (clip.compressed)
+        {
+            if (!compressedTimes.contains(clip.firstKey, clip.keyCount))
+                return false;
+            a.compressed.channels.view(compressedChannels.data + clip.firstChannel, clip.channelCount);
+            a.compressed.times.view(compressedTimes.data + clip.firstKey, clip.keyCount);
+            a.compressed.values.view(compressedValues.data + 3 * (size_t)clip.firstKey, 3 * (size_t)clip.keyCount);
+            model.cacheFile = reader.file();
+            for (const auto& cc : a.compressed.channels)
+            {
+                for (const auto* track : { &cc.position, &cc.rotation, &cc.scale })
+                    if ((uint64_t)track->firstKey + track->keyCount > clip.keyCount)
+                        return false;
+            }
+        }
+        
+        for (uint32_t c = 0; c < clip.channelCount; c++)
+        {
+            const ChannelRecord& rec = channels[clip.firstChannel + c];
+            if (!positions.contains(rec.firstPosition, rec.positionCount) ||
+                !rotations.contains(rec.firstRotation, rec.rotationCount) ||
+                !scales.contains(rec.firstScale, rec.scaleCount))
+                return false;
+            
+            BoneAnimation& ba = a.channels[c];
+            ba.boneName = reader.name(rec.boneName);
+            ba.positions.assign(positions.data + rec.firstPosition, positions.data + rec.firstPosition + rec.positionCount);
+            ba.rotations.assign(rotations.data + rec.firstRotation, rotations.data + rec.firstRotation + rec.rotationCount);
+            ba.scales.assign(scales.data + rec.firstScale, scales.data + rec.firstScale + rec.scaleCount);
+        }
+        model.animationMap[a.name] = i;
+        model.keyCursors.emplace_back(a.channels.size());
+        model.animations.push_back(std::move(a));
+    }
+    
+    model.verticesFull.assign(vertices.data, vertices.data + vertices.count);
+    model.indices.assign(indices.data, indices.data + indices.count);
+    model.hasAnimation = true;
+    model.boneMatrices.resize(model.boneCount, matrix_identity_float4x4);
+    preparePoses(model);
+    
+    model.uniformBuffer = m_device->newBuffer(sizeof(BlenderUniformsFull), MTL::ResourceStorageModeShared);
+    model.vertexBuffer = m_device->newBuffer(vertices.data, vertices.count * sizeof(VertexBlenderFull), MTL::ResourceStorageModeShared);
+    
+    MTL::Texture** slots[TextureSlotCount] = { &model.diffuseTexture, &model.normalTexture, &model.roughnessTexture, &model.metallicTexture, &model.ambientOcclusion };
+    for (size_t t = 0; t < textures.count; t++)
+    {
+        const TextureRecord& rec = textures[t];
+        if (rec.slot < TextureSlotCount && pixels.contains(rec.pixelOffset, (uint64_t)rec.width * rec.height * 4))
+            *slots[rec.slot] = newTextureRGBA8(pixels.data + rec.pixelOffset, rec.width, rec.height, rec.sRGB != 0);
+    }
+    return true;
+}
+
+bool RMDLBlender::bakeModelCache(const std::string& resourcesPath, bool compressAnimations)
+{
+    using namespace modelcache;
+    
+    // Relevés avant l'import : une source modifiée pendant le bake invalide le cache au lancement suivant
+    std::string directory = directoryOf(resourcesPath);
+    std::vector<Dependency> dependencies = { stampFile(resourcesPath) };
+    if (dependencies[0].hash == 0)
+    {
+        printf("Warning: cannot read '%s'\n", resourcesPath.c_str());
+        return false;
+    }
+    dependencies[0].path = resourcesPath.substr(directory.size());
+    
+    Blender model;
+    importModel(resourcesPath, model);
+    
+    if (!model.hasAnimation)
+    {
+        printf("Warning: '%s' is not a skinned model, no cache written\n", resourcesPath.c_str());
+        model.release();
+        return false;
+    }
+    
+    if (compressAnimations)
+        compressClips(model, animcompression::Settings{});
+    
+    for (const std::string& texture : model.textureFiles)
+    {
+        dependencies.push_back(stampFile(directory + texture));
+        dependencies.back().path = texture;
+    }
+    
+    // Relit les textures créées par l'import (RGBA8, stockage accessible CPU)
+    std::vector<TextureBlob> blobs;
+    const std::pair<TextureSlot, MTL::Texture*> slots[] = {
+        { TextureDiffuse, model.diffuseTexture }, { TextureNormal, model.normalTexture },
+        { TextureRoughness, model.roughnessTexture }, { TextureMetallic, model.metallicTexture },
+        { TextureAmbientOcclusion, model.ambientOcclusion } };
+    for (const auto& slot : slots)
+    {
+        if (!slot.second)
+            continue;
+        TextureBlob blob;
+        blob.slot = slot.first;
+        blob.width = (uint32_t)slot.second->width();
+        blob.height = (uint32_t)slot.second->height();
+        blob.sRGB = slot.second->pixelFormat() == MTL::PixelFormatRGBA8Unorm_sRGB;
+        blob.pixels.resize((size_t)blob.width * blob.height * 4);
+        slot.second->getBytes(blob.pixels.data(), blob.width * 4, MTL::Region::Make2D(0, 0, blob.width, blob.height), 0);
+        blobs.push_back(std::move(blob));
+    }
+    
+    std::string cachePath = cachePathFor(resourcesPath);
+    bool ok = write(cachePath, dependencies, model, blobs);
+    printf("%s '%s'\n", ok ? "Baked" : "Failed to write", cachePath.c_str());
+    model.release();
+    return ok;
 }
 
 Blender* RMDLBlender::getModel(size_t index)
@@ -125,15 +413,56 @@ Blender* RMDLBlender::getModel(const std::string& name)
     return nullptr;
 }
 
-NodeData RMDLBlender::copyNodeHierarchy(aiNode* node)
+void RMDLBlender::flattenHierarchy(aiNode* node, int32_t parent, Skeleton& skeleton)
 {
-    NodeData data;
-    data.name = node->mName.C_Str();
-    data.transform = aiToSimd(node->mTransformation);
-    data.children.reserve(node->mNumChildren);
+    int32_t index = (int32_t)skeleton.size();
+    skeleton.names.push_back(node->mName.C_Str());
+    skeleton.parents.push_back(parent);
+    skeleton.localBind.push_back(aiToSimd(node->mTransformation));
     for (unsigned i = 0; i < node->mNumChildren; i++)
-        data.children.push_back(copyNodeHierarchy(node->mChildren[i]));
-    return data;
+        flattenHierarchy(node->mChildren[i], index, skeleton);
+}
+
+// Résout une fois au chargement les correspondances par nom (noeud -> bone, noeud -> canal
+// de chaque clip) pour que l'évaluation par frame ne compare plus aucune string.
+void RMDLBlender::bindSkeleton(Blender& model)
+{
+    Skeleton& skeleton = model.skeleton;
+    skeleton.nodeBones.assign(skeleton.size(), -1);
+    for (auto& anim : model.animations)
+        anim.nodeChannels.assign(skeleton.size(), -1);
+    
+    for (uint32_t n = 0; n < skeleton.size(); n++)
+    {
+        auto it = model.boneMap.find(skeleton.names[n]);
+        if (it != model.boneMap.end())
+            skeleton.nodeBones[n] = it->second.id;
+        
+        for (auto& anim : model.animations)
+        {
+            for (size_t c = 0; c < anim.channels.size(); c++)
+            {
+                if (anim.channels[c].boneName == skeleton.names[n])
+                {
+                    anim.nodeChannels[n] = (int32_t)c;
+                    break;
+                }
+            }
+        }
+    }
+}
+
+// Buffers de travail de l'évaluation, aussi utilisé au chargement depuis le cache
+void RMDLBlender::preparePoses(Blender& model)
+{
+    Skeleton& skeleton = model.skeleton;
+    skeleton.globals.assign(skeleton.size(), matrix_identity_float4x4);
+    
+    model.bindPose.resize(skeleton.size());
+    model.pose.resize(skeleton.size());
+    model.layerPose.resize(skeleton.size());
+    for (uint32_t n = 0; n < skeleton.size(); n++)
+        decomposeTRS(skeleton.localBind[n], model.bindPose.translations[n], model.bindPose.rotations[n], model.bindPose.scales[n]);
 }
 
 bool RMDLBlender::modelHasBones(aiNode* pNode, const aiScene* pScene)
@@ -254,6 +583,7 @@ void RMDLBlender::loadBones(aiMesh* pMesh, Blender& model, uint32_t baseVertex)
         {
             boneID = model.boneCount++;
             model.boneMap[name] = {boneID, aiToSimd(pBone->mOffsetMatrix)};
+            model.boneOffsets.push_back(aiToSimd(pBone->mOffsetMatrix));
         }
         else
             boneID = it->second.id;
@@ -342,7 +672,7 @@ void RMDLBlender::createPipelineBlender(MTL::Library* shaderLibrary, MTL::PixelF
 
 void RMDLBlender::updateBlender(float deltaTim)
 {
-    deltaTime = 0.008f;
+    deltaTime = deltaTim;
 //    float bounce = sin(t * M_PI * 2.0f) * 0.5f;
 //    boneMatrix = simd::float4x4{ simd::make_float4(1, 0, 0, 0), simd::make_float4(0, 1, 0, 0), simd::make_float4(0, 0, 1, 0), simd::make_float4(0, bounce, 0, 1) };
     m_frame++;
@@ -357,40 +687,42 @@ void RMDLBlender::updateBlender(float deltaTim)
             for (auto& m : model.boneMatrices)
                 m = matrix_identity_float4x4;
             
+            // Copie dans des buffers déjà dimensionnés : pas d'allocation
+            model.pose = model.bindPose;
+            
             for (auto& layer : model.animationLayers)
             {
-                if (!layer.isPlaying)
-                    continue;
-                
                 Animation& anim = model.animations[layer.animationIndex];
-                layer.currentTime += deltaTime * anim.ticksPerSec * layer.speedMultiplier;
                 
-                if (layer.currentTime > anim.duration)
+                if (layer.isPlaying)
                 {
-                    if (layer.loop)
-                        layer.currentTime = fmod(layer.currentTime, anim.duration);
-                    else
+                    layer.currentTime += deltaTime * anim.ticksPerSec * layer.speedMultiplier;
+                    
+                    if (layer.currentTime > anim.duration)
                     {
-                        layer.currentTime = anim.duration;
-                        layer.isPlaying = false;
+                        if (layer.loop)
+                            layer.currentTime = fmod(layer.currentTime, anim.duration);
+                        else
+                        {
+                            layer.currentTime = anim.duration;
+                            layer.isPlaying = false;
+                        }
                     }
                 }
-
-                std::vector<simd::float4x4> layerBones(model.boneCount, matrix_identity_float4x4);
-                computeBoneTransforms(layer.currentTime, model.rootNode, math::makeIdentity(), model);
                 
-                // Blender avec le poids
-                if (layer.weight > 0.0f)
-                {
-                    for (size_t i = 0; i < model.boneCount; i++)
-                    {
-                        // Interpolation linéaire entre identity et la pose du layer
-                        // C'est simplifié, pour un vrai blend il faudrait décomposer en TRS
-                        model.boneMatrices[i] = model.boneMatrices[i] * (1.0f - layer.weight) +
-                                                 model.boneMatrices[i] * layer.weight;
-                    }
-                }
+                // Un layer arrêté garde sa dernière pose tant que son poids est non nul
+                if (layer.weight <= 0.0f)
+                    continue;
+                
+                samplePose(layer.currentTime, anim, layer.cursors, model.bindPose, model.layerPose);
+                const float* mask = layer.boneMask.empty() ? nullptr : layer.boneMask.data();
+                
+                if (layer.additive)
+                    addPose(model.pose, model.layerPose, model.bindPose, layer.weight, mask);
+                else
+                    blendPose(model.pose, model.layerPose, layer.weight, mask);
             }
+            applyPose(model.pose, model);
         }
         else
         {
@@ -402,64 +734,62 @@ void RMDLBlender::updateBlender(float deltaTim)
                 model.shouldAnimate = false;
             }
             
-            if (model.animController.isTransitioning)
-            {
-                model.animController.transitionTime += deltaTime;
-                float t = model.animController.transitionTime / model.animController.transitionDuration;
-                
-                if (t >= 1.0f)
-                {
-                    model.currentAnimation = model.animController.targetAnimation;
-                    model.currentTime = 0.0f;
-                    model.animController.isTransitioning = false;
-                }
-                else
-                {
-                    if (t > 0.5f)
-                    {
-                        model.currentAnimation = model.animController.targetAnimation;
-                        model.currentTime = 0.0f;
-                    }
-                }
-            }
-            
+            AnimationController& ctrl = model.animController;
             Animation& anim = model.animations[model.currentAnimation];
-            model.currentTime += deltaTime * anim.ticksPerSec * model.animController.speedMultiplier;
+            model.currentTime += deltaTime * anim.ticksPerSec * ctrl.speedMultiplier;
             
             if (model.currentTime > anim.duration)
             {
-                if (model.animController.loop)
+                if (ctrl.loop)
                     model.currentTime = fmod(model.currentTime, anim.duration);
                 else
                 {
                     model.currentTime = anim.duration;
-                    model.animController.isPlaying = false;
+                    ctrl.isPlaying = false;
                 }
             }
             
+            // Bind pose par défaut pour les bones hors hiérarchie
             for (size_t i = 0; i < model.boneMatrices.size(); i++)
+                model.boneMatrices[i] = model.boneOffsets[i];
+            
+            if (ctrl.isTransitioning)
             {
-                // Trouver la bind pose pour ce bone
-                bool foundBone = false;
-                for (const auto& bonePair : model.boneMap)
+                Animation& target = model.animations[ctrl.targetAnimation];
+                ctrl.transitionTime += deltaTime;
+                ctrl.targetTime += deltaTime * target.ticksPerSec * ctrl.speedMultiplier;
+                if (ctrl.targetTime > target.duration)
+                    ctrl.targetTime = ctrl.loop ? fmod(ctrl.targetTime, target.duration) : target.duration;
+                
+                float t = ctrl.transitionDuration > 0.0f ? ctrl.transitionTime / ctrl.transitionDuration : 1.0f;
+                
+                if (t >= 1.0f)
                 {
-                    if (bonePair.second.id == i)
-                    {
-                        // La bind pose est l'inverse de l'offset
-                        model.boneMatrices[i] = bonePair.second.offset;
-                        foundBone = true;
-                        break;
-                    }
+                    model.currentAnimation = ctrl.targetAnimation;
+                    model.currentTime = ctrl.targetTime;
+                    ctrl.isTransitioning = false;
+                }
+                else
+                {
+                    // Crossfade lissé entre la pose courante et la cible
+                    float w = t * t * (3.0f - 2.0f * t);
+                    samplePose(model.currentTime, anim, model.keyCursors[model.currentAnimation], model.bindPose, model.pose);
+                    samplePose(ctrl.targetTime, target, model.keyCursors[ctrl.targetAnimation], model.bindPose, model.layerPose);
+                    blendPose(model.pose, model.layerPose, w, nullptr);
+                    applyPose(model.pose, model);
+                    continue;
                 }
-                if (!foundBone)
-                    model.boneMatrices[i] = matrix_identity_float4x4;
             }
-//            for (auto& m : model.boneMatrices)
-//                m = math::makeIdentity();
             
-            computeBoneTransforms(model.currentTime, model.rootNode, math::makeIdentity(), model);
+            computeBoneTransforms(model.currentTime, model);
         }
     }
+    
+    for (auto& model : m_models)
+    {
+        if (model.cpuSkinning)
+            model.skinnedBounds = skinning::skin(model.skinStream, model.boneMatrices.data(), model.skinnedPositions.data(), model.skinnedNormals.data());
+    }
 }
 
 MTL::Texture* RMDLBlender::loadEmbeddedTexture(aiTexture *aiTexture, bool sRGB)
@@ -474,6 +804,29 @@ MTL::Texture* RMDLBlender::loadEmbeddedTexture(aiTexture *aiTexture, bool sRGB)
         data = reinterpret_cast<unsigned char*>(aiTexture->pcData);
     }
 
+    MTL::Texture* texture = newTextureRGBA8(data, width, height, sRGB);
+
+    if (aiTexture->mHeight == 0)
+        stbi_image_free(data);
+    return texture;
+}
+
+MTL::Texture* RMDLBlender::loadExternalTexture(const std::string& path, bool sRGB)
+{
+    int width, height, channels;
+    unsigned char* data = stbi_load(path.c_str(), &width, &height, &channels, 4);
+    if (!data)
+    {
+        printf("Warning: cannot load texture '%s'\n", path.c_str());
+        return nullptr;
+    }
+    MTL::Texture* texture = newTextureRGBA8(data, width, height, sRGB);
+    stbi_image_free(data);
+    return texture;
+}
+
+MTL::Texture* RMDLBlender::newTextureRGBA8(const void* pixels, uint32_t width, uint32_t height, bool sRGB)
+{
     NS::SharedPtr<MTL::TextureDescriptor> textureDescriptor = NS::TransferPtr(MTL::TextureDescriptor::alloc()->init());
     textureDescriptor->setPixelFormat(sRGB ? MTL::PixelFormatRGBA8Unorm_sRGB : MTL::PixelFormatRGBA8Unorm);
     textureDescriptor->setWidth(width);
@@ -482,10 +835,7 @@ MTL::Texture* RMDLBlender::loadEmbeddedTexture(aiTexture *aiTexture, bool sRGB)
 
     MTL::Texture* texture = m_device->newTexture(textureDescriptor.get());
     MTL::Region region = MTL::Region::Make2D(0, 0, width, height);
-    texture->replaceRegion(region, 0, data, width * 4);
-
-    if (aiTexture->mHeight == 0)
-        stbi_image_free(data);
+    texture->replaceRegion(region, 0, pixels, width * 4);
     return texture;
 }
 
@@ -503,8 +853,12 @@ void RMDLBlender::loadTextures(const aiScene* scene, Blender& model, const std::
             int idx = atoi(path.data + 1);
             if (idx < (int)scene->mNumTextures)
                 return loadEmbeddedTexture(scene->mTextures[idx], sRGB);
+            return nullptr;
         }
-        return nullptr; // External texture loading omitted for brevity
+        // Externe : relative au dossier de la source, et clé du cache même si elle manque
+        if (std::find(model.textureFiles.begin(), model.textureFiles.end(), path.C_Str()) == model.textureFiles.end())
+            model.textureFiles.push_back(path.C_Str());
+        return loadExternalTexture(modelcache::directoryOf(resourcesPath) + path.C_Str(), sRGB);
     };
     
     model.diffuseTexture = loadTex(aiTextureType_DIFFUSE, true);
@@ -543,7 +897,7 @@ MTL::Texture* RMDLBlender::loadTexture(const std::string& resourcesPath, const c
     return texture;
 }
 
-void RMDLBlender::addAnimationLayer(size_t modelIndex, const std::string& animName, float weight)
+void RMDLBlender::addAnimationLayer(size_t modelIndex, const std::string& animName, float weight, bool additive)
 {
     if (modelIndex >= m_models.size())
         return;
@@ -562,6 +916,8 @@ void RMDLBlender::addAnimationLayer(size_t modelIndex, const std::string& animNa
     layer.currentTime = 0.0f;
     layer.isPlaying = true;
     layer.loop = true;
+    layer.additive = additive;
+    layer.cursors.resize(model.animations[layer.animationIndex].channels.size());
     
     model.animationLayers.push_back(layer);
     model.useLayeredAnimation = true;
@@ -569,6 +925,40 @@ void RMDLBlender::addAnimationLayer(size_t modelIndex, const std::string& animNa
     printf("Added layer: '%s' (weight: %.2f)\n", animName.c_str(), weight);
 }
 
+void RMDLBlender::setLayerBoneMask(size_t modelIndex, size_t layerIndex, const std::string& boneName, float weight, bool includeChildren)
+{
+    if (modelIndex >= m_models.size() || layerIndex >= m_models[modelIndex].animationLayers.size())
+        return;
+    
+    Blender& model = m_models[modelIndex];
+    const Skeleton& skeleton = model.skeleton;
+    AnimationLayer& layer = model.animationLayers[layerIndex];
+    
+    auto it = std::find(skeleton.names.begin(), skeleton.names.end(), boneName);
+    if (it == skeleton.names.end())
+    {
+        printf("Warning: Bone '%s' not found\n", boneName.c_str());
+        return;
+    }
+    
+    maskSubtree(skeleton, (int32_t)(it - skeleton.names.begin()), weight, includeChildren, layer.boneMask);
+}
+
+// Les descendants d'un noeud sont contigus juste après lui (ordre préfixe) : le sous-arbre
+// s'arrête au premier noeud dont le parent précède root.
+void RMDLBlender::maskSubtree(const Skeleton& skeleton, int32_t root, float weight, bool includeChildren, std::vector<float>& mask)
+{
+    if (mask.empty())
+        mask.assign(skeleton.size(), 1.0f);
+    
+    mask[root] = weight;
+    
+    if (!includeChildren)
+        return;
+    for (uint32_t n = root + 1; n < skeleton.size() && skeleton.parents[n] >= root; n++)
+        mask[n] = weight;
+}
+
 void RMDLBlender::clearAnimationLayers(size_t modelIndex)
 {
     if (modelIndex >= m_models.size())
@@ -615,10 +1005,20 @@ void RMDLBlender::loadAnimations(const aiScene *scene, Blender& model)
             a.channels.push_back(ba);
         }
         model.animationMap[a.name] = i;
+        model.keyCursors.emplace_back(a.channels.size());
         model.animations.push_back(a);
     }
 }
 
+void RMDLBlender::compressAnimations(size_t modelIndex, const animcompression::Settings& settings)
+{
+    if (modelIndex >= m_models.size())
+        return;
+    
+    printf("Compressing animations of '%s'\n", m_models[modelIndex].name.c_str());
+    compressClips(m_models[modelIndex], settings);
+}
+
 void RMDLBlender::createSampler()
 {
     NS::SharedPtr<MTL::SamplerDescriptor> samplerDesc = NS::TransferPtr(MTL::SamplerDescriptor::alloc()->init());
@@ -631,42 +1031,116 @@ void RMDLBlender::createSampler()
     _pSampler = m_device->newSamplerState(samplerDesc.get());
 }
 
-void RMDLBlender::computeBoneTransforms(float time, const NodeData& node, const simd::float4x4& parentTf, Blender& model)
+void RMDLBlender::computeBoneTransforms(float time, Blender& model)
 {
-    simd::float4x4 localTf = node.transform;
-    bool wasAnimated = false;
+    Skeleton& skeleton = model.skeleton;
+    const Animation& anim = model.animations[model.currentAnimation];
+    std::vector<KeyCursor>& cursors = model.keyCursors[model.currentAnimation];
+    
+    for (uint32_t n = 0; n < skeleton.size(); n++)
+    {
+        simd::float4x4 localTf = skeleton.localBind[n];
+        int32_t c = anim.nodeChannels[n];
+        
+        if (c >= 0)
+        {
+            simd::float3 translation, scale;
+            simd::quatf rotation;
+            sampleChannel(time, anim, c, cursors[c], translation, rotation, scale);
+            localTf = makeTRS(translation, rotation, scale);
+        }
+        
+        int32_t parent = skeleton.parents[n];
+        skeleton.globals[n] = parent >= 0 ? skeleton.globals[parent] * localTf : localTf;
+        
+        int32_t boneId = skeleton.nodeBones[n];
+        if (boneId >= 0)
+            model.boneMatrices[boneId] = skeleton.globals[n] * model.boneOffsets[boneId];
+    }
+}
 
-    if (!model.animations.empty())
+void RMDLBlender::samplePose(float time, const Animation& anim, std::vector<KeyCursor>& cursors, const LocalPose& bindPose, LocalPose& out)
+{
+    for (size_t n = 0; n < anim.nodeChannels.size(); n++)
     {
-        Animation& anim = model.animations[model.currentAnimation];
+        int32_t c = anim.nodeChannels[n];
         
-        for (auto& ch : anim.channels)
+        if (c >= 0)
+            sampleChannel(time, anim, c, cursors[c], out.translations[n], out.rotations[n], out.scales[n]);
+        else
         {
-            if (ch.boneName == node.name)
-            {
-                localTf = makeTRS(interpolatePosition(time, ch), interpolateRotation(time, ch), interpolateScale(time, ch));
-                wasAnimated = true;
-                break;
-            }
+            out.translations[n] = bindPose.translations[n];
+            out.rotations[n] = bindPose.rotations[n];
+            out.scales[n] = bindPose.scales[n];
         }
     }
-    simd::float4x4 globalTf = parentTf * localTf;
+}
+
+void RMDLBlender::applyPose(const LocalPose& pose, Blender& model)
+{
+    computePalette(model, pose, model.skeleton.globals.data(), model.boneMatrices.data());
+}
+
+void RMDLBlender::computePalette(const Blender& rig, const LocalPose& pose, simd::float4x4* globals, simd::float4x4* palette)
+{
+    const Skeleton& skeleton = rig.skeleton;
+    
+    for (uint32_t n = 0; n < skeleton.size(); n++)
+    {
+        simd::float4x4 localTf = makeTRS(pose.translations[n], pose.rotations[n], pose.scales[n]);
+        int32_t parent = skeleton.parents[n];
+        globals[n] = parent >= 0 ? globals[parent] * localTf : localTf;
+        
+        int32_t boneId = skeleton.nodeBones[n];
+        if (boneId >= 0)
+            palette[boneId] = globals[n] * rig.boneOffsets[boneId];
+    }
+}
+
+template<typename Decode, typename Interpolate>
+static auto sampleQuantizedTrack(const animcompression::CompressedAnimation& clip, const animcompression::QuantizedTrack& track,
+                                 float time, uint32_t& cursor, Decode decode, Interpolate interpolate)
+{
+    const float* times = clip.times.data() + track.firstKey;
+    const uint16_t* values = clip.values.data() + 3 * (size_t)track.firstKey;
+    if (track.keyCount == 1)
+        return decode(values);
+    
+    uint32_t i = findKeyIndex(track.keyCount, [times](uint32_t k) { return times[k]; }, time, cursor);
+    uint32_t j = (i + 1) % track.keyCount;
+    
+    float dt = times[j] - times[i];
+    float t = (dt > 0) ? (time - times[i]) / dt : 0;
+    return interpolate(decode(values + 3 * i), decode(values + 3 * j), t);
+}
 
-    auto it = model.boneMap.find(node.name);
+void RMDLBlender::sampleChannel(float time, const Animation& anim, size_t channel, KeyCursor& cursor, simd::float3& translation, simd::quatf& rotation, simd::float3& scale)
+{
+    if (anim.compressed.empty())
+    {
+        const BoneAnimation& ch = anim.channels[channel];
+        translation = interpolatePosition(time, ch, cursor.position);
+        rotation = interpolateRotation(time, ch, cursor.rotation);
+        scale = interpolateScale(time, ch, cursor.scale);
+        return;
+    }
     
-    if (it != model.boneMap.end())
-        model.boneMatrices[it->second.id] = globalTf * it->second.offset;
+    const animcompression::CompressedChannel& cc = anim.compressed.channels[channel];
+    auto mixVec3 = [](simd::float3 a, simd::float3 b, float t) { return simd_mix(a, b, t); };
+    auto slerpQuat = [](simd::quatf a, simd::quatf b, float t) { return simd::slerp(a, b, t); };
     
-    for (const auto& child : node.children)
-        computeBoneTransforms(time, child, globalTf, model);
+    translation = sampleQuantizedTrack(anim.compressed, cc.position, time, cursor.position,
+                                       [&cc](const uint16_t* q) { return animcompression::decodeVec3(q, cc.position); }, mixVec3);
+    rotation = sampleQuantizedTrack(anim.compressed, cc.rotation, time, cursor.rotation, animcompression::decodeRotation, slerpQuat);
+    scale = sampleQuantizedTrack(anim.compressed, cc.scale, time, cursor.scale,
+                                 [&cc](const uint16_t* q) { return animcompression::decodeVec3(q, cc.scale); }, mixVec3);
 }
 
-simd::float3 RMDLBlender::interpolatePosition(float time, const BoneAnimation& anim)
+simd::float3 RMDLBlender::interpolatePosition(float time, const BoneAnimation& anim, uint32_t& cursor)
 {
     if (anim.positions.size() == 1) return anim.positions[0].value;
     
-    size_t i = 0;
-    while (i < anim.positions.size() - 1 && anim.positions[i + 1].time < time) i++;
+    size_t i = findKeyIndex(anim.positions, time, cursor);
     size_t j = (i + 1) % anim.positions.size();
     
     float dt = anim.positions[j].time - anim.positions[i].time;
@@ -674,12 +1148,11 @@ simd::float3 RMDLBlender::interpolatePosition(float time, const BoneAnimation& a
     return simd_mix(anim.positions[i].value, anim.positions[j].value, t);
 }
 
-simd::quatf RMDLBlender::interpolateRotation(float time, const BoneAnimation& anim)
+simd::quatf RMDLBlender::interpolateRotation(float time, const BoneAnimation& anim, uint32_t& cursor)
 {
     if (anim.rotations.size() == 1) return anim.rotations[0].value;
     
-    size_t i = 0;
-    while (i < anim.rotations.size() - 1 && anim.rotations[i + 1].time < time) i++;
+    size_t i = findKeyIndex(anim.rotations, time, cursor);
     size_t j = (i + 1) % anim.rotations.size();
     
     float dt = anim.rotations[j].time - anim.rotations[i].time;
@@ -687,12 +1160,11 @@ simd::quatf RMDLBlender::interpolateRotation(float time, const BoneAnimation& an
     return simd::slerp(anim.rotations[i].value, anim.rotations[j].value, t);
 }
 
-simd::float3 RMDLBlender::interpolateScale(float time, const BoneAnimation& anim)
+simd::float3 RMDLBlender::interpolateScale(float time, const BoneAnimation& anim, uint32_t& cursor)
 {
     if (anim.scales.size() == 1) return anim.scales[0].value;
     
-    size_t i = 0;
-    while (i < anim.scales.size() - 1 && anim.scales[i + 1].time < time) i++;
+    size_t i = findKeyIndex(anim.scales, time, cursor);
     size_t j = (i + 1) % anim.scales.size();
     
     float dt = anim.scales[j].time - anim.scales[i].time;
@@ -839,6 +1311,7 @@ void RMDLBlender::transitionToAnimation(size_t modelIndex, const std::string& an
     model.animController.targetAnimation = targetIndex;
     model.animController.transitionDuration = duration;
     model.animController.transitionTime = 0.0f;
+    model.animController.targetTime = 0.0f;
 }
 
 void RMDLBlender::stopAnimation(size_t modelIndex)
@@ -857,16 +1330,49 @@ void RMDLBlender::setAnimationSpeed(size_t modelIndex, float speed)
     m_models[modelIndex].animController.speedMultiplier = speed;
 }
 
-void RMDLBlender::draw(MTL::RenderCommandEncoder* pEncoder, const simd::float4x4& viewProj, const RMDLUniforms &uniforms)
+void RMDLBlender::setCPUSkinning(size_t modelIndex, bool enabled)
 {
+    if (modelIndex >= m_models.size())
+        return;
+    
+    Blender& model = m_models[modelIndex];
+    model.cpuSkinning = enabled && model.hasAnimation;
+    if (!model.cpuSkinning)
+    {
+        model.skinStream = {};
+        model.skinnedPositions = {};
+        model.skinnedNormals = {};
+        model.skinnedBounds = {};
+        return;
+    }
+    
+    skinning::prepare(model.verticesFull.data(), model.verticesFull.size(), (uint32_t)model.boneMatrices.size(), model.skinStream);
+    model.skinnedPositions.resize(model.skinStream.size());
+    model.skinnedNormals.resize(model.skinStream.size());
+    model.skinnedBounds = skinning::skin(model.skinStream, model.boneMatrices.data(), model.skinnedPositions.data(), model.skinnedNormals.data());
+}
+
+void RMDLBlender::draw(MTL::RenderCommandEncoder* pEncoder, const simd::float4x4& viewProj, const Frustum& frustum, const RMDLUniforms &uniforms)
+{
+    // Seuls les modèles skinnés sur CPU ont une boîte à jour ; les autres sont toujours dessinés
     for (size_t i = 0; i < m_models.size(); i++)
-        drawBlender(pEncoder, i, viewProj, m_models[i].transform, uniforms);
+    {
+        const Blender& model = m_models[i];
+        if (model.cpuSkinning && !model.skinnedBounds.empty())
+        {
+            skinning::Bounds world = skinning::transformBounds(model.skinnedBounds, model.transform);
+            if (!culling::isBoxVisible(frustum, world.min, world.max))
+                continue;
+        }
+        drawBlender(pEncoder, i, viewProj, model.transform, uniforms);
+    }
 }
 
 void RMDLBlender::drawBlender(MTL::RenderCommandEncoder *pEncoder, size_t index, const simd::float4x4 &viewProjectionMatrix, const simd::float4x4 &modelMatrix, const RMDLUniforms &uniforms)
 {
     if (index >= m_models.size()) return;
     Blender& model = m_models[index];
+    if (!model.indexBuffer) return;     // import échoué
     
     if (model.hasAnimation)
     {
@@ -22,6 +22,8 @@
 #include <map>
 #include <unordered_map>
 #include <queue>
+#include <algorithm>
+#include <memory>
 
 #include "stdio.h"
 
@@ -29,6 +31,10 @@
 #include "RMDLMathUtils.hpp"
 
 #include "RMDLMainRenderer_shared.h"
+#include "RMDLAnimationCompression.hpp"
+#include "RMDLSkinning.hpp"
+
+namespace modelcache { class MappedFile; }
 
 enum class AnimationState
 {
@@ -83,6 +89,15 @@ struct KeyFrame
     T value;
 };
 
+// Dernière clé échantillonnée par piste : la lecture avance de façon monotone,
+// on repart donc du curseur au lieu de rebalayer depuis la clé 0.
+struct KeyCursor
+{
+    uint32_t position = 0;
+    uint32_t rotation = 0;
+    uint32_t scale = 0;
+};
+
 struct BoneAnimation
 {
     std::string boneName; // Bone -> Bone.026
@@ -91,12 +106,61 @@ struct BoneAnimation
     std::vector<KeyFrame<simd::float3>> scales;
 };
 
+// Renvoie la clé i telle que keys[i].time < time <= keys[i + 1].time (même résultat que
+// l'ancien balayage linéaire). En lecture normale le temps avance de quelques clés au plus
+// par frame : on avance depuis le curseur. Sur un retour en arrière (boucle, seek) ou un
+// grand saut, on retombe sur une recherche binaire.
+// timeAt(k) donne le temps de la clé k : le même parcours sert aux pistes brutes et compressées.
+template<typename TimeAt>
+inline uint32_t findKeyIndex(uint32_t count, const TimeAt& timeAt, float time, uint32_t& cursor)
+{
+    constexpr uint32_t MAX_FORWARD_STEPS = 4;
+    const uint32_t last = count - 1;
+    uint32_t i = cursor;
+    
+    if (i <= last && (i == 0 || timeAt(i) < time))
+    {
+        uint32_t steps = 0;
+        while (i < last && timeAt(i + 1) < time && steps < MAX_FORWARD_STEPS)
+        {
+            i++;
+            steps++;
+        }
+        if (i == last || timeAt(i + 1) >= time)
+        {
+            cursor = i;
+            return i;
+        }
+    }
+    
+    // Première clé de [1, count) dont le temps est >= time
+    uint32_t lo = 1, hi = count;
+    while (lo < hi)
+    {
+        uint32_t mid = (lo + hi) / 2;
+        if (timeAt(mid) < time)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    cursor = lo - 1;
+    return cursor;
+}
+
+template<typename T>
+inline uint32_t findKeyIndex(const std::vector<KeyFrame<T>>& keys, float time, uint32_t& cursor)
+{
+    return findKeyIndex((uint32_t)keys.size(), [&keys](uint32_t k) { return keys[k].time; }, time, cursor);
+}
+
 struct Animation
 {
     std::string name;
     float duration;
     float ticksPerSec;
     std::vector<BoneAnimation> channels;
+    std::vector<int32_t> nodeChannels; // index de noeud -> canal, -1 si non animé
+    animcompression::CompressedAnimation compressed; // si non vide, remplace les clés des channels
 };
 
 struct AnimationLayer
@@ -106,7 +170,10 @@ struct AnimationLayer
     float currentTime = 0.0f;
     bool isPlaying = false;
     bool loop = true;
+    bool additive = false;              // ajoute l'écart à la bind pose au lieu de remplacer
     float speedMultiplier = 1.0f;
+    std::vector<float> boneMask;        // poids par noeud du Skeleton, vide = tous à 1
+    std::vector<KeyCursor> cursors;     // [channel], propres au layer
 };
 
 struct AnimationController
@@ -116,15 +183,38 @@ struct AnimationController
     bool loop = true;
     bool isTransitioning = false;
     size_t targetAnimation = 0;
+    float targetTime = 0.0f;
     float transitionDuration = 0.3f;
     float transitionTime = 0.0f;
 };
 
-struct NodeData
+// Hiérarchie de noeuds aplatie en tableaux parallèles, en ordre préfixe : un parent précède
+// toujours ses enfants, les transforms globales se calculent donc en une passe linéaire.
+struct Skeleton
 {
-    std::string name;
-    simd::float4x4 transform;
-    std::vector<NodeData> children;
+    std::vector<std::string>    names;      // uniquement pour résoudre les bindings au chargement
+    std::vector<int32_t>        parents;    // -1 pour la racine
+    std::vector<simd::float4x4> localBind;
+    std::vector<int32_t>        nodeBones;  // index de noeud -> bone id, -1 si aucun
+    std::vector<simd::float4x4> globals;    // scratch, réécrit à chaque évaluation
+    
+    uint32_t size() const { return (uint32_t)parents.size(); }
+};
+
+// Pose locale décomposée par noeud du Skeleton, pour pouvoir mélanger des clips
+// (lerp / slerp) avant de recomposer les matrices.
+struct LocalPose
+{
+    std::vector<simd::float3> translations;
+    std::vector<simd::quatf>  rotations;
+    std::vector<simd::float3> scales;
+    
+    void resize(uint32_t count)
+    {
+        translations.resize(count);
+        rotations.resize(count);
+        scales.resize(count);
+    }
 };
 
 struct Blender
@@ -141,14 +231,24 @@ struct Blender
     bool hasAnimation = false;
     bool shouldAnimate = true;
     std::unordered_map<std::string, BoneInfo> boneMap;
+    std::vector<simd::float4x4> boneOffsets;   // [bone id]
     std::vector<simd::float4x4> boneMatrices;
     std::vector<Animation> animations;
     std::unordered_map<std::string, size_t> animationMap;
+    std::vector<std::vector<KeyCursor>> keyCursors; // [animation][channel]
     AnimationController animController;
     std::vector<AnimationLayer> animationLayers;
     bool useLayeredAnimation = false;
-    NodeData rootNode;
+    Skeleton skeleton;
+    LocalPose bindPose;     // localBind décomposé, référence des layers additifs
+    LocalPose pose;         // buffers de travail dimensionnés au chargement :
+    LocalPose layerPose;    // aucune allocation par frame pendant les blends
     int boneCount = 0;
+    bool cpuSkinning = false;
+    skinning::SkinStream skinStream;                // préparé par setCPUSkinning
+    std::vector<simd::float4> skinnedPositions;     // mis à jour à chaque updateBlender
+    std::vector<simd::float4> skinnedNormals;
+    skinning::Bounds skinnedBounds;                 // espace modèle, pour le culling
     size_t currentAnimation = 0;
     float currentTime = 0.0f;
     MTL::Buffer* uniformBuffer = nullptr;
@@ -158,6 +258,8 @@ struct Blender
     MTL::Texture* roughnessTexture = nullptr;
     MTL::Texture* metallicTexture = nullptr;
     MTL::Texture* ambientOcclusion = nullptr;
+    std::vector<std::string> textureFiles;  // textures externes, relatives au dossier de la source
+    std::shared_ptr<const modelcache::MappedFile> cacheFile;   // clips compressés vus en place dans le cache
     
     simd::float4x4 transform = matrix_identity_float4x4;
     simd::float3 position = {};
@@ -187,6 +289,7 @@ struct Blender
         if (normalTexture) normalTexture->release();
         if (roughnessTexture) roughnessTexture->release();
         if (metallicTexture) metallicTexture->release();
+        if (ambientOcclusion) ambientOcclusion->release();
     }
 };
 
@@ -194,10 +297,16 @@ class RMDLBlender
 {
 public:
     RMDLBlender(MTL::Device* device, MTL::PixelFormat pixelFormat, MTL::PixelFormat depthPixelFormat, const std::string& resourcesPath, MTL::Library* shaderLibrary);
+    // Sans pipelines ni rendu : pour les outils hors-ligne (bake du cache)
+    explicit RMDLBlender(MTL::Device* device);
     ~RMDLBlender();
 
     bool doTheImportThing(const std::string& resourcesPath);
     size_t loadModel(const std::string& resourcesPath, const std::string& name = "");
+    // Importe la source via assimp et écrit <source>.rmdlcache (modèles skinnés uniquement)
+    bool bakeModelCache(const std::string& resourcesPath, bool compressAnimations = false);
+    // Compresse les clips du modèle, libère les clés brutes et affiche ratio / erreur max par clip
+    void compressAnimations(size_t modelIndex, const animcompression::Settings& settings = {});
     
     void printMemoryStats() const;
     void printAnimations(size_t modelIndex) const;
@@ -207,7 +316,8 @@ public:
     Blender* getModel(const std::string& name);
     size_t getModelCount() const { return m_models.size(); }
     
-    void addAnimationLayer(size_t modelIndex, const std::string& animName, float weight);
+    void addAnimationLayer(size_t modelIndex, const std::string& animName, float weight, bool additive = false);
+    void setLayerBoneMask(size_t modelIndex, size_t layerIndex, const std::string& boneName, float weight, bool includeChildren = true);
     void clearAnimationLayers(size_t modelIndex);
     
     void playAnimation(size_t modelIndex, const std::string& animName, bool loop = true);
@@ -215,18 +325,39 @@ public:
     void transitionToAnimation(size_t modelIndex, const std::string& animName, float duration = 0.3f);
     void stopAnimation(size_t modelIndex);
     void setAnimationSpeed(size_t modelIndex, float speed);
+    // Skinning CPU à chaque frame : positions / normales skinnées et boîte pour le culling
+    void setCPUSkinning(size_t modelIndex, bool enabled);
         
     void createPipelineBlender(MTL::Library* shaderLibrary, MTL::PixelFormat pixelFormat, MTL::PixelFormat depthPixelFormat);
     void updateBlender(float deltaTime);
-    void draw(MTL::RenderCommandEncoder* encoder, const simd::float4x4& viewProj, const RMDLUniforms &uniforms);
+    void draw(MTL::RenderCommandEncoder* encoder, const simd::float4x4& viewProj, const Frustum& frustum, const RMDLUniforms &uniforms);
     void drawBlender(MTL::RenderCommandEncoder* pEncoder, size_t index, const simd::float4x4& viewProjectionMatrix, const simd::float4x4& model, const RMDLUniforms &uniforms);
     
+    // Évaluation sans état partagé : ne lit que le rig, n'écrit que dans les buffers passés,
+    // donc appelable en parallèle sur plusieurs instances d'un même Blender
+    static void sampleChannel(float time, const Animation& anim, size_t channel, KeyCursor& cursor, simd::float3& translation, simd::quatf& rotation, simd::float3& scale);
+    static void samplePose(float time, const Animation& anim, std::vector<KeyCursor>& cursors, const LocalPose& bindPose, LocalPose& out);
+    static void blendPose(LocalPose& dst, const LocalPose& src, float weight, const float* mask);
+    static void addPose(LocalPose& dst, const LocalPose& src, const LocalPose& reference, float weight, const float* mask);
+    // Poids weight sur root (et ses descendants si includeChildren) ; mask vide = tous à 1 d'abord
+    static void maskSubtree(const Skeleton& skeleton, int32_t root, float weight, bool includeChildren, std::vector<float>& mask);
+    // globals : scratch de skeleton.size() matrices ; palette : boneCount matrices
+    static void computePalette(const Blender& rig, const LocalPose& pose, simd::float4x4* globals, simd::float4x4* palette);
+    // Clip courant du modèle sans blend, en une passe sur le Skeleton : écrit model.boneMatrices
+    static void computeBoneTransforms(float time, Blender& model);
+    
+    // Construction du rig au chargement, sans device : skeleton en ordre préfixe, puis tables
+    // noeud -> bone / canal résolues par nom, puis bind pose décomposée et buffers de travail
+    static void flattenHierarchy(aiNode* node, int32_t parent, Skeleton& skeleton);
+    static void bindSkeleton(Blender& model);
+    static void preparePoses(Blender& model);
+    
 private:
     MTL::Device*                m_device;
     MTL::SamplerState*          _pSampler = nullptr;
-    MTL::DepthStencilState*     _pDepthState;
-    MTL::RenderPipelineState*   _pPipelineStateBlender;
-    MTL::RenderPipelineState*   _pPipelineStateBlenderFull;
+    MTL::DepthStencilState*     _pDepthState = nullptr;
+    MTL::RenderPipelineState*   _pPipelineStateBlender = nullptr;
+    MTL::RenderPipelineState*   _pPipelineStateBlenderFull = nullptr;
     float                       _pCurrentTime;
     float                       _pAnimationDuration;
     
@@ -245,14 +376,16 @@ private:
     float deltaTime = 0.f;
     
     std::vector<Blender> m_models;
-    
-    
-    NodeData _rootNode;
 
     bool modelHasBones(aiNode* node, const aiScene* scene);
     void loadMesh(const aiScene* scene);
     MTL::Texture* loadTexture(const std::string& resourcesPath, const char* path, const aiScene* scene, bool sRGB);
     MTL::Texture* loadEmbeddedTexture(aiTexture* aiTexture, bool sRGB);
+    MTL::Texture* loadExternalTexture(const std::string& path, bool sRGB);
+    MTL::Texture* newTextureRGBA8(const void* pixels, uint32_t width, uint32_t height, bool sRGB);
+    
+    void importModel(const std::string& resourcesPath, Blender& model);
+    bool loadModelCache(const std::string& resourcesPath, Blender& model);
 
     void createSampler();
     
@@ -264,11 +397,10 @@ private:
     void loadAnimations(const aiScene* scene, Blender& model);
     void loadTextures(const aiScene* scene, Blender& model, const std::string& resourcesPath);
     
-    NodeData copyNodeHierarchy(aiNode* node);
-    void computeBoneTransforms(float time, const NodeData& node, const simd::float4x4& parentTf, Blender& model);
-    simd::float3 interpolatePosition(float time, const BoneAnimation& anim);
-    simd::quatf interpolateRotation(float time, const BoneAnimation& anim);
-    simd::float3 interpolateScale(float time, const BoneAnimation& anim);
+    void applyPose(const LocalPose& pose, Blender& model);
+    static simd::float3 interpolatePosition(float time, const BoneAnimation& anim, uint32_t& cursor);
+    static simd::quatf interpolateRotation(float time, const BoneAnimation& anim, uint32_t& cursor);
+    static simd::float3 interpolateScale(float time, const BoneAnimation& anim, uint32_t& cursor);
 };
 
 class AnimationStateMachine
@@ -27,6 +27,12 @@ static simd::float4 sPlaneNormalize( const simd::float4& inPlane )
     return (inPlane / simd::length(inPlane.xyz));
 }
 
+static Plane sMakePlane( const simd::float4& inPlane )
+{
+    simd::float4 plane = sPlaneNormalize(inPlane);
+    return (Plane{ plane.xyz, plane.w });
+}
+
 RMDLCamera::RMDLCamera() : _position{0, 0, 0}, _direction{0, 0, 1}, _up{0, 1, 0}, _viewAngle(0), _aspectRatio(1.0), _nearPlane(0.1f), _farPlane(100.0f), _width(0), _uniformsDirty(true)
 {
 }
@@ -104,16 +110,26 @@ void RMDLCamera::updateUniforms()
     _uniforms.invOrientationProjectionMatrix = simd_inverse( _uniforms.projectionMatrix * sInvMatrixLookat( simd::float3{0, 0, 0}, _direction, _up ) );
     _uniforms.invViewProjectionMatrix = simd_inverse(_uniforms.viewProjectionMatrix);
     _uniforms.invViewMatrix = simd_inverse(_uniforms.viewMatrix);
-    simd::float4x4 transp_vpm = simd::transpose(_uniforms.viewProjectionMatrix);
-    _uniforms.frustumPlanes[0] = sPlaneNormalize(transp_vpm.columns[3] + transp_vpm.columns[0]);
-    _uniforms.frustumPlanes[1] = sPlaneNormalize(transp_vpm.columns[3] - transp_vpm.columns[0]);
-    _uniforms.frustumPlanes[2] = sPlaneNormalize(transp_vpm.columns[3] + transp_vpm.columns[1]);
-    _uniforms.frustumPlanes[3] = sPlaneNormalize(transp_vpm.columns[3] - transp_vpm.columns[1]);
-    _uniforms.frustumPlanes[4] = sPlaneNormalize(transp_vpm.columns[3] + transp_vpm.columns[2]);
-    _uniforms.frustumPlanes[5] = sPlaneNormalize(transp_vpm.columns[3] - transp_vpm.columns[2]);
+    _frustum = frustumFromViewProjection(_uniforms.viewProjectionMatrix);
+    const Plane* planes[6] = { &_frustum.leftFace, &_frustum.rightFace, &_frustum.bottomFace, &_frustum.topFace, &_frustum.nearFace, &_frustum.farFace };
+    for (int i = 0; i < 6; i++)
+        _uniforms.frustumPlanes[i] = simd::make_float4(planes[i]->normal, planes[i]->distance);
     _uniformsDirty = false;
 }
 
+Frustum RMDLCamera::frustumFromViewProjection(const simd::float4x4& viewProjection)
+{
+    simd::float4x4 transp_vpm = simd::transpose(viewProjection);
+    Frustum frustum;
+    frustum.leftFace = sMakePlane(transp_vpm.columns[3] + transp_vpm.columns[0]);
+    frustum.rightFace = sMakePlane(transp_vpm.columns[3] - transp_vpm.columns[0]);
+    frustum.bottomFace = sMakePlane(transp_vpm.columns[3] + transp_vpm.columns[1]);
+    frustum.topFace = sMakePlane(transp_vpm.columns[3] - transp_vpm.columns[1]);
+    frustum.nearFace = sMakePlane(transp_vpm.columns[2]);   // z >= 0 en Metal, pas z >= -w
+    frustum.farFace = sMakePlane(transp_vpm.columns[3] - transp_vpm.columns[2]);
+    return (frustum);
+}
+
 simd::float3 RMDLCamera::left() const
 {
     return (simd_cross(_direction, _up));
@@ -185,6 +201,13 @@ RMDLCameraUniforms RMDLCamera::uniforms()
         RMDLCamera::updateUniforms();
     return (_uniforms);
 }
+
+Frustum RMDLCamera::frustum()
+{
+    if (_uniformsDirty)
+        RMDLCamera::updateUniforms();
+    return (_frustum);
+}
     
 void RMDLCamera::setNearPlane(float newNearPlane)
 {
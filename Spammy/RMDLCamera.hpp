@@ -54,7 +54,10 @@ public:
     RMDLCamera&     initPerspectiveWithPosition( simd::float3 position, simd::float3 direction, simd::float3 up, float viewAngle, float aspectRatio, float nearPlane, float farPlane );
     RMDLCamera&     initParallelWithPosition( simd::float3 position, simd::float3 direction, simd::float3 up, float width, float height, float nearPlane, float farPlane );
     RMDLCameraUniforms  uniforms();
+    Frustum         frustum();
     void            updateUniforms();
+    // Gribb/Hartmann, profondeur Metal dans [0, 1] : seule extraction des plans, pour les passes qui n'ont que la matrice
+    static Frustum  frustumFromViewProjection( const simd::float4x4& viewProjection );
     bool            isPerspective() const;
     bool            isParallel() const;
     simd::float3    left() const;
@@ -141,6 +144,7 @@ private:
     void            orthogonalizeFromNewForward( simd::float3 newForward );
     bool            _uniformsDirty;
     RMDLCameraUniforms  _uniforms;
+    Frustum         _frustum;
     
     float _yaw = 0.0f;
     float _pitch = 0.0f;
@@ -0,0 +1,107 @@
+//
+//  RMDLFrustumCulling.cpp
+//  Spammy
+//
+//  Created by Rémy on 17/10/2026.
+//
+
+#include "RMDLFrustumCulling.hpp"
+
+#include <array>
+#include <cstring>
+
+namespace culling
+{
+
+// Même ordre que RMDLCameraUniforms::frustumPlanes
+static std::array<Plane, 6> planesOf(const Frustum& frustum)
+{
+    return { frustum.leftFace, frustum.rightFace, frustum.bottomFace, frustum.topFace, frustum.nearFace, frustum.farFace };
+}
+
+// Coin de la boîte le plus loin dans la direction de la normale : s'il est derrière un plan, toute la boîte l'est
+bool isBoxVisible(const Frustum& frustum, simd::float3 boxMin, simd::float3 boxMax)
+{
+    for (const Plane& plane : planesOf(frustum))
+    {
+        float x = plane.normal.x >= 0.0f ? boxMax.x : boxMin.x;
+        float y = plane.normal.y >= 0.0f ? boxMax.y : boxMin.y;
+        float z = plane.normal.z >= 0.0f ? boxMax.z : boxMin.z;
+        if (plane.normal.x * x + plane.normal.y * y + plane.normal.z * z + plane.distance < 0.0f)
+            return false;
+    }
+    return true;
+}
+
+void BoxCuller::clear()
+{
+    for (auto* array : { &m_minX, &m_minY, &m_minZ, &m_maxX, &m_maxY, &m_maxZ })
+        array->clear();
+}
+
+void BoxCuller::reserve(size_t count)
+{
+    for (auto* array : { &m_minX, &m_minY, &m_minZ, &m_maxX, &m_maxY, &m_maxZ })
+        array->reserve(count);
+}
+
+uint32_t BoxCuller::addBox(simd::float3 boxMin, simd::float3 boxMax)
+{
+    m_minX.push_back(boxMin.x);
+    m_minY.push_back(boxMin.y);
+    m_minZ.push_back(boxMin.z);
+    m_maxX.push_back(boxMax.x);
+    m_maxY.push_back(boxMax.y);
+    m_maxZ.push_back(boxMax.z);
+    return static_cast<uint32_t>(m_minX.size() - 1);
+}
+
+static inline simd::float4 loadFloat4(const float* src)
+{
+    simd::float4 value;
+    std::memcpy(&value, src, sizeof(float) * 4);
+    return value;
+}
+
+void BoxCuller::cull(const Frustum& frustum, std::vector<uint32_t>& visible) const
+{
+    const std::array<Plane, 6> planes = planesOf(frustum);
+    const size_t count = size();
+    size_t i = 0;
+    
+    // Le choix du coin ne dépend que du signe de la normale : même sélection pour les 4 boîtes
+    for (; i + 4 <= count; i += 4)
+    {
+        simd::float4 minX = loadFloat4(&m_minX[i]), maxX = loadFloat4(&m_maxX[i]);
+        simd::float4 minY = loadFloat4(&m_minY[i]), maxY = loadFloat4(&m_maxY[i]);
+        simd::float4 minZ = loadFloat4(&m_minZ[i]), maxZ = loadFloat4(&m_maxZ[i]);
+        
+        simd::float4 worst = simd::make_float4(1.0f, 1.0f, 1.0f, 1.0f);
+        for (const Plane& plane : planes)
+        {
+            simd::float4 distance = (plane.normal.x >= 0.0f ? maxX : minX) * plane.normal.x
+                                  + (plane.normal.y >= 0.0f ? maxY : minY) * plane.normal.y
+                                  + (plane.normal.z >= 0.0f ? maxZ : minZ) * plane.normal.z
+                                  + plane.distance;
+            worst = simd::min(worst, distance);
+            if (simd::reduce_max(worst) < 0.0f)
+                break;
+        }
+        
+        for (uint32_t lane = 0; lane < 4; lane++)
+        {
+            if (worst[lane] >= 0.0f)
+                visible.push_back(static_cast<uint32_t>(i + lane));
+        }
+    }
+    
+    for (; i < count; i++)
+    {
+        simd::float3 boxMin = simd::make_float3(m_minX[i], m_minY[i], m_minZ[i]);
+        simd::float3 boxMax = simd::make_float3(m_maxX[i], m_maxY[i], m_maxZ[i]);
+        if (isBoxVisible(frustum, boxMin, boxMax))
+            visible.push_back(static_cast<uint32_t>(i));
+    }
+}
+
+}
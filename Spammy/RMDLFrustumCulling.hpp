@@ -0,0 +1,42 @@
+//
+//  RMDLFrustumCulling.hpp
+//  Spammy
+//
+//  Created by Rémy on 17/10/2026.
+//
+
+#ifndef RMDLFrustumCulling_hpp
+#define RMDLFrustumCulling_hpp
+
+#include <simd/simd.h>
+#include <vector>
+#include <cstdint>
+
+#include "RMDLMainRenderer_shared.h"
+
+// Culling CPU de boîtes englobantes contre le Frustum de la caméra (RMDLCamera::frustum), avant l'encodeur
+namespace culling
+{
+
+bool isBoxVisible(const Frustum& frustum, simd::float3 boxMin, simd::float3 boxMax);
+
+// Boîtes rangées en SoA : cull() en teste 4 à la fois
+class BoxCuller
+{
+public:
+    void clear();
+    void reserve(size_t count);
+    uint32_t addBox(simd::float3 boxMin, simd::float3 boxMax);
+    size_t size() const { return m_minX.size(); }
+    
+    // Ajoute à visible l'indice (ordre des addBox) de chaque boîte au moins en partie dans le frustum
+    void cull(const Frustum& frustum, std::vector<uint32_t>& visible) const;
+
+private:
+    std::vector<float>  m_minX, m_minY, m_minZ;
+    std::vector<float>  m_maxX, m_maxY, m_maxZ;
+};
+
+}
+
+#endif /* RMDLFrustumCulling_hpp */
@@ -7,11 +7,74 @@
 
 #include "RMDLHexagonSpace.hpp"
 
-static float randomFloat()
+#include <cstring>
+
+#if __has_include(<simd/simd.h>)
+using AudioFloat4 = simd::float4;
+#else
+// Build hors Apple (rendu hors-ligne) : même vecteur 128 bits via l'extension GCC/Clang
+typedef float AudioFloat4 __attribute__((vector_size(16)));
+#endif
+
+// Bruit xorshift32 dans [-1, 1), un état par voix : reproductible au bit près pour une graine
+// donnée, indépendamment de l'ordre de rendu des voix et des autres synthés
+static inline float randomFloat(uint32_t& state)
+{
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return (float)(int32_t)state * (1.0f / 2147483648.0f);
+}
+
+WavetableBank::WavetableBank()
+{
+    const int stride = kTableSize + 1;
+    m_sine.resize(stride);
+    for (int n = 0; n < stride; n++)
+        m_sine[n] = (float)std::sin(2.0 * M_PI * n / kTableSize);    // en double : même float sur toutes les libm
+
+    // sin(2π h n / N) lu dans la table de sinus : somme exacte des harmoniques sans appel à sinf
+    m_tables.assign((size_t)kMaxHarmonics * kNumLevels * stride, 0.0f);
+    for (int timbre = 0; timbre < kMaxHarmonics; timbre++)
+    {
+        int sawHarmonics = timbre + 1;
+        for (int level = 0; level < kNumLevels; level++)
+        {
+            float* table = m_tables.data() + ((size_t)timbre * kNumLevels + level) * stride;
+            int maxHarmonic = (kTableSize / 2) >> level;
+
+            for (int h = 1; h <= maxHarmonic; h++)
+            {
+                float amplitude = 0.0f;
+                if (h <= sawHarmonics)
+                    amplitude += 0.5f * 0.7f / h;           // saw additive d'origine
+                if (h % 2 == 1)
+                    amplitude += 0.3f * 0.5f * 4.0f / (M_PI * h);   // carré ±0.5
+                if (amplitude == 0.0f)
+                    continue;
+
+                for (int n = 0; n < kTableSize; n++)
+                    table[n] += amplitude * m_sine[(size_t)h * n % kTableSize];
+            }
+            table[kTableSize] = table[0];
+        }
+    }
+}
+
+const WavetableBank& WavetableBank::shared()
 {
-    static std::mt19937 gen(42);
-    static std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
-    return dist(gen);
+    static const WavetableBank bank;
+    return bank;
+}
+
+const float* WavetableBank::table(int numHarmonics, float maxFrequency, float sampleRate) const
+{
+    int timbre = std::clamp(numHarmonics, 1, kMaxHarmonics) - 1;
+    float nyquist = sampleRate * 0.5f;
+    int level = 0;
+    while (level < kNumLevels - 1 && (float)((kTableSize / 2) >> level) * maxFrequency > nyquist)
+        level++;
+    return m_tables.data() + ((size_t)timbre * kNumLevels + level) * (kTableSize + 1);
 }
 
 void SpaceVoice::noteOn(float velocity)
@@ -26,8 +89,48 @@ void SpaceVoice::noteOff()
     m_targetAmplitude = 0.0f;
 }
 
+void SpaceVoice::seedNoise(uint32_t seed)
+{
+    // Mélange murmur3 : des graines voisines donnent des suites sans rapport ; 0 est un point fixe
+    seed ^= seed >> 16;
+    seed *= 0x85ebca6bu;
+    seed ^= seed >> 13;
+    seed *= 0xc2b2ae35u;
+    seed ^= seed >> 16;
+    m_noiseState = seed ? seed : 0x9E3779B9u;
+}
+
+void SpaceVoice::rampThrottle(float t, int frames)
+{
+    m_throttleTarget = std::clamp(t, 0.0f, 1.0f);
+    if (frames <= 0)
+    {
+        m_throttle = m_throttleTarget;
+        m_throttleRampFrames = 0;
+        return;
+    }
+    m_throttleRampFrames = frames;
+    m_throttleStep = (m_throttleTarget - m_throttle) / frames;
+}
+
+void SpaceVoice::advanceThrottle(int frames)
+{
+    if (m_throttleRampFrames <= 0)
+        return;
+    if (frames >= m_throttleRampFrames)
+    {
+        m_throttle = m_throttleTarget;
+        m_throttleRampFrames = 0;
+        return;
+    }
+    m_throttle += m_throttleStep * frames;
+    m_throttleRampFrames -= frames;
+}
+
 float SpaceVoice::process(float sampleRate)
 {
+    advanceThrottle(1);
+    
     // Enveloppe ADSR simplifiée
     float envSpeed = m_active ? (1.0f / (m_profile.attack * sampleRate)) : (1.0f / (m_profile.release * sampleRate));
     m_amplitude += (m_targetAmplitude - m_amplitude) * envSpeed * 100.0f;
@@ -35,10 +138,12 @@ float SpaceVoice::process(float sampleRate)
     
     if (m_amplitude < 0.0001f && !m_active) return 0.0f;
     
+    const WavetableBank& bank = WavetableBank::shared();
+    
     // LFO
     m_lfoPhase += m_profile.lfoRate / sampleRate;
-    if (m_lfoPhase > 1.0f) m_lfoPhase -= 1.0f;
-    float lfo = sinf(m_lfoPhase * 2.0f * M_PI) * m_profile.lfoDepth;
+    if (m_lfoPhase >= 1.0f) m_lfoPhase -= 1.0f;
+    float lfo = WavetableBank::sample(bank.sine(), m_lfoPhase) * m_profile.lfoDepth;
     
     // Fréquence modulée par throttle et LFO
     float freq = m_profile.baseFrequency * (1.0f + m_throttle * 0.5f) * (1.0f + lfo * 0.1f);
@@ -52,32 +157,24 @@ float SpaceVoice::process(float sampleRate)
         1.0f + m_profile.detuneAmount
     };
     
-    float oscMix = 0.0f;
+    // Saw + square lus dans la table sans repliement pour la fréquence la plus haute possible
     int numHarmonics = 1 + (int)(m_profile.harmonicRichness * 6);
+    float maxFreq = m_profile.baseFrequency * (1.0f + m_throttle * 0.5f) * (1.0f + m_profile.lfoDepth * 0.1f) * detune[3];
+    const float* wave = bank.table(numHarmonics, maxFreq, sampleRate);
     
+    float oscMix = 0.0f;
     for (int o = 0; o < 4; o++)
     {
         float oscFreq = freq * detune[o];
         m_phase[o] += oscFreq / sampleRate;
-        if (m_phase[o] > 1.0f) m_phase[o] -= 1.0f;
-        
-        // Onde saw avec harmoniques
-        float saw = 0.0f;
-        for (int h = 1; h <= numHarmonics; h++) {
-            float harmPhase = fmodf(m_phase[o] * h, 1.0f);
-            saw += sinf(harmPhase * 2.0f * M_PI) / h;
-        }
-        saw *= 0.5f;
-        
-        // Mix square pour plus de corps
-        float square = (m_phase[o] < 0.5f) ? 0.5f : -0.5f;
+        if (m_phase[o] >= 1.0f) m_phase[o] -= 1.0f;
         
-        oscMix += saw * 0.7f + square * 0.3f;
+        oscMix += WavetableBank::sample(wave, m_phase[o]);
     }
     oscMix *= 0.25f;  // Normaliser 4 oscillateurs
     
     // Bruit de moteur
-    float noise = randomFloat() * m_profile.noiseAmount * (0.5f + m_throttle * 0.5f);
+    float noise = randomFloat(m_noiseState) * m_profile.noiseAmount * (0.5f + m_throttle * 0.5f);
     oscMix += noise;
     
     // Filtre passe-bas résonant (2-pole)
@@ -94,13 +191,113 @@ float SpaceVoice::process(float sampleRate)
     float filtered = m_filterState[1];
     
     // Amplitude finale
-    float output = filtered * m_amplitude * (0.3f + m_throttle * 0.7f);
+    if (m_gainRampFrames > 0)
+    {
+        m_gain = (--m_gainRampFrames == 0) ? m_gainTarget : m_gain + m_gainStep;
+    }
+    float output = filtered * m_amplitude * (0.3f + m_throttle * 0.7f) * m_gain;
     
     m_time += 1.0f / sampleRate;
     
     return output;
 }
 
+void SpaceVoice::processBlock(float* output, int numFrames, float sampleRate)
+{
+    // Throttle constant sur le bloc, la rampe avance d'un bloc à l'autre
+    advanceThrottle(numFrames);
+
+    // Tout ce qui ne dépend pas du sample est calculé une fois par bloc
+    const float invSampleRate = 1.0f / sampleRate;
+    const float envSpeed = (m_active ? (1.0f / (m_profile.attack * sampleRate)) : (1.0f / (m_profile.release * sampleRate))) * 100.0f;
+    const float lfoStep = m_profile.lfoRate / sampleRate;
+    const float baseFreq = m_profile.baseFrequency * (1.0f + m_throttle * 0.5f);
+    const float detune[4] =
+    {
+        1.0f - m_profile.detuneAmount,
+        1.0f - m_profile.detuneAmount * 0.5f,
+        1.0f + m_profile.detuneAmount * 0.5f,
+        1.0f + m_profile.detuneAmount
+    };
+    const int numHarmonics = 1 + (int)(m_profile.harmonicRichness * 6);
+    const WavetableBank& bank = WavetableBank::shared();
+    const float* wave = bank.table(numHarmonics, baseFreq * (1.0f + m_profile.lfoDepth * 0.1f) * detune[3], sampleRate);
+    const float* sine = bank.sine();
+    const float noiseGain = m_profile.noiseAmount * (0.5f + m_throttle * 0.5f);
+    const float cutoffBase = m_profile.filterCutoff * (0.5f + m_throttle * 0.5f);
+    const float resonance = m_profile.filterResonance;
+    const float outputGain = 0.3f + m_throttle * 0.7f;
+    const int gainFrames = std::min(numFrames, m_gainRampFrames);
+    float gain = m_gain;
+
+    // État en registres pendant le bloc
+    float amplitude = m_amplitude;
+    float lfoPhase = m_lfoPhase;
+    float phase[4] = { m_phase[0], m_phase[1], m_phase[2], m_phase[3] };
+    float f0 = m_filterState[0];
+    float f1 = m_filterState[1];
+    uint32_t noiseState = m_noiseState;
+    int frame = 0;
+
+    for (; frame < numFrames; frame++)
+    {
+        amplitude += (m_targetAmplitude - amplitude) * envSpeed;
+        amplitude = std::clamp(amplitude, 0.0f, 1.0f);
+        if (amplitude < 0.0001f && !m_active)
+            break;
+
+        lfoPhase += lfoStep;
+        if (lfoPhase >= 1.0f) lfoPhase -= 1.0f;
+        float lfo = WavetableBank::sample(sine, lfoPhase) * m_profile.lfoDepth;
+        float freq = baseFreq * (1.0f + lfo * 0.1f);
+
+        float oscMix = 0.0f;
+        for (int o = 0; o < 4; o++)
+        {
+            phase[o] += freq * detune[o] / sampleRate;
+            if (phase[o] >= 1.0f) phase[o] -= 1.0f;
+            oscMix += WavetableBank::sample(wave, phase[o]);
+        }
+        oscMix *= 0.25f;
+        oscMix += randomFloat(noiseState) * noiseGain;
+
+        float cutoff = std::clamp(cutoffBase * (1.0f + lfo * 0.2f), 0.01f, 0.99f);
+        float fc = cutoff * cutoff * 0.5f;
+        f0 += fc * (oscMix - f0 + resonance * (f0 - f1));
+        f1 += fc * (f0 - f1);
+
+        if (frame < gainFrames)
+            gain += m_gainStep;
+        output[frame] += f1 * amplitude * outputGain * gain;
+    }
+
+    m_amplitude = amplitude;
+    m_lfoPhase = lfoPhase;
+    for (int o = 0; o < 4; o++)
+        m_phase[o] = phase[o];
+    m_filterState[0] = f0;
+    m_filterState[1] = f1;
+    m_noiseState = noiseState;
+    m_time += frame * invSampleRate;
+    
+    // Rampe avancée d'un bloc entier même si la voix s'est tue en route
+    m_gainRampFrames -= gainFrames;
+    m_gain = m_gainRampFrames == 0 ? m_gainTarget : m_gain + m_gainStep * gainFrames;
+}
+
+void SpaceVoice::rampGain(float gain, int frames)
+{
+    m_gainTarget = std::max(gain, 0.0f);
+    if (frames <= 0)
+    {
+        m_gain = m_gainTarget;
+        m_gainRampFrames = 0;
+        return;
+    }
+    m_gainRampFrames = frames;
+    m_gainStep = (m_gainTarget - m_gain) / frames;
+}
+
 void ReverbEffect::init(float sampleRate, float roomSize)
 {
     int combSizes[kNumCombs] = { 1116, 1188, 1277, 1356, 1422, 1491, 1557, 1617 };
@@ -111,7 +308,7 @@ void ReverbEffect::init(float sampleRate, float roomSize)
         int size = (int)(combSizes[i] * sampleRate / 44100.0f);
         m_combBuffers[i].resize(size, 0.0f);
         m_combIndex[i] = 0;
-        m_combFeedback[i] = powf(roomSize, (float)combSizes[i] / 1000.0f);
+        m_combFeedback[i] = (float)std::pow((double)roomSize, combSizes[i] / 1000.0);
     }
     
     for (int i = 0; i < kNumAllpass; i++)
@@ -154,6 +351,118 @@ float ReverbEffect::process(float input)
     return input * (1.0f - m_mix) + allpassOut * m_mix;
 }
 
+static inline AudioFloat4 loadFloat4(const float* src)
+{
+    AudioFloat4 value;
+    std::memcpy(&value, src, sizeof(float) * 4);
+    return value;
+}
+
+static inline void storeFloat4(float* dst, AudioFloat4 value)
+{
+    std::memcpy(dst, &value, sizeof(float) * 4);
+}
+
+// Les lignes de retard sont au moins aussi longues que la portée traitée : les lectures d'une
+// portée précèdent toutes ses écritures, donc chaque filtre se vectorise le long du temps.
+static void combSpan(float* line, const float* input, float* sum, int count, float feedback)
+{
+    int n = 0;
+    for (; n + 4 <= count; n += 4)
+    {
+        AudioFloat4 delayed = loadFloat4(line + n);
+        storeFloat4(line + n, loadFloat4(input + n) + delayed * feedback);
+        storeFloat4(sum + n, loadFloat4(sum + n) + delayed);
+    }
+    for (; n < count; n++)
+    {
+        float delayed = line[n];
+        line[n] = input[n] + delayed * feedback;
+        sum[n] += delayed;
+    }
+}
+
+static void allpassSpan(float* line, float* signal, int count)
+{
+    int n = 0;
+    for (; n + 4 <= count; n += 4)
+    {
+        AudioFloat4 delayed = loadFloat4(line + n);
+        AudioFloat4 newVal = loadFloat4(signal + n) + delayed * 0.5f;
+        storeFloat4(line + n, newVal);
+        storeFloat4(signal + n, delayed - newVal * 0.5f);
+    }
+    for (; n < count; n++)
+    {
+        float delayed = line[n];
+        float newVal = signal[n] + delayed * 0.5f;
+        line[n] = newVal;
+        signal[n] = delayed - newVal * 0.5f;
+    }
+}
+
+// Wet/dry en rampe linéaire sur le bloc, de la valeur du bloc précédent vers la cible
+static void mixSpan(float* dry, const float* wet, int count, float& current, float target)
+{
+    const float step = (target - current) / count;
+    float mix = current;
+    for (int n = 0; n < count; n++)
+    {
+        mix += step;
+        dry[n] = dry[n] * (1.0f - mix) + wet[n] * mix;
+    }
+    current = target;
+}
+
+void ReverbEffect::processBlock(float* buffer, int numFrames)
+{
+    float combOut[kBlockSize];
+    float wet[kBlockSize];
+
+    for (int start = 0; start < numFrames; start += kBlockSize)
+    {
+        int count = std::min(numFrames - start, kBlockSize);
+        float* dry = buffer + start;
+        std::fill(combOut, combOut + count, 0.0f);
+
+        // Combs en parallèle : une portée contiguë jusqu'au bouclage de la ligne
+        for (int i = 0; i < kNumCombs; i++)
+        {
+            float* line = m_combBuffers[i].data();
+            int size = (int)m_combBuffers[i].size();
+            int& idx = m_combIndex[i];
+            for (int done = 0; done < count;)
+            {
+                int span = std::min(count - done, size - idx);
+                combSpan(line + idx, dry + done, combOut + done, span, m_combFeedback[i]);
+                done += span;
+                idx += span;
+                if (idx == size) idx = 0;
+            }
+        }
+
+        for (int n = 0; n < count; n++)
+            wet[n] = combOut[n] / kNumCombs;
+
+        // Allpass en série, en place sur wet
+        for (int i = 0; i < kNumAllpass; i++)
+        {
+            float* line = m_allpassBuffers[i].data();
+            int size = (int)m_allpassBuffers[i].size();
+            int& idx = m_allpassIndex[i];
+            for (int done = 0; done < count;)
+            {
+                int span = std::min(count - done, size - idx);
+                allpassSpan(line + idx, wet + done, span);
+                done += span;
+                idx += span;
+                if (idx == size) idx = 0;
+            }
+        }
+
+        mixSpan(dry, wet, count, m_mixSmoothed, m_mix);
+    }
+}
 
 void DelayEffect::init(float sampleRate, float maxDelay)
 {
@@ -179,9 +488,62 @@ float DelayEffect::process(float input)
     return input * (1.0f - m_mix) + delayed * m_mix;
 }
 
+void DelayEffect::processBlock(float* buffer, int numFrames)
+{
+    float* line = m_buffer.data();
+    const int size = (int)m_buffer.size();
+    int readIndex = m_writeIndex - m_delaySamples;
+    if (readIndex < 0) readIndex += size;
+    float wet[ReverbEffect::kBlockSize];
+
+    for (int start = 0; start < numFrames; start += ReverbEffect::kBlockSize)
+    {
+        int count = std::min(numFrames - start, ReverbEffect::kBlockSize);
+        float* dry = buffer + start;
+
+        // Portée limitée au retard : un sample écrit n'est jamais relu dans la même portée
+        for (int done = 0; done < count;)
+        {
+            int span = std::min({ count - done, size - m_writeIndex, size - readIndex, m_delaySamples });
+            const float* read = line + readIndex;
+            float* write = line + m_writeIndex;
+            int n = 0;
+            for (; n + 4 <= span; n += 4)
+            {
+                AudioFloat4 delayed = loadFloat4(read + n);
+                storeFloat4(write + n, loadFloat4(dry + done + n) + delayed * m_feedback);
+                storeFloat4(wet + done + n, delayed);
+            }
+            for (; n < span; n++)
+            {
+                float delayed = read[n];
+                write[n] = dry[done + n] + delayed * m_feedback;
+                wet[done + n] = delayed;
+            }
+            done += span;
+            m_writeIndex += span;
+            readIndex += span;
+            if (m_writeIndex == size) m_writeIndex = 0;
+            if (readIndex == size) readIndex = 0;
+        }
+
+        mixSpan(dry, wet, count, m_mixSmoothed, m_mix);
+    }
+}
+
+SpaceshipSynthesizer::SpaceshipSynthesizer()
+: m_sources(kMaxVoices), m_pool(kPoolSize), m_slots(kPoolSize)
+{
+    m_candidates.reserve(kMaxVoices);
+    m_scheduled.reserve(kScheduledCapacity);
+    m_freeVoiceIds.reserve(kMaxVoices);
+    m_pendingReleases.reserve(kMaxVoices);
+}
+
 void SpaceshipSynthesizer::init(float sampleRate)
 {
     m_sampleRate = sampleRate;
+    WavetableBank::shared();    // génère les tables ici plutôt qu'au premier callback audio
     m_reverb.init(sampleRate, 0.85f);
     m_delay.init(sampleRate, 1.0f);
     m_delay.setTime(0.3f);
@@ -190,65 +552,414 @@ void SpaceshipSynthesizer::init(float sampleRate)
 
 int SpaceshipSynthesizer::addVoice(const BlockSoundProfile& profile)
 {
-    auto voice = std::make_unique<SpaceVoice>();
-    voice->setProfile(profile);
-    int id = (int)m_voices.size();
-    m_voices.push_back(std::move(voice));
+    int id;
+    if (!m_freeVoiceIds.empty())
+    {
+        id = m_freeVoiceIds.back();
+        m_freeVoiceIds.pop_back();
+    }
+    else if (m_allocatedVoices < kMaxVoices)
+        id = m_allocatedVoices++;
+    else
+        return -1;
+    
+    VoiceEvent event;
+    event.type = VoiceEvent::Type::Profile;
+    event.voiceId = id;
+    event.profile = profile;
+    if (!postEvent(event))
+    {
+        // La source n'existe pas côté audio : l'id reste libre
+        m_freeVoiceIds.push_back(id);
+        return -1;
+    }
     return id;
 }
 
 void SpaceshipSynthesizer::removeVoice(int voiceId)
 {
-    if (voiceId >= 0 && voiceId < m_voices.size()) {
-        m_voices[voiceId]->noteOff();
-    }
+    if (voiceId < 0 || voiceId >= m_allocatedVoices)
+        return;
+    
+    // L'id peut être réutilisé tout de suite : le Remove passe avant le Profile suivant.
+    // S'il n'a pas pu partir, la source vit encore côté audio et l'id ne doit pas resservir
+    VoiceEvent event;
+    event.type = VoiceEvent::Type::Remove;
+    event.voiceId = voiceId;
+    if (postEvent(event))
+        m_freeVoiceIds.push_back(voiceId);
 }
 
 void SpaceshipSynthesizer::setVoiceThrottle(int voiceId, float throttle)
 {
-    if (voiceId >= 0 && voiceId < m_voices.size()) {
-        m_voices[voiceId]->setThrottle(throttle);
-    }
+    rampVoiceThrottle(voiceId, throttle, 0.0f);
+}
+
+void SpaceshipSynthesizer::rampVoiceThrottle(int voiceId, float throttle, float seconds, uint64_t atFrame)
+{
+    if (voiceId < 0 || voiceId >= m_allocatedVoices)
+        return;
+    
+    VoiceEvent event;
+    event.type = VoiceEvent::Type::Throttle;
+    event.voiceId = voiceId;
+    event.frame = atFrame;
+    event.value = throttle;
+    event.rampSeconds = seconds;
+    postEvent(event);
 }
 
 void SpaceshipSynthesizer::setVoiceProfile(int voiceId, const BlockSoundProfile& profile)
 {
-    if (voiceId >= 0 && voiceId < m_voices.size()) {
-        m_voices[voiceId]->setProfile(profile);
+    if (voiceId < 0 || voiceId >= m_allocatedVoices)
+        return;
+    
+    VoiceEvent event;
+    event.type = VoiceEvent::Type::Profile;
+    event.voiceId = voiceId;
+    event.profile = profile;
+    postEvent(event);
+}
+
+void SpaceshipSynthesizer::triggerVoice(int voiceId, float velocity, uint64_t atFrame)
+{
+    if (voiceId < 0 || voiceId >= m_allocatedVoices)
+        return;
+    
+    VoiceEvent event;
+    event.type = VoiceEvent::Type::NoteOn;
+    event.voiceId = voiceId;
+    event.frame = atFrame;
+    event.value = velocity;
+    postEvent(event);
+}
+
+void SpaceshipSynthesizer::releaseVoice(int voiceId, uint64_t atFrame)
+{
+    if (voiceId < 0 || voiceId >= m_allocatedVoices)
+        return;
+    
+    VoiceEvent event;
+    event.type = VoiceEvent::Type::NoteOff;
+    event.voiceId = voiceId;
+    event.frame = atFrame;
+    postEvent(event);
+}
+
+void SpaceshipSynthesizer::setVoiceDistance(int voiceId, float distance)
+{
+    if (voiceId < 0 || voiceId >= m_allocatedVoices)
+        return;
+    
+    VoiceEvent event;
+    event.type = VoiceEvent::Type::Distance;
+    event.voiceId = voiceId;
+    event.value = distance;
+    postEvent(event);
+}
+
+void SpaceshipSynthesizer::setMasterVolume(float vol)
+{
+    VoiceEvent event;
+    event.type = VoiceEvent::Type::MasterVolume;
+    event.value = vol;
+    postEvent(event);
+}
+
+void SpaceshipSynthesizer::setMasterThrottle(float t)
+{
+    VoiceEvent event;
+    event.type = VoiceEvent::Type::Throttle;
+    event.voiceId = -1;
+    event.value = t;
+    postEvent(event);
+}
+
+bool SpaceshipSynthesizer::postEvent(const VoiceEvent& event)
+{
+    // Les NoteOff/Remove en attente partent d'abord : une note plus récente ne doit pas être coupée par eux
+    if (flushEvents() && m_events.push(event))
+        return true;
+
+    if (event.type == VoiceEvent::Type::NoteOff || event.type == VoiceEvent::Type::Remove)
+    {
+        // Une note perdue resterait tenue : gardé côté jeu, un seul par source, Remove l'emporte
+        for (VoiceEvent& pending : m_pendingReleases)
+        {
+            if (pending.voiceId == event.voiceId)
+            {
+                if (event.type == VoiceEvent::Type::Remove)
+                    pending = event;
+                return true;
+            }
+        }
+        m_pendingReleases.push_back(event);
+        return true;
     }
+    m_droppedEvents.fetch_add(1, std::memory_order_relaxed);
+    return false;
 }
 
-void SpaceshipSynthesizer::triggerVoice(int voiceId, float velocity)
+bool SpaceshipSynthesizer::flushEvents()
 {
-    if (voiceId >= 0 && voiceId < m_voices.size()) {
-        m_voices[voiceId]->noteOn(velocity);
+    size_t sent = 0;
+    while (sent < m_pendingReleases.size() && m_events.push(m_pendingReleases[sent]))
+        sent++;
+    m_pendingReleases.erase(m_pendingReleases.begin(), m_pendingReleases.begin() + sent);
+    return m_pendingReleases.empty();
+}
+
+void SpaceshipSynthesizer::applyEvent(const VoiceEvent& event)
+{
+    if (event.type == VoiceEvent::Type::MasterVolume)
+    {
+        m_masterVolume = event.value;
+        return;
+    }
+    
+    if (event.voiceId < 0)
+    {
+        // Rampe commune : setMasterThrottle n'a pas de durée, rampSeconds reste disponible
+        float throttle = std::clamp(event.value, 0.0f, 1.0f);
+        for (int i = 0; i < m_sourceCount; i++)
+        {
+            m_sources[i].throttle = throttle;
+            if (m_sources[i].slot >= 0)
+                m_pool[m_sources[i].slot].rampThrottle(throttle, (int)(event.rampSeconds * m_sampleRate));
+        }
+        return;
+    }
+    if (event.voiceId >= kMaxVoices)
+        return;
+    
+    VoiceSource& source = m_sources[event.voiceId];
+    SpaceVoice* voice = source.slot >= 0 ? &m_pool[source.slot] : nullptr;
+    switch (event.type)
+    {
+        case VoiceEvent::Type::Profile:
+            if (!source.used)
+            {
+                source = VoiceSource();
+                source.used = true;
+                m_sourceCount = std::max(m_sourceCount, event.voiceId + 1);
+            }
+            source.profile = event.profile;
+            if (voice) voice->setProfile(event.profile);
+            break;
+        case VoiceEvent::Type::NoteOn:
+            source.velocity = event.value;
+            source.playing = true;
+            if (voice) voice->noteOn(event.value);
+            break;
+        case VoiceEvent::Type::NoteOff:
+            source.playing = false;
+            if (voice) voice->noteOff();
+            break;
+        case VoiceEvent::Type::Throttle:
+            source.throttle = std::clamp(event.value, 0.0f, 1.0f);
+            if (voice) voice->rampThrottle(event.value, (int)(event.rampSeconds * m_sampleRate));
+            break;
+        case VoiceEvent::Type::Distance:
+            source.gain = event.value > kMaxDistance ? 0.0f : kReferenceDistance / std::max(event.value, kReferenceDistance);
+            if (voice) voice->rampGain(source.gain, kBlockSize);
+            break;
+        case VoiceEvent::Type::Remove:
+            if (source.slot >= 0)
+                releaseSlot(source.slot);
+            source.used = false;
+            source.playing = false;
+            // Les datés en attente visaient cette source ; l'id peut déjà être réutilisé
+            m_scheduled.erase(std::remove_if(m_scheduled.begin(), m_scheduled.end(),
+                                             [&](const VoiceEvent& e) { return e.voiceId == event.voiceId; }),
+                              m_scheduled.end());
+            break;
+        default: break;
     }
 }
 
-void SpaceshipSynthesizer::releaseVoice(int voiceId)
+void SpaceshipSynthesizer::startSlot(int slot, int sourceId)
 {
-    if (voiceId >= 0 && voiceId < m_voices.size()) {
-        m_voices[voiceId]->noteOff();
+    VoiceSource& source = m_sources[sourceId];
+    SpaceVoice& voice = m_pool[slot];
+    voice = SpaceVoice();
+    voice.seedNoise(m_seed.load(std::memory_order_relaxed) ^ ((uint32_t)sourceId * 0x9E3779B9u) ^ (uint32_t)m_frame);
+    voice.setProfile(source.profile);
+    voice.setThrottle(source.throttle);
+    voice.rampGain(source.gain, 0);
+    voice.noteOn(source.velocity);
+    
+    m_slots[slot] = { sourceId, -1, m_frame };
+    source.slot = slot;
+    source.pending = false;
+}
+
+// La source redevient virtuelle, sa voix s'éteint en kStealFadeFrames
+void SpaceshipSynthesizer::releaseSlot(int slot)
+{
+    PoolSlot& poolSlot = m_slots[slot];
+    if (poolSlot.source >= 0)
+        m_sources[poolSlot.source].slot = -1;
+    poolSlot.source = -1;
+    m_pool[slot].rampGain(0.0f, kStealFadeFrames);
+}
+
+// Une fois par bloc : libère les voix inaudibles, puis donne le pool aux sources les plus fortes,
+// en volant la voix la plus faible (la plus ancienne à égalité) si la demande est nettement plus forte
+void SpaceshipSynthesizer::scheduleVoices()
+{
+    for (int i = 0; i < kPoolSize; i++)
+    {
+        PoolSlot& slot = m_slots[i];
+        SpaceVoice& voice = m_pool[i];
+        
+        if (slot.source < 0)
+        {
+            if (slot.pendingSource >= 0 && (voice.isFadedOut() || !voice.isActive()))
+            {
+                VoiceSource& pending = m_sources[slot.pendingSource];
+                if (pending.used && pending.playing && pending.slot < 0)
+                    startSlot(i, slot.pendingSource);
+                else
+                {
+                    pending.pending = false;
+                    slot.pendingSource = -1;
+                }
+            }
+            continue;
+        }
+        
+        const VoiceSource& source = m_sources[slot.source];
+        if (!voice.isActive())
+        {
+            // Enveloppe retombée après noteOff : rien à fondre
+            m_sources[slot.source].slot = -1;
+            slot.source = -1;
+        }
+        else if (source.playing && sourceLoudness(source) < kAudibleLevel)
+            releaseSlot(i);
+    }
+    
+    m_candidates.clear();
+    for (int i = 0; i < m_sourceCount; i++)
+    {
+        const VoiceSource& source = m_sources[i];
+        if (source.used && source.playing && source.slot < 0 && !source.pending && sourceLoudness(source) >= kAudibleLevel)
+            m_candidates.push_back(i);
+    }
+    
+    auto louder = [this](int a, int b) { return sourceLoudness(m_sources[a]) > sourceLoudness(m_sources[b]); };
+    if ((int)m_candidates.size() > kPoolSize)
+    {
+        std::nth_element(m_candidates.begin(), m_candidates.begin() + kPoolSize, m_candidates.end(), louder);
+        m_candidates.resize(kPoolSize);
+    }
+    std::sort(m_candidates.begin(), m_candidates.end(), louder);
+    
+    for (int candidate : m_candidates)
+    {
+        VoiceSource& source = m_sources[candidate];
+        float loudness = sourceLoudness(source);
+        
+        int target = -1;
+        for (int i = 0; i < kPoolSize && target < 0; i++)
+        {
+            if (m_slots[i].source < 0 && m_slots[i].pendingSource < 0)
+                target = i;
+        }
+        
+        if (target < 0)
+        {
+            float quietest = INFINITY;
+            for (int i = 0; i < kPoolSize; i++)
+            {
+                if (m_slots[i].source < 0)
+                    continue;
+                // Niveau nominal tant que la note tient (l'attaque ne la rend pas volable), enveloppe après noteOff
+                const VoiceSource& owner = m_sources[m_slots[i].source];
+                float level = owner.playing ? sourceLoudness(owner) : m_pool[i].getLevel();
+                if (target < 0 || level < quietest || (level == quietest && m_slots[i].startFrame < m_slots[target].startFrame))
+                {
+                    quietest = level;
+                    target = i;
+                }
+            }
+            // Hystérésis : pas de vol entre deux sources de niveau voisin
+            if (target < 0 || quietest * 2.0f >= loudness)
+                break;
+            releaseSlot(target);
+        }
+        
+        if (m_pool[target].isFadedOut() || !m_pool[target].isActive())
+            startSlot(target, candidate);
+        else
+        {
+            m_slots[target].pendingSource = candidate;
+            source.pending = true;
+        }
     }
 }
 
-void SpaceshipSynthesizer::setMasterThrottle(float t)
+// Applique les événements dus à m_frame ; renvoie le nombre de frames à rendre avant le prochain daté
+int SpaceshipSynthesizer::applyEvents(int maxFrames)
+{
+    // Datés échus d'abord : ils ont été envoyés avant tout ce qui reste dans la ring
+    while (!m_scheduled.empty() && m_scheduled.back().frame <= m_frame)
+    {
+        VoiceEvent event = m_scheduled.back();
+        m_scheduled.pop_back();
+        applyEvent(event);
+    }
+    
+    // La ring est vidée à chaque appel : un daté part dans m_scheduled au lieu de bloquer la suite
+    while (const VoiceEvent* event = m_events.front())
+    {
+        if (event->frame > m_frame)
+            scheduleEvent(*event);
+        else
+            applyEvent(*event);
+        m_events.pop();
+    }
+    
+    if (m_scheduled.empty())
+        return maxFrames;
+    return (int)std::min<uint64_t>(maxFrames, m_scheduled.back().frame - m_frame);
+}
+
+// Insertion triée, derrière les événements de même frame déjà reçus ; pleine, le plus proche
+// passe en avance plutôt que d'être perdu
+void SpaceshipSynthesizer::scheduleEvent(const VoiceEvent& event)
 {
-    for (auto& voice : m_voices) {
-        voice->setThrottle(t);
+    if (m_scheduled.size() == kScheduledCapacity)
+    {
+        if (event.frame < m_scheduled.back().frame)
+        {
+            applyEvent(event);
+            return;
+        }
+        VoiceEvent earliest = m_scheduled.back();
+        m_scheduled.pop_back();
+        applyEvent(earliest);
     }
+    auto position = std::lower_bound(m_scheduled.begin(), m_scheduled.end(), event.frame,
+                                     [](const VoiceEvent& e, uint64_t frame) { return e.frame > frame; });
+    m_scheduled.insert(position, event);
 }
 
 float SpaceshipSynthesizer::processSample()
 {
+    if (m_frame % kBlockSize == 0)
+        scheduleVoices();
+    applyEvents(1);
     float mix = 0.0f;
     
-    for (auto& voice : m_voices)
+    for (auto& voice : m_pool)
     {
-        if (voice->isActive()) {
-            mix += voice->process(m_sampleRate);
+        if (voice.isActive() && !voice.isFadedOut()) {
+            mix += voice.process(m_sampleRate);
         }
     }
+    m_frame++;
+    m_renderedFrames.store(m_frame, std::memory_order_release);
     
     // Limiter
     mix = std::clamp(mix, -1.0f, 1.0f);
@@ -260,15 +971,60 @@ float SpaceshipSynthesizer::processSample()
     return mix * m_masterVolume;
 }
 
-void SpaceshipSynthesizer::renderBuffer(float* output, int numFrames, int numChannels)
+void SpaceshipSynthesizer::renderBlock(float* output, int numFrames)
 {
+    std::fill(output, output + numFrames, 0.0f);
+    scheduleVoices();
+    
+    // Le bloc est coupé à chaque événement daté pour l'appliquer au sample près
+    int rendered = 0;
+    for (int done = 0; done < numFrames;)
+    {
+        int count = applyEvents(numFrames - done);
+        rendered = 0;
+        for (auto& voice : m_pool)
+        {
+            if (voice.isActive() && !voice.isFadedOut())
+            {
+                voice.processBlock(output + done, count, m_sampleRate);
+                rendered++;
+            }
+        }
+        done += count;
+        m_frame += count;
+    }
+    m_renderedFrames.store(m_frame, std::memory_order_release);
+    m_renderedVoices.store(rendered, std::memory_order_relaxed);
+    
+    // Limiter
+    for (int i = 0; i < numFrames; i++)
+        output[i] = std::clamp(output[i], -1.0f, 1.0f);
+    
+    // Effets master
+    m_delay.processBlock(output, numFrames);
+    m_reverb.processBlock(output, numFrames);
+    
     for (int i = 0; i < numFrames; i++)
+        output[i] *= m_masterVolume;
+}
+
+void SpaceshipSynthesizer::renderMono(float* output, int numFrames)
+{
+    for (int start = 0; start < numFrames; start += kBlockSize)
+        renderBlock(output + start, std::min(numFrames - start, kBlockSize));
+}
+
+void SpaceshipSynthesizer::renderBuffer(float* output, int numFrames, int numChannels)
+{
+    for (int start = 0; start < numFrames; start += kBlockSize)
     {
-        float sample = processSample();
+        int count = std::min(numFrames - start, kBlockSize);
+        renderBlock(m_block, count);
         
-        for (int ch = 0; ch < numChannels; ch++)
+        for (int i = 0; i < count; i++)
         {
-            output[i * numChannels + ch] = sample;
+            for (int ch = 0; ch < numChannels; ch++)
+                output[(start + i) * numChannels + ch] = m_block[i];
         }
     }
 }
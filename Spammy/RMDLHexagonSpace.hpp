@@ -8,12 +8,18 @@
 #ifndef RMDLHexagonSpace_hpp
 #define RMDLHexagonSpace_hpp
 
+#if __has_include(<simd/simd.h>)
 #include <simd/simd.h>
+#endif
 #include <vector>
 #include <cmath>
 #include <memory>
 #include <algorithm>
 #include <random>
+#include <atomic>
+#include <cstdint>
+
+#include "RMDLSPSCQueue.hpp"
 
 struct BlockSoundProfile
 {
@@ -54,15 +60,59 @@ namespace BlockPresets {
     }
 }
 
+// Tables mip-mappées à bande limitée, générées une fois au démarrage. Un timbre par nombre
+// d'harmoniques de harmonicRichness : saw (harmoniques 1..n) * 0.7 + carré * 0.3, comme
+// l'ancienne synthèse additive, mais le carré est limité à Nyquist au lieu d'être naïf.
+class WavetableBank
+{
+public:
+    static constexpr int kTableSize = 2048;
+    static constexpr int kNumLevels = 11;       // niveau k : harmoniques jusqu'à (kTableSize / 2) >> k
+    static constexpr int kMaxHarmonics = 7;     // 1 + harmonicRichness * 6
+
+    static const WavetableBank& shared();
+
+    // Niveau le plus riche dont aucune harmonique ne dépasse Nyquist à maxFrequency
+    const float* table(int numHarmonics, float maxFrequency, float sampleRate) const;
+    const float* sine() const { return m_sine.data(); }
+
+    // phase dans [0, 1), interpolation linéaire (chaque table a un sample de garde)
+    static float sample(const float* table, float phase)
+    {
+        float position = phase * kTableSize;
+        int index = (int)position;
+        float frac = position - (float)index;
+        index &= kTableSize - 1;    // phase arrondie à 1.0 : même valeur que la garde
+        return table[index] + (table[index + 1] - table[index]) * frac;
+    }
+
+private:
+    WavetableBank();
+
+    std::vector<float> m_tables;    // [timbre][niveau][kTableSize + 1]
+    std::vector<float> m_sine;      // kTableSize + 1, pour les LFO
+};
+
 class SpaceVoice
 {
 public:
     void setProfile(const BlockSoundProfile& profile) { m_profile = profile; }
     void noteOn(float velocity = 1.0f);
     void noteOff();
-    void setThrottle(float t) { m_throttle = std::clamp(t, 0.0f, 1.0f); }
+    void setThrottle(float t) { m_throttle = m_throttleTarget = std::clamp(t, 0.0f, 1.0f); m_throttleRampFrames = 0; }
+    // Rampe linéaire vers t sur frames samples, appliquée par bloc
+    void rampThrottle(float t, int frames);
+    void seedNoise(uint32_t seed);
     float process(float sampleRate);
+    // Ajoute numFrames samples à output ; même calcul que process, invariants sortis de la boucle
+    void processBlock(float* output, int numFrames, float sampleRate);
     bool isActive() const { return m_active || m_amplitude > 0.001f; }
+    
+    // Gain de sortie (distance, vol de voix) en rampe linéaire par sample : pas de clic
+    void rampGain(float gain, int frames);
+    bool isFadedOut() const { return m_gainTarget <= 0.0f && m_gainRampFrames == 0; }
+    // Niveau de sortie approché, pour choisir la voix à voler
+    float getLevel() const { return m_amplitude * (0.3f + m_throttle * 0.7f) * m_gain; }
 
 private:
     BlockSoundProfile m_profile;
@@ -81,15 +131,53 @@ private:
     
     // État
     float m_throttle = 0.0f;
+    float m_throttleTarget = 0.0f;
+    float m_throttleStep = 0.0f;
+    int m_throttleRampFrames = 0;
+    float m_gain = 1.0f;
+    float m_gainTarget = 1.0f;
+    float m_gainStep = 0.0f;
+    int m_gainRampFrames = 0;
+    uint32_t m_noiseState = 0x9E3779B9u;
     float m_time = 0.0f;
+
+    void advanceThrottle(int frames);
+};
+
+// Commande du thread de jeu vers le thread audio ; frame = date de rendu (0 : dès que possible).
+// Les non datés s'appliquent au bloc suivant dans l'ordre d'envoi ; les datés attendent leur frame
+// côté audio sans retenir les autres, dans l'ordre d'envoi à frame égale.
+struct VoiceEvent
+{
+    enum class Type : uint8_t
+    {
+        Profile,        // (ré)initialise la voix avec profile
+        NoteOn,         // value = vélocité
+        NoteOff,
+        Throttle,       // value = cible, rampSeconds = durée de la rampe
+        Distance,       // value = distance à l'auditeur
+        Remove,         // libère la source
+        MasterVolume,   // value
+    };
+
+    Type type = Type::NoteOn;
+    int voiceId = -1;               // -1 : toutes les voix (Throttle)
+    uint64_t frame = 0;
+    float value = 0.0f;
+    float rampSeconds = 0.0f;
+    BlockSoundProfile profile;
 };
 
 class ReverbEffect {
 public:
     void init(float sampleRate, float roomSize = 0.8f);
     float process(float input);
+    // En place, vectorisé par portées contiguës ; le mix suit setMix en rampe sur un bloc
+    void processBlock(float* buffer, int numFrames);
     void setMix(float mix) { m_mix = mix; }
 
+    static constexpr int kBlockSize = 128;
+
 private:
     static constexpr int kNumCombs = 8;
     static constexpr int kNumAllpass = 4;
@@ -100,6 +188,7 @@ private:
     int m_allpassIndex[kNumAllpass] = {0};
     float m_combFeedback[kNumCombs] = {0};
     float m_mix = 0.3f;
+    float m_mixSmoothed = 0.3f;
 };
 
 class DelayEffect
@@ -107,6 +196,7 @@ class DelayEffect
 public:
     void init(float sampleRate, float maxDelay = 1.0f);
     float process(float input);
+    void processBlock(float* buffer, int numFrames);   // en place, comme ReverbEffect
     void setTime(float seconds);
     void setFeedback(float fb) { m_feedback = std::clamp(fb, 0.0f, 0.9f); }
     void setMix(float mix) { m_mix = mix; }
@@ -117,37 +207,122 @@ private:
     int m_delaySamples = 0;
     float m_feedback = 0.4f;
     float m_mix = 0.2f;
+    float m_mixSmoothed = 0.2f;
     float m_sampleRate = 44100.0f;
 };
 
+// Le thread de jeu (seul producteur) ne touche jamais aux voix : chaque appel pousse un
+// VoiceEvent, appliqué par le thread audio au sample près. Le rendu ne verrouille ni n'alloue.
 class SpaceshipSynthesizer
 {
 public:
+    static constexpr int kMaxVoices = 4096;         // sources demandées par le jeu (ids de voix)
+    static constexpr int kPoolSize = 48;            // voix réellement rendues
+    static constexpr size_t kEventCapacity = kMaxVoices;    // une commande par source entre deux blocs
+    static constexpr size_t kScheduledCapacity = 256;       // événements datés en attente côté audio
+
+    SpaceshipSynthesizer();
     void init(float sampleRate = 44100.0f);
     
-    // Gestion des blocs/voix
+    // Gestion des blocs/voix (thread de jeu) ; addVoice renvoie -1 si la table ou la ring est pleine.
+    // Un id est une source : elle n'occupe une voix du pool que tant qu'elle est parmi les plus audibles.
     int addVoice(const BlockSoundProfile& profile);
     void removeVoice(int voiceId);
     void setVoiceThrottle(int voiceId, float throttle);
+    void rampVoiceThrottle(int voiceId, float throttle, float seconds, uint64_t atFrame = 0);
     void setVoiceProfile(int voiceId, const BlockSoundProfile& profile);
-    void triggerVoice(int voiceId, float velocity = 1.0f);
-    void releaseVoice(int voiceId);
+    void triggerVoice(int voiceId, float velocity = 1.0f, uint64_t atFrame = 0);
+    void releaseVoice(int voiceId, uint64_t atFrame = 0);
+    // Atténuation en kReferenceDistance / distance ; au-delà de kMaxDistance la source est coupée
+    void setVoiceDistance(int voiceId, float distance);
+    // Ring pleine : NoteOff et Remove attendent côté jeu et repartent en tête au prochain envoi
+    // (rien ne les double), les autres sont perdus et postEvent renvoie false
+    bool postEvent(const VoiceEvent& event);
+    // Renvoie les NoteOff/Remove en attente ; false s'il en reste. À appeler par frame si rien d'autre n'est envoyé
+    bool flushEvents();
     
     // Master
-    void setMasterVolume(float vol) { m_masterVolume = vol; }
+    void setMasterVolume(float vol);
     void setMasterThrottle(float t);
     
+    // Horloge du thread audio, pour dater les événements ; events perdus si la ring était pleine
+    uint64_t getRenderedFrames() const { return m_renderedFrames.load(std::memory_order_acquire); }
+    uint32_t getDroppedEvents() const { return m_droppedEvents.load(std::memory_order_relaxed); }
+    size_t getPendingReleases() const { return m_pendingReleases.size(); }     // thread de jeu
+    // Voix du pool rendues au dernier bloc
+    int getRenderedVoiceCount() const { return m_renderedVoices.load(std::memory_order_relaxed); }
+    
+    // Graine du bruit des voix démarrées ensuite : même graine + mêmes événements datés = même rendu
+    void setSeed(uint32_t seed) { m_seed.store(seed, std::memory_order_relaxed); }
+    
     // Rendu audio - appeler depuis le callback audio
     void renderBuffer(float* output, int numFrames, int numChannels = 2);
+    // Mono, par blocs de kBlockSize : voix sommées puis delay et reverb sur tout le bloc
+    void renderMono(float* output, int numFrames);
     
     // Pour obtenir les samples (si pas de callback direct)
     float processSample();
 
+    static constexpr int kBlockSize = 128;
+    static constexpr float kReferenceDistance = 5.0f;
+    static constexpr float kMaxDistance = 150.0f;
+
 private:
+    // Source côté audio : l'état demandé, rendu ou non selon la place dans le pool
+    struct VoiceSource
+    {
+        BlockSoundProfile profile;
+        float velocity = 1.0f;
+        float throttle = 0.0f;
+        float gain = 1.0f;              // atténuation de distance
+        bool used = false;
+        bool playing = false;
+        bool pending = false;           // attend une voix en cours de fondu
+        int slot = -1;                  // voix du pool, ou -1 si virtuelle
+    };
+
+    struct PoolSlot
+    {
+        int source = -1;
+        int pendingSource = -1;         // prend la voix une fois le fondu de vol terminé
+        uint64_t startFrame = 0;
+    };
+
+    static constexpr int kStealFadeFrames = 96;     // ~2 ms
+    static constexpr float kAudibleLevel = 1e-3f;
+
+    void renderBlock(float* output, int numFrames);
+    int applyEvents(int maxFrames);
+    void scheduleEvent(const VoiceEvent& event);
+    void applyEvent(const VoiceEvent& event);
+    void scheduleVoices();
+    void startSlot(int slot, int source);
+    void releaseSlot(int slot);
+    float sourceLoudness(const VoiceSource& source) const { return source.velocity * source.gain * (0.3f + source.throttle * 0.7f); }
+
     float m_sampleRate = 44100.0f;
     float m_masterVolume = 0.7f;
+    float m_block[kBlockSize] = {0};
     
-    std::vector<std::unique_ptr<SpaceVoice>> m_voices;
+    // Thread audio, tout est alloué à la construction
+    std::vector<VoiceSource> m_sources;     // kMaxVoices
+    int m_sourceCount = 0;                  // plus haut id utilisé + 1
+    std::vector<SpaceVoice> m_pool;         // kPoolSize
+    std::vector<PoolSlot> m_slots;
+    std::vector<int> m_candidates;          // scratch de scheduleVoices
+    std::vector<VoiceEvent> m_scheduled;    // kScheduledCapacity, frame décroissante : le prochain au bout
+    uint64_t m_frame = 0;
+    std::atomic<uint64_t> m_renderedFrames{0};
+    std::atomic<int> m_renderedVoices{0};
+    std::atomic<uint32_t> m_seed{42};
+
+    // Thread de jeu
+    int m_allocatedVoices = 0;
+    std::vector<int> m_freeVoiceIds;
+    std::vector<VoiceEvent> m_pendingReleases;  // au plus un par source, dans l'ordre d'envoi
+    std::atomic<uint32_t> m_droppedEvents{0};
+
+    SPSCQueue<VoiceEvent, kEventCapacity> m_events;
     ReverbEffect m_reverb;
     DelayEffect m_delay;
 };
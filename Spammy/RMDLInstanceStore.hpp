@@ -0,0 +1,228 @@
+//
+//  RMDLInstanceStore.hpp
+//  Spammy
+//
+//  Created by Rémy on 17/10/2026.
+//
+
+#ifndef RMDLInstanceStore_hpp
+#define RMDLInstanceStore_hpp
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <unordered_map>
+#include <vector>
+
+// Store d'instances persistant pour un buffer GPU unifié, sans Metal : image CPU indexée par slot
+// et un bitset de slots modifiés par buffer (BufferCount en rotation). Chaque Key possède une plage
+// [offset, offset + capacity) remplie sur [offset, offset + count) pour un seul draw ; une instance
+// garde son slot tant qu'elle vit (un retrait comble le trou avec la dernière de la plage).
+// Plage pleine : relayout. Le dernier slot est réservé (ghost) : jamais attribué ni recopié.
+template<typename Key, typename Instance, uint32_t Capacity, uint32_t BufferCount>
+class InstanceStore
+{
+public:
+    static constexpr uint32_t kReservedSlot = Capacity - 1;
+
+    struct Range
+    {
+        uint32_t offset = 0;
+        uint32_t capacity = 0;
+        uint32_t count = 0;
+    };
+
+    InstanceStore()
+    : m_instances(Capacity), m_slotOwners(Capacity, 0)
+    {
+    }
+
+    // Ajoute ou met à jour id dans la plage de key ; false si le buffer est plein. Un changement
+    // de key libère d'abord l'ancien slot : il trouve toujours sa place
+    bool set(uint32_t id, Key key, const Instance& instance)
+    {
+        Range& range = m_ranges[key];
+        auto slotIt = m_slots.find(id);
+        bool present = slotIt != m_slots.end();
+        if (present && slotIt->second - range.offset < range.count)
+        {
+            m_instances[slotIt->second] = instance;
+            markDirty(slotIt->second, 1);
+            return true;
+        }
+
+        if (present)
+            remove(id);
+        if (range.count == range.capacity && !relayout(key))
+            return false;
+
+        uint32_t slot = range.offset + range.count++;
+        m_slots[id] = slot;
+        m_slotOwners[slot] = id;
+        m_instances[slot] = instance;
+        markDirty(slot, 1);
+        m_count++;
+        m_rangesChanged = true;
+        return true;
+    }
+
+    bool remove(uint32_t id)
+    {
+        auto slotIt = m_slots.find(id);
+        if (slotIt == m_slots.end())
+            return false;
+        uint32_t slot = slotIt->second;
+        m_slots.erase(slotIt);
+
+        for (auto& [key, range] : m_ranges)
+        {
+            if (slot - range.offset >= range.count)
+                continue;
+
+            // La dernière de la plage comble le trou : la plage reste contiguë, un seul slot à renvoyer
+            uint32_t last = range.offset + --range.count;
+            if (slot != last)
+            {
+                m_instances[slot] = m_instances[last];
+                m_slotOwners[slot] = m_slotOwners[last];
+                m_slots[m_slotOwners[slot]] = slot;
+                markDirty(slot, 1);
+            }
+            m_slotOwners[last] = 0;
+            break;
+        }
+        m_count--;
+        m_rangesChanged = true;
+        return true;
+    }
+
+    // Recopie dans dst, le contenu du buffer bufferIndex, les slots modifiés depuis son dernier passage
+    void upload(uint32_t bufferIndex, Instance* dst)
+    {
+        if (!m_bufferDirty[bufferIndex])
+            return;
+
+        uint64_t* words = m_dirtySlots[bufferIndex];
+
+        // Une copie par suite de bits à 1
+        uint32_t slot = 0;
+        while (slot < Capacity)
+        {
+            uint64_t dirty = words[slot >> 6] >> (slot & 63);
+            if (dirty == 0)
+            {
+                slot = (slot | 63) + 1;
+                continue;
+            }
+            slot += __builtin_ctzll(dirty);
+
+            uint32_t first = slot;
+            while (slot < Capacity)
+            {
+                uint64_t clean = ~(words[slot >> 6] >> (slot & 63));
+                // Les bits décalés hors du mot valent 1 dans clean : la suite s'arrête au plus tard en fin de mot
+                uint32_t run = clean ? (uint32_t)__builtin_ctzll(clean) : 64;
+                run = std::min(run, 64 - (slot & 63));
+                slot += run;
+                if (run == 0 || (slot & 63) != 0)
+                    break;
+            }
+            memcpy(dst + first, m_instances.data() + first, (slot - first) * sizeof(Instance));
+        }
+
+        memset(words, 0, sizeof(m_dirtySlots[bufferIndex]));
+        m_bufferDirty[bufferIndex] = false;
+    }
+
+    // true une seule fois après chaque changement de plages (ajout, retrait, relayout)
+    bool takeRangesChanged()
+    {
+        bool changed = m_rangesChanged;
+        m_rangesChanged = false;
+        return changed;
+    }
+
+    const std::unordered_map<Key, Range>& ranges() const { return m_ranges; }
+    uint32_t count() const { return m_count; }
+
+    int32_t slotOf(uint32_t id) const
+    {
+        auto slotIt = m_slots.find(id);
+        return slotIt != m_slots.end() ? (int32_t)slotIt->second : -1;
+    }
+
+private:
+    static_assert(Capacity % 64 == 0, "un mot de bitset par groupe de 64 slots");
+    static constexpr uint32_t kDirtyWords = Capacity / 64;
+
+    bool relayout(Key growingKey)
+    {
+        // Capacités doublées pour amortir ; si le buffer ne suffit pas, plages au plus juste
+        // et tout le reste à la plage qui grandit
+        uint32_t needed = 0;
+        uint32_t wanted = 0;
+        for (const auto& [key, range] : m_ranges)
+        {
+            uint32_t count = range.count + (key == growingKey ? 1 : 0);
+            needed += count;
+            wanted += std::max<uint32_t>(16, count * 2);
+        }
+        if (needed > kReservedSlot)
+            return false;
+        bool tight = wanted > kReservedSlot;
+
+        std::vector<Instance> instances(Capacity);
+        std::vector<uint32_t> owners(Capacity, 0);
+
+        uint32_t offset = 0;
+        for (auto& [key, range] : m_ranges)
+        {
+            uint32_t count = range.count + (key == growingKey ? 1 : 0);
+            uint32_t capacity = std::max<uint32_t>(16, count * 2);
+            if (tight)
+                capacity = key == growingKey ? count + (kReservedSlot - needed) : count;
+
+            std::copy_n(m_instances.begin() + range.offset, range.count, instances.begin() + offset);
+            for (uint32_t i = 0; i < range.count; i++)
+            {
+                uint32_t id = m_slotOwners[range.offset + i];
+                owners[offset + i] = id;
+                m_slots[id] = offset + i;
+            }
+            range.offset = offset;
+            range.capacity = capacity;
+            offset += capacity;
+        }
+
+        m_instances.swap(instances);
+        m_slotOwners.swap(owners);
+        markDirty(0, offset);
+        m_rangesChanged = true;
+        return true;
+    }
+
+    void markDirty(uint32_t first, uint32_t count)
+    {
+        if (count == 0)
+            return;
+        for (uint32_t b = 0; b < BufferCount; b++)
+        {
+            for (uint32_t slot = first; slot < first + count; slot++)
+                m_dirtySlots[b][slot >> 6] |= 1ull << (slot & 63);
+            m_bufferDirty[b] = true;
+        }
+    }
+
+    std::unordered_map<Key, Range> m_ranges;
+    std::unordered_map<uint32_t, uint32_t> m_slots;     // id -> slot
+    std::vector<Instance> m_instances;                  // image CPU des buffers, indexée par slot
+    std::vector<uint32_t> m_slotOwners;                 // slot -> id
+    uint32_t m_count = 0;
+
+    // Un bitset de slots modifiés par buffer : chacun rattrape ce qu'il a manqué quand vient son tour
+    uint64_t m_dirtySlots[BufferCount][kDirtyWords] = {};
+    bool m_bufferDirty[BufferCount] = {};
+    bool m_rangesChanged = false;
+};
+
+#endif /* RMDLInstanceStore_hpp */
@@ -50,6 +50,7 @@ struct RMDLUniforms
     simd::float3        sunColor;
 };
 
+// Orienté vers l'intérieur du frustum : p est dedans si dot(normal, p) + distance >= 0
 struct Plane
 {
     simd::float3        normal = { 0.f, 1.f, 0.f };
@@ -189,6 +189,8 @@ void Vehicle::initialize()
     inputSteering = 0.f;
     inputBrake = 0.f;
     isGrounded = false;
+    previousPosition = renderPosition = position;
+    previousRotation = renderRotation = rotationMatrix;
     
     commander = std::make_unique<CommanderBlock>(0);
     recalculateMass();
@@ -235,6 +237,9 @@ void Vehicle::updatePhysics(float dt)
 {
     if (!commander) return;
     
+    previousPosition = position;
+    previousRotation = rotationMatrix;
+    
     // Update energy
     commander->currentEnergy -= 1.f * dt;
     if (commander->currentEnergy < 0.f) commander->currentEnergy = 0.f;
@@ -306,6 +311,13 @@ void Vehicle::updatePhysics(float dt)
     }
 }
 
+void Vehicle::interpolate(float alpha)
+{
+    renderPosition = simd_mix(previousPosition, position, simd_make_float3(alpha));
+    simd_quatf rotation = simd_slerp(simd_quaternion(previousRotation), simd_quaternion(rotationMatrix), alpha);
+    renderRotation = simd_matrix4x4(rotation);
+}
+
 bool Vehicle::attachBlock(std::unique_ptr<BlockInstance> block, uint32_t parentID,
                           AttachFace parentFace, AttachFace childFace)
 {
@@ -392,14 +404,14 @@ bool Vehicle::detachBlock(uint32_t blockID)
 
 simd::float3 Vehicle::getCameraPosition() const
 {
-    if (!commander) return {position.x, position.y + 8.f, position.z - 12.f};
-    return commander->computeCameraPosition(position, rotationMatrix);
+    if (!commander) return {renderPosition.x, renderPosition.y + 8.f, renderPosition.z - 12.f};
+    return commander->computeCameraPosition(renderPosition, renderRotation);
 }
 
 simd::float3 Vehicle::getCameraTarget() const
 {
-    if (!commander) return position;
-    return commander->computeCameraTarget(position);
+    if (!commander) return renderPosition;
+    return commander->computeCameraTarget(renderPosition);
 }
 
 void Vehicle::orbitCamera(float dYaw, float dPitch)
@@ -826,7 +838,7 @@ void VehicleRenderer::render(MTL::RenderCommandEncoder* enc, Vehicle& vehicle, B
     // Commander
     const BlockDefinition* cmdDef = registry.getDefinition(0);
     BlockGPUInstance ci;
-    ci.modelMatrix = vehicle.commander->computeWorldMatrix(vehicle.position, vehicle.rotationMatrix);
+    ci.modelMatrix = vehicle.commander->computeWorldMatrix(vehicle.renderPosition, vehicle.renderRotation);
     ci.tint = cmdDef ? cmdDef->baseColor : simd::float4{0.3f, 0.5f, 0.8f, 1.f};
     ci.typeID = 0;
     ci.state = 0;
@@ -839,7 +851,7 @@ void VehicleRenderer::render(MTL::RenderCommandEncoder* enc, Vehicle& vehicle, B
         
         const BlockDefinition* def = registry.getDefinition(blk->definitionID);
         BlockGPUInstance bi;
-        bi.modelMatrix = blk->computeWorldMatrix(vehicle.position, vehicle.rotationMatrix);
+        bi.modelMatrix = blk->computeWorldMatrix(vehicle.renderPosition, vehicle.renderRotation);
         bi.tint = def ? def->baseColor : simd::float4{0.5f, 0.5f, 0.5f, 1.f};
         bi.typeID = blk->definitionID;
         bi.state = 0;
@@ -863,11 +875,11 @@ void VehicleRenderer::render(MTL::RenderCommandEncoder* enc, Vehicle& vehicle, B
     
     // Ghost block
     if (m_ghostPipeline && drag.mode == BuildDragDrop::Mode::Placing) {
-        simd::float4 ghostPos4 = simd_mul(vehicle.rotationMatrix, simd::float4{drag.ghostLocalPos.x, drag.ghostLocalPos.y, drag.ghostLocalPos.z, 1.f});
-        simd::float3 gWorld = {vehicle.position.x + ghostPos4.x, vehicle.position.y + ghostPos4.y, vehicle.position.z + ghostPos4.z};
+        simd::float4 ghostPos4 = simd_mul(vehicle.renderRotation, simd::float4{drag.ghostLocalPos.x, drag.ghostLocalPos.y, drag.ghostLocalPos.z, 1.f});
+        simd::float3 gWorld = {vehicle.renderPosition.x + ghostPos4.x, vehicle.renderPosition.y + ghostPos4.y, vehicle.renderPosition.z + ghostPos4.z};
         
         BlockGPUInstance gi;
-        gi.modelMatrix = simd_mul(math::makeTranslate(gWorld), simd_mul(vehicle.rotationMatrix, drag.ghostRotation));
+        gi.modelMatrix = simd_mul(math::makeTranslate(gWorld), simd_mul(vehicle.renderRotation, drag.ghostRotation));
         gi.tint = drag.validPlacement ? simd::float4{0.3f, 0.9f, 0.3f, 0.6f} : simd::float4{0.9f, 0.3f, 0.3f, 0.6f};
         gi.typeID = drag.draggedDefID;
         gi.state = 1;
@@ -958,6 +970,13 @@ void VehicleManager::update(float dt)
     }
 }
 
+void VehicleManager::interpolate(float alpha)
+{
+    if (m_vehicle) {
+        m_vehicle->interpolate(alpha);
+    }
+}
+
 void VehicleManager::render(MTL::RenderCommandEncoder* enc, simd::float4x4 vpMatrix, simd::float3 camPos)
 {
     if (!m_initialized || !m_vehicle || !m_vehicleRenderer) return;
@@ -199,6 +199,13 @@ public:
     float totalMass;
     simd::float3 centerOfMass;
     
+    // État au début du dernier pas fixe, et transform affiché, interpolé entre les deux
+    // (caméra et rendu) : la physique avance par pas fixes, l'affichage à chaque frame
+    simd::float3 previousPosition;
+    simd::float4x4 previousRotation;
+    simd::float3 renderPosition;
+    simd::float4x4 renderRotation;
+    
     // Inputs
     float inputThrottle;
     float inputSteering;
@@ -210,6 +217,8 @@ public:
     
     void initialize();
     void updatePhysics(float dt);
+    // alpha = SimulationClock::alpha(), fraction de pas écoulée depuis le dernier updatePhysics
+    void interpolate(float alpha);
     void recalculateMass();
     
     bool attachBlock(std::unique_ptr<BlockInstance> block, uint32_t parentID,
@@ -366,6 +375,7 @@ public:
     void cleanup();
     
     void update(float dt);
+    void interpolate(float alpha);
     void render(MTL::RenderCommandEncoder* renderCommandEncoder, simd::float4x4 viewProjectionMatrix, simd::float3 cameraPosition);
     void renderUI(MTL::RenderCommandEncoder* enc, simd::float2 screenSize);
     
@@ -0,0 +1,360 @@
+//
+//  RMDLModelCache.cpp
+//  Spammy
+//
+//  Created by Rémy on 17/10/2026.
+//
+
+#ifdef RMDL_MODEL_CACHE_TOOL
+#define NS_PRIVATE_IMPLEMENTATION
+#define CA_PRIVATE_IMPLEMENTATION
+#define MTL_PRIVATE_IMPLEMENTATION
+#define MTK_PRIVATE_IMPLEMENTATION
+#define STB_IMAGE_IMPLEMENTATION
+#endif
+
+#include "RMDLModelCache.hpp"
+
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace modelcache
+{
+
+uint64_t hashFile(const std::string& path)
+{
+    MappedFile file;
+    if (!file.open(path))
+        return 0;
+
+    uint64_t hash = 1469598103934665603ull;
+    for (size_t i = 0; i < file.size(); i++)
+    {
+        hash ^= file.data()[i];
+        hash *= 1099511628211ull;
+    }
+    return hash ? hash : 1;
+}
+
+static int64_t modificationTime(const struct stat& st)
+{
+#ifdef __APPLE__
+    const struct timespec& modified = st.st_mtimespec;
+#else
+    const struct timespec& modified = st.st_mtim;
+#endif
+    return (int64_t)modified.tv_sec * 1000000000 + modified.tv_nsec;
+}
+
+Dependency stampFile(const std::string& path)
+{
+    Dependency stamp;
+    stamp.path = path;
+    struct stat st;
+    if (stat(path.c_str(), &st) != 0)
+        return stamp;
+    stamp.size = (uint64_t)st.st_size;
+    stamp.mtime = modificationTime(st);
+    stamp.hash = hashFile(path);
+    return stamp;
+}
+
+bool isUnchanged(const Dependency& stamp)
+{
+    struct stat st;
+    if (stat(stamp.path.c_str(), &st) != 0)
+        return stamp.hash == 0;
+    if (stamp.hash == 0 || (uint64_t)st.st_size != stamp.size)
+        return false;
+    if (modificationTime(st) == stamp.mtime)
+        return true;
+    return hashFile(stamp.path) == stamp.hash;
+}
+
+std::string cachePathFor(const std::string& sourcePath)
+{
+    return sourcePath + ".rmdlcache";
+}
+
+std::string directoryOf(const std::string& path)
+{
+    size_t slash = path.find_last_of('/');
+    return slash == std::string::npos ? std::string() : path.substr(0, slash + 1);
+}
+
+MappedFile::~MappedFile()
+{
+    close();
+}
+
+bool MappedFile::open(const std::string& path)
+{
+    close();
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+        return false;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size == 0)
+    {
+        ::close(fd);
+        return false;
+    }
+
+    void* mapped = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapped == MAP_FAILED)
+        return false;
+
+    m_data = static_cast<const uint8_t*>(mapped);
+    m_size = (size_t)st.st_size;
+    return true;
+}
+
+void MappedFile::close()
+{
+    if (m_data)
+        munmap(const_cast<uint8_t*>(m_data), m_size);
+    m_data = nullptr;
+    m_size = 0;
+}
+
+bool Reader::open(const std::string& path)
+{
+    // Nouveau mapping à chaque ouverture : l'ancien reste valide pour les modèles qui le gardent
+    m_header = nullptr;
+    m_file = std::make_shared<MappedFile>();
+    if (!m_file->open(path) || m_file->size() < sizeof(FileHeader))
+        return false;
+
+    const FileHeader* header = reinterpret_cast<const FileHeader*>(m_file->data());
+    if (header->magic != MAGIC || header->version != VERSION ||
+        header->vertexStride != sizeof(VertexBlenderFull) || header->keyStride != sizeof(KeyFrame<simd::float3>))
+        return false;
+
+    for (const Section& s : header->sections)
+    {
+        if (s.offset % SECTION_ALIGNMENT != 0 || s.offset > m_file->size() || s.size > m_file->size() - s.offset)
+            return false;
+    }
+    m_header = header;
+    return true;
+}
+
+std::vector<Dependency> Reader::dependencies() const
+{
+    std::vector<Dependency> dependencies;
+    Span<DependencyRecord> records = section<DependencyRecord>(SectionType::Dependencies);
+    for (size_t i = 0; i < records.count; i++)
+        dependencies.push_back({ name(records[i].path), records[i].size, records[i].mtime, records[i].hash });
+    return dependencies;
+}
+
+std::string Reader::name(NameRef ref) const
+{
+    Span<char> strings = section<char>(SectionType::Strings);
+    if (!strings.contains(ref.offset, ref.length))
+        return {};
+    return std::string(strings.data + ref.offset, ref.length);
+}
+
+// Accumule les sections dans un seul buffer avant l'écriture
+class Writer
+{
+public:
+    Writer() : m_bytes(sizeof(FileHeader), 0) {}
+
+    FileHeader& header() { return *reinterpret_cast<FileHeader*>(m_bytes.data()); }
+
+    template<typename T>
+    void addSection(SectionType type, const T* data, size_t count)
+    {
+        size_t offset = (m_bytes.size() + SECTION_ALIGNMENT - 1) & ~(SECTION_ALIGNMENT - 1);
+        size_t size = count * sizeof(T);
+        m_bytes.resize(offset + size, 0);
+        if (size)
+            memcpy(m_bytes.data() + offset, data, size);
+        header().sections[(size_t)type] = { offset, size };
+    }
+
+    template<typename T>
+    void addSection(SectionType type, const std::vector<T>& data)
+    {
+        addSection(type, data.data(), data.size());
+    }
+
+    NameRef addName(const std::string& name)
+    {
+        NameRef ref = { (uint32_t)m_strings.size(), (uint32_t)name.size() };
+        m_strings.insert(m_strings.end(), name.begin(), name.end());
+        return ref;
+    }
+
+    const std::vector<char>& strings() const { return m_strings; }
+    const std::vector<uint8_t>& bytes() const { return m_bytes; }
+
+private:
+    std::vector<uint8_t>    m_bytes;
+    std::vector<char>       m_strings;
+};
+
+bool write(const std::string& path, const std::vector<Dependency>& dependencies, const Blender& model, const std::vector<TextureBlob>& textures)
+{
+    Writer writer;
+    const Skeleton& skeleton = model.skeleton;
+
+    std::vector<DependencyRecord> dependencyRecords;
+    for (const Dependency& dependency : dependencies)
+        dependencyRecords.push_back({ writer.addName(dependency.path), dependency.size, dependency.mtime, dependency.hash });
+
+    std::vector<NameRef> nodeNames;
+    for (const auto& name : skeleton.names)
+        nodeNames.push_back(writer.addName(name));
+
+    std::vector<simd::float4x4> boneOffsets(model.boneCount, matrix_identity_float4x4);
+    std::vector<NameRef> boneNames(model.boneCount, NameRef{ 0, 0 });
+    for (const auto& bone : model.boneMap)
+    {
+        boneOffsets[bone.second.id] = bone.second.offset;
+        boneNames[bone.second.id] = writer.addName(bone.first);
+    }
+
+    std::vector<ClipRecord> clips;
+    std::vector<ChannelRecord> channels;
+    std::vector<int32_t> nodeChannels;
+    std::vector<KeyFrame<simd::float3>> positions;
+    std::vector<KeyFrame<simd::quatf>> rotations;
+    std::vector<KeyFrame<simd::float3>> scales;
+    std::vector<animcompression::CompressedChannel> compressedChannels;
+    std::vector<float> compressedTimes;
+    std::vector<uint16_t> compressedValues;
+
+    for (const auto& anim : model.animations)
+    {
+        bool compressed = !anim.compressed.empty();
+        clips.push_back({ writer.addName(anim.name), anim.duration, anim.ticksPerSec, (uint32_t)channels.size(), (uint32_t)anim.channels.size(),
+                          compressed ? 1u : 0u, (uint32_t)compressedTimes.size(), (uint32_t)anim.compressed.times.size() });
+        nodeChannels.insert(nodeChannels.end(), anim.nodeChannels.begin(), anim.nodeChannels.end());
+
+        if (compressed)
+        {
+            compressedChannels.insert(compressedChannels.end(), anim.compressed.channels.begin(), anim.compressed.channels.end());
+            compressedTimes.insert(compressedTimes.end(), anim.compressed.times.begin(), anim.compressed.times.end());
+            compressedValues.insert(compressedValues.end(), anim.compressed.values.begin(), anim.compressed.values.end());
+        }
+        else
+            compressedChannels.resize(compressedChannels.size() + anim.channels.size());
+
+        for (const auto& ch : anim.channels)
+        {
+            channels.push_back({ writer.addName(ch.boneName),
+                                 (uint32_t)positions.size(), (uint32_t)ch.positions.size(),
+                                 (uint32_t)rotations.size(), (uint32_t)ch.rotations.size(),
+                                 (uint32_t)scales.size(), (uint32_t)ch.scales.size() });
+            positions.insert(positions.end(), ch.positions.begin(), ch.positions.end());
+            rotations.insert(rotations.end(), ch.rotations.begin(), ch.rotations.end());
+            scales.insert(scales.end(), ch.scales.begin(), ch.scales.end());
+        }
+    }
+
+    std::vector<TextureRecord> textureRecords;
+    std::vector<uint8_t> pixels;
+    for (const auto& tex : textures)
+    {
+        textureRecords.push_back({ tex.slot, tex.width, tex.height, tex.sRGB ? 1u : 0u, pixels.size() });
+        pixels.insert(pixels.end(), tex.pixels.begin(), tex.pixels.end());
+    }
+
+    writer.addSection(SectionType::Vertices, model.verticesFull);
+    writer.addSection(SectionType::Indices, model.indices);
+    writer.addSection(SectionType::NodeParents, skeleton.parents);
+    writer.addSection(SectionType::NodeLocalBind, skeleton.localBind);
+    writer.addSection(SectionType::NodeBones, skeleton.nodeBones);
+    writer.addSection(SectionType::NodeNames, nodeNames);
+    writer.addSection(SectionType::BoneOffsets, boneOffsets);
+    writer.addSection(SectionType::BoneNames, boneNames);
+    writer.addSection(SectionType::Clips, clips);
+    writer.addSection(SectionType::Channels, channels);
+    writer.addSection(SectionType::NodeChannels, nodeChannels);
+    writer.addSection(SectionType::PositionKeys, positions);
+    writer.addSection(SectionType::RotationKeys, rotations);
+    writer.addSection(SectionType::ScaleKeys, scales);
+    writer.addSection(SectionType::Textures, textureRecords);
+    writer.addSection(SectionType::Pixels, pixels);
+    writer.addSection(SectionType::CompressedChannels, compressedChannels);
+    writer.addSection(SectionType::CompressedTimes, compressedTimes);
+    writer.addSection(SectionType::CompressedValues, compressedValues);
+    writer.addSection(SectionType::Dependencies, dependencyRecords);
+    writer.addSection(SectionType::Strings, writer.strings());
+
+    FileHeader& header = writer.header();
+    header.magic = MAGIC;
+    header.version = VERSION;
+    header.vertexStride = sizeof(VertexBlenderFull);
+    header.keyStride = sizeof(KeyFrame<simd::float3>);
+
+    // Écrit à côté puis renomme : un lecteur ne voit jamais de cache à moitié écrit
+    std::string tmpPath = path + ".tmp";
+    FILE* file = fopen(tmpPath.c_str(), "wb");
+    if (!file)
+        return false;
+    bool ok = fwrite(writer.bytes().data(), 1, writer.bytes().size(), file) == writer.bytes().size();
+    ok = (fclose(file) == 0) && ok;
+    if (!ok || rename(tmpPath.c_str(), path.c_str()) != 0)
+    {
+        remove(tmpPath.c_str());
+        return false;
+    }
+    return true;
+}
+
+}
+
+#ifdef RMDL_MODEL_CACHE_TOOL
+// Convertisseur hors-ligne, hors cible Xcode. Depuis Spammy/ :
+// clang++ -std=gnu++17 -O2 -DRMDL_MODEL_CACHE_TOOL -I../include RMDLModelCache.cpp RMDLBlender.cpp RMDLAnimationCompression.cpp RMDLSkinning.cpp RMDLFrustumCulling.cpp \
+//     RMDLUtils.cpp RMDLMathUtils.cpp \
+//     -lassimp -framework Foundation -framework Metal -framework MetalKit -framework QuartzCore -o rmdl-bake
+// puis : ./rmdl-bake [--compress] vitesse.glb ...  (écrit vitesse.glb.rmdlcache à côté de chaque source)
+int main(int argc, char** argv)
+{
+    // Options d'abord : elles valent pour toutes les sources, quelle que soit leur place
+    bool compress = false;
+    std::vector<const char*> sources;
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--compress") == 0)
+            compress = true;
+        else
+            sources.push_back(argv[i]);
+    }
+    if (sources.empty())
+    {
+        fprintf(stderr, "usage: %s [--compress] model.glb [model.glb ...]\n", argv[0]);
+        return 1;
+    }
+
+    MTL::Device* device = MTL::CreateSystemDefaultDevice();
+    if (!device)
+    {
+        fprintf(stderr, "No Metal device\n");
+        return 1;
+    }
+
+    int failures = 0;
+    {
+        RMDLBlender blender(device);
+        for (const char* source : sources)
+        {
+            if (!blender.bakeModelCache(source, compress))
+                failures++;
+        }
+    }
+    device->release();
+    return failures ? 1 : 0;
+}
+#endif
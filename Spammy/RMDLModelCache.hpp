@@ -0,0 +1,213 @@
+//
+//  RMDLModelCache.hpp
+//  Spammy
+//
+//  Created by Rémy on 17/10/2026.
+//
+
+#ifndef RMDLModelCache_hpp
+#define RMDLModelCache_hpp
+
+#include <cstdint>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "RMDLBlender.hpp"
+
+// Cache binaire des modèles skinnés (vertex stream, skeleton, pistes de clés) pour ne plus
+// passer par assimp au lancement. Le fichier est mappé en mémoire et chaque section est
+// déjà dans la disposition des types runtime : le chargement ne fait que des copies en bloc.
+// Le cache reste valide tant que la source et ses textures externes n'ont pas changé (Dependencies).
+namespace modelcache
+{
+
+constexpr uint32_t MAGIC = 0x43444D52; // "RMDC"
+constexpr uint32_t VERSION = 3;
+constexpr uint64_t SECTION_ALIGNMENT = 64;
+
+enum class SectionType : uint32_t
+{
+    Vertices,       // VertexBlenderFull[vertexCount]
+    Indices,        // uint32_t[indexCount]
+    NodeParents,    // int32_t[nodeCount]
+    NodeLocalBind,  // simd::float4x4[nodeCount]
+    NodeBones,      // int32_t[nodeCount]
+    NodeNames,      // NameRef[nodeCount]
+    BoneOffsets,    // simd::float4x4[boneCount]
+    BoneNames,      // NameRef[boneCount]
+    Clips,          // ClipRecord[clipCount]
+    Channels,       // ChannelRecord[]
+    NodeChannels,   // int32_t[clipCount * nodeCount]
+    PositionKeys,   // KeyFrame<simd::float3>[]
+    RotationKeys,   // KeyFrame<simd::quatf>[]
+    ScaleKeys,      // KeyFrame<simd::float3>[]
+    Textures,       // TextureRecord[]
+    Pixels,         // RGBA8
+    Strings,        // char[]
+    CompressedChannels, // animcompression::CompressedChannel[], parallèle à Channels
+    CompressedTimes,    // float[]
+    CompressedValues,   // uint16_t[3 * clé]
+    Dependencies,       // DependencyRecord[] : la source puis ses textures externes
+    Count
+};
+
+struct Section
+{
+    uint64_t offset;
+    uint64_t size;      // en octets
+};
+
+struct FileHeader
+{
+    uint32_t magic;
+    uint32_t version;
+    uint32_t vertexStride;  // sizeof(VertexBlenderFull) à l'écriture
+    uint32_t keyStride;     // sizeof(KeyFrame<simd::float3>) à l'écriture
+    Section  sections[(size_t)SectionType::Count];
+};
+
+struct NameRef
+{
+    uint32_t offset;
+    uint32_t length;
+};
+
+struct ClipRecord
+{
+    NameRef  name;
+    float    duration;
+    float    ticksPerSec;
+    uint32_t firstChannel;
+    uint32_t channelCount;
+    uint32_t compressed;    // clés dans les sections Compressed* plutôt que *Keys
+    uint32_t firstKey;
+    uint32_t keyCount;
+};
+
+struct ChannelRecord
+{
+    NameRef  boneName;
+    uint32_t firstPosition, positionCount;
+    uint32_t firstRotation, rotationCount;
+    uint32_t firstScale, scaleCount;
+};
+
+enum TextureSlot : uint32_t
+{
+    TextureDiffuse,
+    TextureNormal,
+    TextureRoughness,
+    TextureMetallic,
+    TextureAmbientOcclusion,
+    TextureSlotCount
+};
+
+struct TextureRecord
+{
+    uint32_t slot;
+    uint32_t width;
+    uint32_t height;
+    uint32_t sRGB;
+    uint64_t pixelOffset;   // dans la section Pixels
+};
+
+// Chemin relatif au dossier de la source
+struct DependencyRecord
+{
+    NameRef  path;
+    uint64_t size;
+    int64_t  mtime;     // ns depuis l'epoch
+    uint64_t hash;      // 0 si le fichier n'existait pas au bake
+};
+
+struct Dependency
+{
+    std::string path;
+    uint64_t size = 0;
+    int64_t  mtime = 0;
+    uint64_t hash = 0;
+};
+
+struct TextureBlob
+{
+    TextureSlot slot;
+    uint32_t width;
+    uint32_t height;
+    bool sRGB;
+    std::vector<uint8_t> pixels;
+};
+
+// Vue typée sur une section du fichier mappé
+template<typename T>
+struct Span
+{
+    const T* data = nullptr;
+    size_t count = 0;
+
+    const T& operator[](size_t i) const { return data[i]; }
+    bool contains(uint64_t first, uint64_t n) const { return first + n <= count; }
+};
+
+// FNV-1a 64 bits du contenu du fichier source, 0 s'il est illisible
+uint64_t hashFile(const std::string& path);
+
+// Taille, date de modification et hash du fichier ; tout à 0 s'il n'existe pas
+Dependency stampFile(const std::string& path);
+
+// Même taille et même date : rien n'est relu. Seule la date a bougé (touch, checkout) :
+// on rehashe et on compare. Un fichier absent au bake doit l'être encore.
+bool isUnchanged(const Dependency& stamp);
+
+std::string cachePathFor(const std::string& sourcePath);
+// "dir/model.glb" -> "dir/", "" sans dossier
+std::string directoryOf(const std::string& path);
+
+class MappedFile
+{
+public:
+    MappedFile() = default;
+    ~MappedFile();
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool open(const std::string& path);
+    void close();
+    const uint8_t* data() const { return m_data; }
+    size_t size() const { return m_size; }
+
+private:
+    const uint8_t*  m_data = nullptr;
+    size_t          m_size = 0;
+};
+
+class Reader
+{
+public:
+    // Échoue si le fichier manque, est tronqué ou d'une autre version du format
+    bool open(const std::string& path);
+    // Chemins relatifs au dossier de la source
+    std::vector<Dependency> dependencies() const;
+
+    template<typename T>
+    Span<T> section(SectionType type) const
+    {
+        const Section& s = m_header->sections[(size_t)type];
+        return { reinterpret_cast<const T*>(m_file->data() + s.offset), (size_t)(s.size / sizeof(T)) };
+    }
+
+    std::string name(NameRef ref) const;
+    // À garder par qui pointe dans les sections après la fermeture du Reader
+    std::shared_ptr<const MappedFile> file() const { return m_file; }
+
+private:
+    std::shared_ptr<MappedFile> m_file;
+    const FileHeader*           m_header = nullptr;
+};
+
+bool write(const std::string& path, const std::vector<Dependency>& dependencies, const Blender& model, const std::vector<TextureBlob>& textures);
+
+}
+
+#endif /* RMDLModelCache_hpp */
@@ -8,6 +8,8 @@
 #include "RMDLMotherCube.hpp"
 
 #include <cmath>
+#include <cstring>
+#include <algorithm>
 #include <simd/simd.h>
 
 namespace cube {
@@ -194,8 +196,6 @@ BlockRenderer::BlockRenderer(MTL::Device* device, MTL::PixelFormat colorFormat,
         m_uniformBuffers[i] = device->newBuffer(sizeof(BlockUniforms), MTL::ResourceStorageModeShared);
     }
     
-    m_gpuInstances.reserve(kMaxInstances);
-    
     loadTextures(resourcesPath, commandQueue);
     buildMeshes();
 }
@@ -397,86 +397,55 @@ void BlockRenderer::buildMeshes()
     
     m_vertexBuffer = m_device->newBuffer(allVerts.data(), allVerts.size() * sizeof(BlockVertex), MTL::ResourceStorageModeShared);
     m_indexBuffer = m_device->newBuffer(allIndices.data(), allIndices.size() * sizeof(uint16_t), MTL::ResourceStorageModeShared);
-    
-    // Pre-allocate instance buffer (max 4096 blocks)
-    m_instanceBuffers[0] = m_device->newBuffer(4096 * sizeof(BlockGPUInstance), MTL::ResourceStorageModeShared);
-    m_instanceBuffers[1] = m_device->newBuffer(4096 * sizeof(BlockGPUInstance), MTL::ResourceStorageModeShared);
-    m_instanceBuffers[2] = m_device->newBuffer(4096 * sizeof(BlockGPUInstance), MTL::ResourceStorageModeShared);
 }
 
-void BlockRenderer::updateInstances(const std::vector<BlockInstance>& blocks, float time) {
-    m_gpuInstances.clear();
-    //    m_gpuInstances.reserve(blocks.size() + 1);
+BlockGPUInstance BlockRenderer::makeGPUInstance(const BlockInstance& block, uint32_t textureIndex) const
+{
+    BlockGPUInstance gpu;
+    gpu.modelMatrix = block.getModelMatrix();
+    gpu.color = block.tintColor;
+    // z : phase d'animation propre au bloc ; le temps passe par les uniforms pour qu'un bloc immobile reste propre
+    gpu.params = {block.damage, block.powered ? 1.0f : 0.0f, 0.0f, (float)textureIndex};
+    return gpu;
+}
+
+bool BlockRenderer::setInstance(const BlockInstance& block)
+{
+    auto meshIt = m_meshRanges.find(block.type);
+    if (meshIt == m_meshRanges.end()) return false;
+    return m_instances.set(block.id, block.type, makeGPUInstance(block, meshIt->second.textureIndex));
+}
+
+void BlockRenderer::removeInstance(uint32_t blockId)
+{
+    m_instances.remove(blockId);
+}
+
+void BlockRenderer::rebuildBatches()
+{
     m_opaqueBatches.clear();
     m_transparentBatches.clear();
     
-    std::unordered_map<BlockType, std::vector<uint32_t>> typeGroups;
-    
-    for (uint32_t i = 0; i < blocks.size(); i++) {
-        typeGroups[blocks[i].type].push_back(i);
-    }
-    
-    // Build batches
-    for (auto& [type, indices] : typeGroups) {
-        auto rangeIt = m_meshRanges.find(type);
-        if (rangeIt == m_meshRanges.end()) continue;
-        
-        const auto& range = rangeIt->second;
+    for (const auto& [type, range] : m_instances.ranges())
+    {
+        if (range.count == 0) continue;
         
         DrawBatch batch;
         batch.type = type;
-        batch.instanceOffset = (uint32_t)m_gpuInstances.size();
-        batch.instanceCount = (uint32_t)indices.size();
-        
-        for (uint32_t idx : indices) {
-            const auto& block = blocks[idx];
-            
-            BlockGPUInstance gpu;
-            gpu.modelMatrix = block.getModelMatrix();
-            gpu.color = block.tintColor;
-            gpu.params = {block.damage, block.powered ? 1.0f : 0.0f,
-                time, (float)range.textureIndex};
-            m_gpuInstances.push_back(gpu);
-        }
+        batch.instanceOffset = range.offset;
+        batch.instanceCount = range.count;
         
-        if (range.transparent) {
+        if (m_meshRanges[type].transparent) {
             m_transparentBatches.push_back(batch);
         } else {
             m_opaqueBatches.push_back(batch);
         }
     }
-    
-    // Ghost block
-    if (m_hasGhost) {
-        BlockInstance ghost;
-        ghost.gridPos = m_ghostPos;
-        ghost.rotation = m_ghostRot;
-        ghost.type = m_ghostType;
-        ghost.tintColor = {1, 1, 1, 0.5f};
-        
-        auto rangeIt = m_meshRanges.find(m_ghostType);
-        if (rangeIt != m_meshRanges.end()) {
-            DrawBatch batch;
-            batch.type = m_ghostType;
-            batch.instanceOffset = (uint32_t)m_gpuInstances.size();
-            batch.instanceCount = 1;
-            
-            BlockGPUInstance gpu;
-            gpu.modelMatrix = ghost.getModelMatrix();
-            gpu.color = ghost.tintColor;
-            gpu.params = {0, 0, time, (float)rangeIt->second.textureIndex};
-            m_gpuInstances.push_back(gpu);
-            
-            m_transparentBatches.push_back(batch);
-        }
-    }
-    
-    m_instanceCount = (uint32_t)m_gpuInstances.size();
 }
 
 void BlockRenderer::render(MTL::RenderCommandEncoder* enc, simd::float4x4 viewProj, simd::float3 camPos, float time)
 {
-    if (m_instanceCount == 0) return;
+    if (m_instances.count() == 0 && !m_hasGhost) return;
     m_bufferIndex = (m_bufferIndex + 1) % kBufferCount;
     
     BlockUniforms uniforms;
@@ -485,7 +454,31 @@ void BlockRenderer::render(MTL::RenderCommandEncoder* enc, simd::float4x4 viewPr
     uniforms.time = time;
     uniforms.lightDir = simd::normalize(simd::float3{0.5f, 1.0f, 0.3f});
     memcpy(m_uniformBuffers[m_bufferIndex]->contents(), &uniforms, sizeof(uniforms));
-    memcpy(m_instanceBuffers[m_bufferIndex]->contents(), m_gpuInstances.data(),  m_instanceCount * sizeof(BlockGPUInstance));
+    
+    // Seuls les slots modifiés depuis le dernier passage sur ce buffer sont recopiés
+    if (m_instances.takeRangesChanged()) rebuildBatches();
+    m_instances.upload(m_bufferIndex, (BlockGPUInstance*)m_instanceBuffers[m_bufferIndex]->contents());
+    
+    // Ghost block : hors du store, réécrit à chaque frame dans son slot réservé
+    const MeshRange* ghostRange = nullptr;
+    if (m_hasGhost)
+    {
+        auto rangeIt = m_meshRanges.find(m_ghostType);
+        if (rangeIt != m_meshRanges.end())
+        {
+            BlockInstance ghost;
+            ghost.gridPos = m_ghostPos;
+            ghost.rotation = m_ghostRot;
+            ghost.type = m_ghostType;
+            ghost.tintColor = {1, 1, 1, 0.5f};
+            ghost.damage = 0;
+            ghost.powered = false;
+            
+            auto* instances = (BlockGPUInstance*)m_instanceBuffers[m_bufferIndex]->contents();
+            instances[kGhostSlot] = makeGPUInstance(ghost, rangeIt->second.textureIndex);
+            ghostRange = &rangeIt->second;
+        }
+    }
     
     enc->setVertexBuffer(m_vertexBuffer, 0, 0);
     enc->setVertexBuffer(m_instanceBuffers[m_bufferIndex], 0, 1);
@@ -519,7 +512,7 @@ void BlockRenderer::render(MTL::RenderCommandEncoder* enc, simd::float4x4 viewPr
     }
     
     // === TRANSPARENT PASS ===
-    if (!m_transparentBatches.empty()) {
+    if (!m_transparentBatches.empty() || ghostRange) {
         enc->setRenderPipelineState(m_pipelineTransparent);
         enc->setDepthStencilState(m_depthStateTransparent);
         enc->setCullMode(MTL::CullModeNone);
@@ -538,6 +531,19 @@ void BlockRenderer::render(MTL::RenderCommandEncoder* enc, simd::float4x4 viewPr
                                        batch.instanceOffset
                                        );
         }
+        
+        if (ghostRange) {
+            enc->drawIndexedPrimitives(
+                                       MTL::PrimitiveTypeTriangle,
+                                       ghostRange->indexCount,
+                                       MTL::IndexTypeUInt16,
+                                       m_indexBuffer,
+                                       ghostRange->indexOffset * sizeof(uint16_t),
+                                       1,
+                                       0,
+                                       kGhostSlot
+                                       );
+        }
     }
 }
 
@@ -562,7 +568,6 @@ uint32_t BlockSystem::addBlock(BlockType type, simd::int3 pos, uint8_t rotation)
     if (!canPlaceAt(type, pos, rotation)) return 0;
     
     BlockInstance block;
-    block.id = m_nextId++;
     block.type = type;
     block.gridPos = pos;
     block.rotation = rotation;
@@ -571,20 +576,25 @@ uint32_t BlockSystem::addBlock(BlockType type, simd::int3 pos, uint8_t rotation)
     block.powered = true;
     block.active = true;
     
-    m_blocks.push_back(block);
-    m_gridMap[hashPos(pos)] = block.id;
+    BlockInstance* added = m_blocks.insert(block);
+    if (!added) return 0;
+    // Buffer d'instances plein : refusé comme une place occupée, plutôt qu'un bloc jamais dessiné
+    if (!m_renderer->setInstance(*added)) {
+        m_blocks.erase(added->id);
+        return 0;
+    }
+    m_gridMap[hashPos(pos)] = added->id;
     
-    return block.id;
+    return added->id;
 }
 
 bool BlockSystem::removeBlock(uint32_t id) {
-    auto it = std::find_if(m_blocks.begin(), m_blocks.end(),
-                           [id](const BlockInstance& b) { return b.id == id; });
-    if (it == m_blocks.end()) return false;
+    const BlockInstance* block = m_blocks.get(id);
+    if (!block) return false;
     
-    m_gridMap.erase(hashPos(it->gridPos));
-    m_blocks.erase(it);
-    return true;
+    m_gridMap.erase(hashPos(block->gridPos));
+    m_renderer->removeInstance(id);
+    return m_blocks.erase(id);
 }
 
 bool BlockSystem::removeBlockAt(simd::int3 pos) {
@@ -594,9 +604,7 @@ bool BlockSystem::removeBlockAt(simd::int3 pos) {
 }
 
 BlockInstance* BlockSystem::getBlock(uint32_t id) {
-    auto it = std::find_if(m_blocks.begin(), m_blocks.end(),
-                           [id](const BlockInstance& b) { return b.id == id; });
-    return it != m_blocks.end() ? &(*it) : nullptr;
+    return m_blocks.get(id);
 }
 
 BlockInstance* BlockSystem::getBlockAt(simd::int3 pos) {
@@ -632,18 +640,26 @@ bool BlockSystem::hasNeighbor(simd::int3 pos) const
 
 void BlockSystem::setBlockColor(uint32_t id, simd::float4 color)
 {
-    if (auto* block = getBlock(id)) block->tintColor = color;
+    if (auto* block = getBlock(id))
+    {
+        block->tintColor = color;
+        m_renderer->setInstance(*block);
+    }
+}
+
+void BlockSystem::markBlockDirty(uint32_t id)
+{
+    if (auto* block = getBlock(id)) m_renderer->setInstance(*block);
 }
 
 void BlockSystem::update(float delta)
 {
     m_time += delta;
-    m_renderer->updateInstances(m_blocks, m_time);
 }
 
-void BlockSystem::render(MTL::RenderCommandEncoder* enc, simd::float4x4 viewProj, simd::float3 camPos, float time)
+void BlockSystem::render(MTL::RenderCommandEncoder* enc, simd::float4x4 viewProj, simd::float3 camPos)
 {
-    m_renderer->render(enc, viewProj, camPos, time);
+    m_renderer->render(enc, viewProj, camPos, m_time);
 }
 
 void BlockSystem::setGhostBlock(BlockType type, simd::int3 pos, uint8_t rot) {
@@ -17,6 +17,8 @@
 #include <functional>
 
 #include "RMDLPNGLoader.h"
+#include "RMDLInstanceStore.hpp"
+#include "RMDLSlotMap.hpp"
 
 namespace cube {
 
@@ -366,7 +368,10 @@ public:
     
     void buildMeshes();
     void loadTextures(const std::string& resourcePath, MTL::CommandQueue* queue);
-    void updateInstances(const std::vector<BlockInstance>& blocks, float time);
+    
+    // Store d'instances persistant : ajoute ou met à jour le bloc (false si plein ou sans mesh)
+    bool setInstance(const BlockInstance& block);
+    void removeInstance(uint32_t blockId);
     void render(MTL::RenderCommandEncoder* enc, simd::float4x4 viewProj, simd::float3 camPos, float time);
     
     void setGhostBlock(BlockType type, simd::int3 pos, uint8_t rot);
@@ -377,6 +382,8 @@ public:
 private:
     void createPipeline(MTL::PixelFormat pixelFormat, MTL::PixelFormat depthFormat);
     void createMeshBuffers();
+    BlockGPUInstance makeGPUInstance(const BlockInstance& block, uint32_t textureIndex) const;
+    void rebuildBatches();
     
     MTL::Device* m_device;
     MTL::Library* m_library;
@@ -392,13 +399,18 @@ private:
     uint32_t m_totalVertices = 0;
     uint32_t m_totalIndices = 0;
     
-    // Instance data - triple buffering
+    // Instance data - triple buffering ; le dernier slot est réservé au ghost
     static constexpr uint32_t kMaxInstances = 8192;
     static constexpr uint32_t kBufferCount = 3;
     MTL::Buffer* m_instanceBuffers[kBufferCount] = {};
     MTL::Buffer* m_uniformBuffers[kBufferCount] = {};
     uint32_t m_bufferIndex = 0;
     
+    // Une plage par type de bloc, un seul draw chacune ; seuls les slots modifiés sont recopiés
+    using Instances = InstanceStore<BlockType, BlockGPUInstance, kMaxInstances, kBufferCount>;
+    static constexpr uint32_t kGhostSlot = Instances::kReservedSlot;
+    Instances m_instances;
+    
     // Par type de bloc: offset et count dans le buffer unifié
     struct MeshRange
     {
@@ -419,9 +431,6 @@ private:
     std::vector<DrawBatch> m_opaqueBatches;
     std::vector<DrawBatch> m_transparentBatches;
     
-    std::vector<BlockGPUInstance> m_gpuInstances;
-    uint32_t m_instanceCount = 0;
-    
     // Ghost block preview
     bool m_hasGhost = false;
     BlockType m_ghostType;
@@ -451,10 +460,12 @@ public:
     
     // Color customization
     void setBlockColor(uint32_t id, simd::float4 color);
+    // À appeler après avoir modifié un bloc via getBlock / getBlockAt
+    void markBlockDirty(uint32_t id);
     
     // Update & Render
     void update(float dt);
-    void render(MTL::RenderCommandEncoder* enc, simd::float4x4 viewProj, simd::float3 camPos, float time);
+    void render(MTL::RenderCommandEncoder* enc, simd::float4x4 viewProj, simd::float3 camPos);
     
     // Ghost preview
     void setGhostBlock(BlockType type, simd::int3 pos, uint8_t rot);
@@ -471,9 +482,8 @@ public:
     
 private:
     std::unique_ptr<BlockRenderer> m_renderer;
-    std::vector<BlockInstance> m_blocks;
+    SlotMap<BlockInstance> m_blocks;                   // dense, ids générationnels
     std::unordered_map<uint64_t, uint32_t> m_gridMap;  // gridPos hash -> block id
-    uint32_t m_nextId = 1;
     float m_time = 0.0f;
     
     uint64_t hashPos(simd::int3 p) const {
@@ -148,6 +148,7 @@ m_text(m_device, layerPixelFormat, depthPixelFormat, m_shaderLibrary, resourcePa
     m_terrainTexture = m_device->newTexture(texDesc);
     
     size_t character = blender.loadModel(resourcePath + "/vitesse.glb", "player");
+    blender.setCPUSkinning(character, true);    // boîte animée : le personnage est cullé comme le reste
     size_t tree = blender.loadModel(resourcePath + "/all.glb", "plane");
     blender.getModel("player")->transform = math::makeTranslate({0, 5, 0});
     blender.getModel("plane")->transform = math::makeTranslate({5, 20, 0});//+ math::makeScale({10, 10, 10});
@@ -232,8 +233,8 @@ m_text(m_device, layerPixelFormat, depthPixelFormat, m_shaderLibrary, resourcePa
     m_spaceAudio->start();
     
     // Test : ajoute un moteur de base
-    int engineVoice = m_spaceAudio->synth().addVoice(BlockPresets::Engine());
-    m_spaceAudio->synth().triggerVoice(engineVoice, 1.0f);
+    m_engineVoice = m_spaceAudio->synth().addVoice(BlockPresets::Engine());
+    m_spaceAudio->synth().triggerVoice(m_engineVoice, 1.0f);
 
 //    vehicleManager.initialize(m_device, layerPixelFormat, depthPixelFormat, m_shaderLibrary);
 //    inventoryUI.initialize(m_device);
@@ -960,10 +961,19 @@ void GameCoordinator::update(float dt, const InputState& input, MTL::CommandBuff
         }
     }
 
-    m_terraVehicle.update(dt);
+    for (uint32_t step = 0; step < m_clock.substeps(); step++)
+        m_terraVehicle.update(m_clock.fixedStep());
+    // Caméra et rendu du véhicule entre les deux derniers états physiques
+    m_terraVehicle.interpolate(m_clock.alpha());
     float throttle = simd::length(input.moveDirection);
     m_spaceAudio->setEngineThrottle(throttle);
     
+    // Sources sur le véhicule, auditeur à la caméra : trop loin, le synthé rend leur voix au pool
+    float listenerDistance = simd::distance(m_camera.position(), m_terraVehicle.getCameraTarget());
+    m_spaceAudio->synth().setVoiceDistance(m_engineVoice, listenerDistance);
+    for (const auto& [blockId, voiceId] : m_blockVoices)
+        m_spaceAudio->synth().setVoiceDistance(voiceId, listenerDistance);
+    
     m_camera.updateTransition(dt);
     if (m_gamePlayMode == GamePlayMode::Flight)
     {
@@ -1008,7 +1018,7 @@ void GameCoordinator::addBlockToVehicle(int blockId, BlockType type)
 void GameCoordinator::removeBlockFromVehicle(int blockId)
 {
     if (m_blockVoices.count(blockId)) {
-        m_spaceAudio->synth().releaseVoice(m_blockVoices[blockId]);
+        m_spaceAudio->synth().removeVoice(m_blockVoices[blockId]);
         m_blockVoices.erase(blockId);
     }
 }
@@ -1115,7 +1125,9 @@ void GameCoordinator::draw(MTK::View* view)
     passDesc->depthAttachment()->setClearDepth(1.0f);
     passDesc->depthAttachment()->setStoreAction(MTL::StoreActionStore);
     m_frame += 1;
-    float dt = 0.016f;
+    // Temps réel pour caméra, animation et UI ; la physique avance en pas fixes
+    float dt = m_clock.tick();
+    m_clock.advance(dt);
     const uint32_t frameIndex = m_frame % kMaxFramesInFlight;
 //    passDesc->colorAttachments()->object(0)->setClearColor(MTL::ClearColor(0.1, 0.15, 0.2, 1.0));
     
@@ -1149,8 +1161,9 @@ void GameCoordinator::draw(MTK::View* view)
     renderCommandEncoder->setFragmentBytes(&m_cameraUniforms, sizeof(RMDLCameraUniforms), 1);
     
 //    blender.drawBlender(renderCommandEncoder, m_cameraUniforms.viewProjectionMatrix * modelMatrixRot, modelMatrixRot); // matrix_identity_float4x4
-    blender.draw(renderCommandEncoder, m_cameraUniforms.viewProjectionMatrix, m_uniforms);
+    // Pose et boîtes skinnées de cette frame avant le culling et l'envoi des bone matrices
     blender.updateBlender(dt);
+    blender.draw(renderCommandEncoder, m_cameraUniforms.viewProjectionMatrix, m_camera.frustum(), m_uniforms);
 
     skybox.render(renderCommandEncoder, math::makeIdentity(), m_cameraUniforms.viewProjectionMatrix * math::makeIdentity(), m_camera.position(), m_uniforms);
 //    snow.render(enc, modelMatrix2, {0,0,0});
@@ -1167,7 +1180,7 @@ void GameCoordinator::draw(MTK::View* view)
 
 //    world.update(dt, m_camera.position(), m_device);
 //    world.updateTime(dt);
-//    world.render(renderCommandEncoder, m_cameraUniforms.viewProjectionMatrix);
+//    world.render(renderCommandEncoder, m_cameraUniforms.viewProjectionMatrix, m_camera.frustum());
 
     gridCommandant.update(m_uniforms.frameTime);
 //    gridCommandant.setBlockPosition(m_currentVehicleBlockPos);
@@ -1181,11 +1194,6 @@ void GameCoordinator::draw(MTK::View* view)
 
     m_cameraUniforms.position = m_camera.position();
     
-    
-    dt += 0.016f;
-    
-    
-    
     ui.beginFrame(m_viewport.width, m_viewport.height);
     ui.drawText("Hello 89 ! Make sense", 550, 50, 0.5);
 //    colorsFlash.renderPostProcess(renderCommandEncoder);
@@ -1216,7 +1224,7 @@ void GameCoordinator::draw(MTK::View* view)
 
     terrainLisse.render(renderCommandEncoder, m_cameraUniforms.viewProjectionMatrix, m_camera.position());
     
-    blocs.render(renderCommandEncoder, m_cameraUniforms.viewProjectionMatrix, m_camera.position(), dt);
+    blocs.render(renderCommandEncoder, m_cameraUniforms.viewProjectionMatrix, m_camera.position());
     
     cards.draw(renderCommandEncoder, m_depth.get(), math::makeIdentity(), m_cameraUniforms.viewProjectionMatrix * math::makeIdentity(), m_viewport.width, m_viewport.height);
     
@@ -223,6 +223,7 @@ private:
     MTL::ComputePipelineState*          m_mousePositionComputeKernel;
     
     uint64_t                            m_frame;
+    SimulationClock                     m_clock;
     simd::float2                        cursorPosition;
     
     simd_uint2                          m_viewportSize;
@@ -256,6 +257,7 @@ private:
     
     std::unique_ptr<SpaceshipAudioEngine> m_spaceAudio;
     std::unordered_map<int, int> m_blockVoices;  // blockId -> voiceId
+    int m_engineVoice = -1;
 
     
     RMDLCamera                          m_camera;
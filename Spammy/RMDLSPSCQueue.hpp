@@ -0,0 +1,68 @@
+//
+//  RMDLSPSCQueue.hpp
+//  Spammy
+//
+//  Created by Rémy on 17/10/2026.
+//
+
+#ifndef RMDLSPSCQueue_hpp
+#define RMDLSPSCQueue_hpp
+
+#include <atomic>
+#include <cstddef>
+
+// Ring lock-free un producteur / un consommateur, capacité fixe : ni verrou ni allocation
+// après construction. Le producteur écrit le slot puis publie _tail (release) ; le consommateur
+// lit _tail (acquire) avant le slot, et inversement pour _head.
+template<typename T, size_t Capacity>
+class SPSCQueue
+{
+    static_assert((Capacity & (Capacity - 1)) == 0, "Capacity doit être une puissance de 2");
+
+public:
+    // Producteur uniquement ; false si plein
+    bool push(const T& value)
+    {
+        size_t tail = _tail.load(std::memory_order_relaxed);
+        if (tail - _cachedHead == Capacity)
+        {
+            _cachedHead = _head.load(std::memory_order_acquire);
+            if (tail - _cachedHead == Capacity)
+                return false;
+        }
+        _slots[tail & (Capacity - 1)] = value;
+        _tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consommateur uniquement ; nullptr si vide. Le pointeur reste valide jusqu'au pop()
+    const T* front()
+    {
+        size_t head = _head.load(std::memory_order_relaxed);
+        if (head == _cachedTail)
+        {
+            _cachedTail = _tail.load(std::memory_order_acquire);
+            if (head == _cachedTail)
+                return nullptr;
+        }
+        return &_slots[head & (Capacity - 1)];
+    }
+
+    // Consommateur uniquement, après un front() non nul
+    void pop()
+    {
+        _head.store(_head.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    static constexpr size_t capacity() { return Capacity; }
+
+private:
+    // Chaque côté sur sa ligne de cache, avec une copie locale de l'index de l'autre
+    alignas(64) std::atomic<size_t> _head{0};
+    size_t                          _cachedTail = 0;
+    alignas(64) std::atomic<size_t> _tail{0};
+    size_t                          _cachedHead = 0;
+    alignas(64) T                   _slots[Capacity];
+};
+
+#endif /* RMDLSPSCQueue_hpp */
@@ -0,0 +1,122 @@
+//
+//  RMDLSkinning.cpp
+//  Spammy
+//
+//  Created by Rémy on 17/10/2026.
+//
+
+#include "RMDLSkinning.hpp"
+#include "RMDLBlender.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace skinning
+{
+
+void prepare(const VertexBlenderFull* vertices, size_t count, uint32_t boneCount, SkinStream& out)
+{
+    out.positions.resize(count);
+    out.normals.resize(count);
+    out.joints.resize(count);
+    out.weights.resize(count);
+
+    for (size_t i = 0; i < count; i++)
+    {
+        const VertexBlenderFull& v = vertices[i];
+        out.positions[i] = simd::make_float4(v.position, 1.0f);
+        out.normals[i] = simd::make_float4(v.normal, 0.0f);
+
+        // Le shader lit boneMatrices[-1] * 0 ; ici on ne lit jamais hors de la palette
+        simd::ushort4 joints = { 0, 0, 0, 0 };
+        simd::float4 weights = { 0.0f, 0.0f, 0.0f, 0.0f };
+        for (int k = 0; k < 4; k++)
+        {
+            if (v.joints[k] >= 0 && (uint32_t)v.joints[k] < boneCount && v.weights[k] > 0.0f)
+            {
+                joints[k] = (uint16_t)v.joints[k];
+                weights[k] = v.weights[k];
+            }
+        }
+        out.joints[i] = joints;
+        out.weights[i] = weights;
+    }
+}
+
+// Somme pondérée des 4 matrices, colonne par colonne : 16 FMA sur des float4
+static inline simd::float4x4 blendMatrices(const simd::float4x4* palette, simd::ushort4 joints, simd::float4 weights)
+{
+    const simd::float4x4& m0 = palette[joints.x];
+    const simd::float4x4& m1 = palette[joints.y];
+    const simd::float4x4& m2 = palette[joints.z];
+    const simd::float4x4& m3 = palette[joints.w];
+
+    simd::float4x4 skin;
+    for (int c = 0; c < 4; c++)
+        skin.columns[c] = m0.columns[c] * weights.x + m1.columns[c] * weights.y + m2.columns[c] * weights.z + m3.columns[c] * weights.w;
+    return skin;
+}
+
+Bounds skinBatch(const SkinStream& stream, const simd::float4x4* palette, size_t first, size_t count, simd::float4* positions, simd::float4* normals)
+{
+    simd::float4 lo = { INFINITY, INFINITY, INFINITY, INFINITY };
+    simd::float4 hi = -lo;
+    const size_t end = std::min(first + count, stream.size());
+
+    for (size_t i = first; i < end; i++)
+    {
+        simd::float4x4 skin = blendMatrices(palette, stream.joints[i], stream.weights[i]);
+
+        simd::float4 p = stream.positions[i];
+        simd::float4 skinned = skin.columns[0] * p.x + skin.columns[1] * p.y + skin.columns[2] * p.z + skin.columns[3];
+        positions[i] = skinned;
+        lo = simd::min(lo, skinned);
+        hi = simd::max(hi, skinned);
+
+        if (normals)
+        {
+            simd::float4 n = stream.normals[i];
+            simd::float4 skinnedNormal = skin.columns[0] * n.x + skin.columns[1] * n.y + skin.columns[2] * n.z;
+            skinnedNormal.w = 0.0f;
+            float lengthSq = simd::dot(skinnedNormal, skinnedNormal);
+            normals[i] = lengthSq > 0.0f ? skinnedNormal / std::sqrt(lengthSq) : skinnedNormal;
+        }
+    }
+
+    Bounds bounds;
+    if (end > first)
+    {
+        bounds.min = lo.xyz;
+        bounds.max = hi.xyz;
+    }
+    return bounds;
+}
+
+Bounds skin(const SkinStream& stream, const simd::float4x4* palette, simd::float4* positions, simd::float4* normals)
+{
+    Bounds bounds;
+    for (size_t first = 0; first < stream.size(); first += BATCH_SIZE)
+        bounds.merge(skinBatch(stream, palette, first, BATCH_SIZE, positions, normals));
+    return bounds;
+}
+
+Bounds transformBounds(const Bounds& bounds, const simd::float4x4& transform)
+{
+    if (bounds.empty())
+        return bounds;
+
+    simd::float3 center = (bounds.min + bounds.max) * 0.5f;
+    simd::float3 extent = (bounds.max - bounds.min) * 0.5f;
+
+    simd::float3 worldCenter = (transform * simd::make_float4(center, 1.0f)).xyz;
+    simd::float3 worldExtent = simd::abs(transform.columns[0].xyz) * extent.x
+                             + simd::abs(transform.columns[1].xyz) * extent.y
+                             + simd::abs(transform.columns[2].xyz) * extent.z;
+
+    Bounds result;
+    result.min = worldCenter - worldExtent;
+    result.max = worldCenter + worldExtent;
+    return result;
+}
+
+}
@@ -0,0 +1,65 @@
+//
+//  RMDLSkinning.hpp
+//  Spammy
+//
+//  Created by Rémy on 17/10/2026.
+//
+
+#ifndef RMDLSkinning_hpp
+#define RMDLSkinning_hpp
+
+#include <simd/simd.h>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <cmath>
+
+struct VertexBlenderFull;
+
+// Skinning CPU 4 influences, même formule que vertexmain_BlenderAnyme : sert au picking,
+// à la physique et aux boîtes englobantes animées sans passer par le GPU.
+namespace skinning
+{
+
+constexpr size_t BATCH_SIZE = 256;  // vertices par lot, granularité pour un découpage en jobs
+
+struct Bounds
+{
+    simd::float3 min = {  INFINITY,  INFINITY,  INFINITY };
+    simd::float3 max = { -INFINITY, -INFINITY, -INFINITY };
+
+    bool empty() const { return min.x > max.x; }
+    void merge(const Bounds& other)
+    {
+        min = simd::min(min, other.min);
+        max = simd::max(max, other.max);
+    }
+};
+
+// Flux d'entrée préparé au chargement : float4 alignés (w = 1 pour les positions, 0 pour
+// les normales), influences inutilisées ramenées sur le bone 0 avec un poids nul
+struct SkinStream
+{
+    std::vector<simd::float4>   positions;
+    std::vector<simd::float4>   normals;
+    std::vector<simd::ushort4>  joints;
+    std::vector<simd::float4>   weights;
+
+    size_t size() const { return positions.size(); }
+};
+
+void prepare(const VertexBlenderFull* vertices, size_t count, uint32_t boneCount, SkinStream& out);
+
+// Skinne [first, first + count) depuis la palette (boneCount matrices) ; normals peut être
+// nullptr si seules les positions servent. Renvoie la boîte des positions skinnées.
+Bounds skinBatch(const SkinStream& stream, const simd::float4x4* palette, size_t first, size_t count, simd::float4* positions, simd::float4* normals);
+
+// Tout le flux, lot par lot
+Bounds skin(const SkinStream& stream, const simd::float4x4* palette, simd::float4* positions, simd::float4* normals);
+
+// Boîte alignée englobant la boîte transformée (Arvo)
+Bounds transformBounds(const Bounds& bounds, const simd::float4x4& transform);
+
+}
+
+#endif /* RMDLSkinning_hpp */
@@ -0,0 +1,112 @@
+//
+//  RMDLSlotMap.hpp
+//  Spammy
+//
+//  Created by Rémy on 17/10/2026.
+//
+
+#ifndef RMDLSlotMap_hpp
+#define RMDLSlotMap_hpp
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Slot map générationnel : id = (génération << kSlotBits) | slot, jamais nul. Les valeurs restent
+// denses (retrait par swap-remove), m_slots donne l'index dense en O(1) et la génération invalide
+// les ids périmés. Un slot libre chaîne le suivant dans denseIndex. T porte son id (membre uint32_t id).
+template<typename T>
+class SlotMap
+{
+public:
+    static constexpr uint32_t kSlotBits = 20;
+    static constexpr uint32_t kSlotMask = (1u << kSlotBits) - 1;
+    static constexpr uint32_t kInvalidSlot = kSlotMask;
+
+    // Ajoute value à la fin avec un nouvel id ; nullptr si les slots sont épuisés
+    T* insert(const T& value)
+    {
+        uint32_t slot = m_freeSlot;
+        if (slot != kInvalidSlot)
+            m_freeSlot = m_slots[slot].denseIndex;
+        else
+        {
+            if (m_slots.size() >= kInvalidSlot)
+                return nullptr;
+            slot = (uint32_t)m_slots.size();
+            m_slots.push_back({ 0, 1 });
+        }
+        m_slots[slot].denseIndex = (uint32_t)m_values.size();
+
+        m_values.push_back(value);
+        m_values.back().id = (m_slots[slot].generation << kSlotBits) | slot;
+        return &m_values.back();
+    }
+
+    bool erase(uint32_t id)
+    {
+        int32_t index = denseIndexOf(id);
+        if (index < 0)
+            return false;
+
+        // Le dernier prend la place du retiré : son slot suit
+        if ((size_t)index != m_values.size() - 1)
+        {
+            m_values[index] = m_values.back();
+            m_slots[m_values[index].id & kSlotMask].denseIndex = (uint32_t)index;
+        }
+        m_values.pop_back();
+
+        // Génération sur 12 bits, jamais 0 : un id valide n'est jamais nul
+        Slot& freed = m_slots[id & kSlotMask];
+        freed.generation = (freed.generation + 1) & (0xFFFFFFFFu >> kSlotBits);
+        if (freed.generation == 0)
+            freed.generation = 1;
+        freed.denseIndex = m_freeSlot;
+        m_freeSlot = id & kSlotMask;
+        return true;
+    }
+
+    T* get(uint32_t id)
+    {
+        int32_t index = denseIndexOf(id);
+        return index >= 0 ? &m_values[index] : nullptr;
+    }
+
+    const T* get(uint32_t id) const
+    {
+        int32_t index = denseIndexOf(id);
+        return index >= 0 ? &m_values[index] : nullptr;
+    }
+
+    // Parcours dense ; un insert ou un erase invalide pointeurs et itérateurs
+    size_t size() const { return m_values.size(); }
+    bool empty() const { return m_values.empty(); }
+    T* begin() { return m_values.data(); }
+    T* end() { return m_values.data() + m_values.size(); }
+    const T* begin() const { return m_values.data(); }
+    const T* end() const { return m_values.data() + m_values.size(); }
+
+private:
+    struct Slot
+    {
+        uint32_t denseIndex;
+        uint32_t generation;
+    };
+
+    int32_t denseIndexOf(uint32_t id) const
+    {
+        uint32_t slot = id & kSlotMask;
+        if (slot >= m_slots.size() || m_slots[slot].generation != (id >> kSlotBits))
+            return -1;
+        // Un slot libre chaîne le suivant : après un tour complet de génération, l'id seul tranche
+        uint32_t index = m_slots[slot].denseIndex;
+        return (index < m_values.size() && m_values[index].id == id) ? (int32_t)index : -1;
+    }
+
+    std::vector<T> m_values;
+    std::vector<Slot> m_slots;
+    uint32_t m_freeSlot = kInvalidSlot;
+};
+
+#endif /* RMDLSlotMap_hpp */
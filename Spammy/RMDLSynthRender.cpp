@@ -0,0 +1,233 @@
+//
+//  RMDLSynthRender.cpp
+//  Spammy
+//
+//  Created by Rémy on 17/10/2026.
+//
+
+#ifdef RMDL_SYNTH_RENDER_TOOL
+// Rendu hors-ligne de SpaceshipSynthesizer, sans AVFoundation ni PHASE (Linux ou macOS). Depuis Spammy/ :
+// g++ -std=gnu++17 -O2 -ffp-contract=off -DRMDL_SYNTH_RENDER_TOOL RMDLSynthRender.cpp RMDLHexagonSpace.cpp -o rmdl-synth-render
+// puis : ./rmdl-synth-render [--seed N] [--rate 48000] [--seconds 10] [--voices 32] [--block 512] out.wav
+// Même graine et même --rate : fichier identique au bit près (hash affiché) seulement si --block est un multiple
+// de 128 (kBlockSize), et alors quel que soit --block ; sinon le découpage change l'ordonnancement des voix.
+// Tests/synth-render.hash garde le hash de référence, vérifié par CTest (cible rmdl-synth-render).
+
+#include "RMDLHexagonSpace.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+struct ScriptEvent
+{
+    double time;                // secondes
+    VoiceEvent::Type type;
+    int voice;                  // index dans le script
+    float value;
+    float rampSeconds;
+};
+
+// Le script ne dépend que de la graine : pas de std::uniform_*_distribution, dont le résultat varie selon la lib
+struct ScriptRandom
+{
+    uint32_t state;
+    float next(float lo, float hi)
+    {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        return lo + (hi - lo) * (float)(state >> 8) * (1.0f / 16777216.0f);
+    }
+};
+
+static BlockSoundProfile presetFor(int index)
+{
+    switch (index % 6)
+    {
+        case 0: return BlockPresets::Engine();
+        case 1: return BlockPresets::Thruster();
+        case 2: return BlockPresets::Generator();
+        case 3: return BlockPresets::Shield();
+        case 4: return BlockPresets::Weapon();
+        default: return BlockPresets::Cockpit();
+    }
+}
+
+// Un vaisseau qui démarre : moteurs et blocs allumés en cascade, rampes de throttle,
+// rafales d'armes, puis extinction dans le dernier cinquième
+static void buildScript(uint32_t seed, int voiceCount, double seconds, std::vector<ScriptEvent>& script)
+{
+    ScriptRandom random{ seed ? seed : 1u };
+    const double shutdown = seconds * 0.8;
+
+    for (int v = 0; v < voiceCount; v++)
+    {
+        double start = v * 0.05;
+        script.push_back({ start, VoiceEvent::Type::Distance, v, random.next(2.0f, 120.0f), 0.0f });
+        script.push_back({ start, VoiceEvent::Type::Throttle, v, random.next(0.0f, 0.4f), 0.0f });
+
+        if (v % 6 == 4)
+        {
+            for (double t = start + random.next(0.2f, 1.0f); t < shutdown; t += random.next(0.5f, 2.0f))
+            {
+                script.push_back({ t, VoiceEvent::Type::NoteOn, v, random.next(0.6f, 1.0f), 0.0f });
+                script.push_back({ t + 0.15, VoiceEvent::Type::NoteOff, v, 0.0f, 0.0f });
+            }
+            continue;
+        }
+
+        script.push_back({ start, VoiceEvent::Type::NoteOn, v, random.next(0.5f, 1.0f), 0.0f });
+        for (double t = 1.0; t < shutdown; t += 1.0)
+            script.push_back({ t, VoiceEvent::Type::Throttle, v, random.next(0.0f, 1.0f), 0.5f });
+        script.push_back({ shutdown, VoiceEvent::Type::NoteOff, v, 0.0f, 0.0f });
+    }
+
+    std::stable_sort(script.begin(), script.end(), [](const ScriptEvent& a, const ScriptEvent& b) { return a.time < b.time; });
+}
+
+static bool writeWav(const std::string& path, const std::vector<float>& samples, uint32_t sampleRate, uint16_t channels)
+{
+    FILE* file = fopen(path.c_str(), "wb");
+    if (!file)
+        return false;
+
+    const uint32_t dataSize = (uint32_t)(samples.size() * sizeof(float));
+    const uint16_t format = 3;      // WAVE_FORMAT_IEEE_FLOAT
+    const uint16_t bits = 32;
+    const uint16_t blockAlign = channels * sizeof(float);
+    const uint32_t byteRate = sampleRate * blockAlign;
+    const uint32_t fmtSize = 16;
+    const uint32_t riffSize = 4 + (8 + fmtSize) + (8 + dataSize);
+
+    // Little-endian, comme toutes les cibles du projet
+    bool ok = fwrite("RIFF", 1, 4, file) == 4 && fwrite(&riffSize, 4, 1, file) == 1 && fwrite("WAVE", 1, 4, file) == 4
+           && fwrite("fmt ", 1, 4, file) == 4 && fwrite(&fmtSize, 4, 1, file) == 1
+           && fwrite(&format, 2, 1, file) == 1 && fwrite(&channels, 2, 1, file) == 1
+           && fwrite(&sampleRate, 4, 1, file) == 1 && fwrite(&byteRate, 4, 1, file) == 1
+           && fwrite(&blockAlign, 2, 1, file) == 1 && fwrite(&bits, 2, 1, file) == 1
+           && fwrite("data", 1, 4, file) == 4 && fwrite(&dataSize, 4, 1, file) == 1
+           && fwrite(samples.data(), sizeof(float), samples.size(), file) == samples.size();
+    return (fclose(file) == 0) && ok;
+}
+
+int main(int argc, char** argv)
+{
+    uint32_t seed = 42;
+    uint32_t sampleRate = 48000;
+    double seconds = 10.0;
+    int voiceCount = 32;
+    int blockFrames = 512;
+    std::string outputPath;
+
+    for (int i = 1; i < argc; i++)
+    {
+        bool hasValue = i + 1 < argc;
+        if (!strcmp(argv[i], "--seed") && hasValue)          seed = (uint32_t)strtoul(argv[++i], nullptr, 10);
+        else if (!strcmp(argv[i], "--rate") && hasValue)     sampleRate = (uint32_t)strtoul(argv[++i], nullptr, 10);
+        else if (!strcmp(argv[i], "--seconds") && hasValue)  seconds = atof(argv[++i]);
+        else if (!strcmp(argv[i], "--voices") && hasValue)   voiceCount = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--block") && hasValue)    blockFrames = atoi(argv[++i]);
+        else if (argv[i][0] != '-')                          outputPath = argv[i];
+        else
+        {
+            fprintf(stderr, "usage: %s [--seed N] [--rate Hz] [--seconds S] [--voices N] [--block N] out.wav\n", argv[0]);
+            return 1;
+        }
+    }
+    if (outputPath.empty() || sampleRate == 0 || seconds <= 0.0 || blockFrames <= 0)
+    {
+        fprintf(stderr, "usage: %s [--seed N] [--rate Hz] [--seconds S] [--voices N] [--block N] out.wav\n", argv[0]);
+        return 1;
+    }
+    // Les profils passent par la ring avant le premier rendu
+    voiceCount = std::clamp(voiceCount, 1, (int)SpaceshipSynthesizer::kEventCapacity / 2);
+
+    static SpaceshipSynthesizer synth;
+    synth.init((float)sampleRate);
+    synth.setSeed(seed);
+
+    std::vector<int> voiceIds(voiceCount);
+    for (int v = 0; v < voiceCount; v++)
+        voiceIds[v] = synth.addVoice(presetFor(v));
+
+    std::vector<ScriptEvent> script;
+    buildScript(seed, voiceCount, seconds, script);
+
+    const uint64_t totalFrames = (uint64_t)(seconds * sampleRate);
+    std::vector<float> output((size_t)totalFrames * 2);
+    size_t nextEvent = 0;
+    double renderSeconds = 0.0;
+    double voiceFrames = 0.0;
+    int maxVoices = 0;
+
+    for (uint64_t frame = 0; frame < totalFrames; frame += blockFrames)
+    {
+        int count = (int)std::min<uint64_t>(blockFrames, totalFrames - frame);
+
+        // Tout est daté au sample : le moment de l'envoi n'influe pas sur le rendu
+        while (nextEvent < script.size())
+        {
+            const ScriptEvent& e = script[nextEvent];
+            uint64_t at = (uint64_t)(e.time * sampleRate + 0.5);
+            if (at >= frame + count)
+                break;
+
+            VoiceEvent event;
+            event.type = e.type;
+            event.voiceId = voiceIds[e.voice];
+            event.frame = at;
+            event.value = e.value;
+            event.rampSeconds = e.rampSeconds;
+            if (!synth.postEvent(event))
+                break;
+            nextEvent++;
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        synth.renderBuffer(output.data() + frame * 2, count, 2);
+        renderSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        int rendered = synth.getRenderedVoiceCount();
+        voiceFrames += (double)rendered * count;
+        maxVoices = std::max(maxVoices, rendered);
+    }
+
+    float peak = 0.0f;
+    uint64_t hash = 1469598103934665603ull;
+    for (float sample : output)
+    {
+        peak = std::max(peak, std::fabs(sample));
+        uint32_t bits;
+        memcpy(&bits, &sample, sizeof(bits));
+        for (int b = 0; b < 4; b++)
+        {
+            hash ^= (bits >> (8 * b)) & 0xFF;
+            hash *= 1099511628211ull;
+        }
+    }
+
+    if (!writeWav(outputPath, output, sampleRate, 2))
+    {
+        fprintf(stderr, "Cannot write %s\n", outputPath.c_str());
+        return 1;
+    }
+
+    double audioSeconds = (double)totalFrames / sampleRate;
+    double voiceSeconds = voiceFrames / sampleRate;
+    printf("%s: %.2f s @ %u Hz, seed %u, %d sources, block %d\n", outputPath.c_str(), audioSeconds, sampleRate, seed, voiceCount, blockFrames);
+    printf("realtime factor x%.1f (%.1f ms CPU)\n", audioSeconds / renderSeconds, renderSeconds * 1000.0);
+    printf("peak %.4f (%.1f dBFS)\n", peak, 20.0 * std::log10(std::max(peak, 1e-9f)));
+    printf("voices rendered: max %d, mean %.1f ; CPU per voice %.3f%% of a core\n", maxVoices, voiceSeconds / audioSeconds,
+           voiceSeconds > 0.0 ? 100.0 * renderSeconds / voiceSeconds : 0.0);
+    printf("hash %016llx\n", (unsigned long long)hash);
+    if (synth.getDroppedEvents())
+        printf("warning: %u events dropped\n", synth.getDroppedEvents());
+    return 0;
+}
+#endif
@@ -6,6 +6,7 @@
 //
 
 #include "RMDLSystem.hpp"
+#include "RMDLCamera.hpp"
 
 RenderSystem::RenderSystem(MTL::Device* device, MTL::PixelFormat colorFormat,
                           MTL::PixelFormat depthFormat, NS::UInteger width, NS::UInteger height,
@@ -829,8 +830,10 @@ ChunkMap::ChunkMap(MTL::Device* device, Types::ChunkCoord coord)
     _lodIndexBuffers.fill(nullptr);
     _lodIndexCounts.fill(0);
     
-    _bounds.min = simd::make_float3(0, 0, 0);
-    _bounds.max = simd::make_float3(OfficialConfig::CHUNK_SIZE, OfficialConfig::CHUNK_HEIGHT, OfficialConfig::CHUNK_SIZE);
+    // Colonne pleine hauteur en attendant le mesh, qui resserre min/max Y
+    simd::float2 worldPos = getWorldPosition();
+    _bounds.min = simd::make_float3(worldPos.x, 0, worldPos.y);
+    _bounds.max = simd::make_float3(worldPos.x + OfficialConfig::CHUNK_SIZE, OfficialConfig::CHUNK_HEIGHT, worldPos.y + OfficialConfig::CHUNK_SIZE);
 }
 
 ChunkMap::~ChunkMap() {
@@ -945,6 +948,102 @@ void ChunkMap::updateDistance(simd::float3 cameraPos) {
     _distanceToCamera = std::sqrt(dx * dx + dz * dz);
 }
 
+bool TerrainRequestQueue::push(TerrainGenerationRequest request) {
+    uint64_t key = request.coord.hash();
+    auto it = _slots.find(key);
+    if (it != _slots.end()) {
+        size_t index = it->second;
+        _heap[index] = std::move(request);
+        siftUp(index);
+        siftDown(_slots[key]);
+        return false;
+    }
+    
+    _heap.push_back(std::move(request));
+    _slots[key] = _heap.size() - 1;
+    siftUp(_heap.size() - 1);
+    return true;
+}
+
+TerrainGenerationRequest TerrainRequestQueue::pop() {
+    TerrainGenerationRequest top = std::move(_heap.front());
+    _slots.erase(top.coord.hash());
+    
+    if (_heap.size() > 1) {
+        _heap.front() = std::move(_heap.back());
+        _slots[_heap.front().coord.hash()] = 0;
+        _heap.pop_back();
+        siftDown(0);
+    } else {
+        _heap.pop_back();
+    }
+    return top;
+}
+
+bool TerrainRequestQueue::remove(uint64_t key) {
+    auto it = _slots.find(key);
+    if (it == _slots.end()) return false;
+    
+    size_t index = it->second;
+    _slots.erase(it);
+    
+    size_t last = _heap.size() - 1;
+    if (index != last) {
+        uint64_t movedKey = _heap[last].coord.hash();
+        _heap[index] = std::move(_heap[last]);
+        _slots[movedKey] = index;
+        _heap.pop_back();
+        siftUp(index);
+        siftDown(_slots[movedKey]);
+    } else {
+        _heap.pop_back();
+    }
+    return true;
+}
+
+bool TerrainRequestQueue::updatePriority(uint64_t key, uint32_t priority) {
+    auto it = _slots.find(key);
+    if (it == _slots.end()) return false;
+    
+    size_t index = it->second;
+    uint32_t previous = _heap[index].priority;
+    _heap[index].priority = priority;
+    if (priority < previous)
+        siftUp(index);
+    else if (priority > previous)
+        siftDown(index);
+    return true;
+}
+
+void TerrainRequestQueue::siftUp(size_t index) {
+    while (index > 0) {
+        size_t parent = (index - 1) / 2;
+        if (_heap[parent].priority <= _heap[index].priority) break;
+        swapNodes(index, parent);
+        index = parent;
+    }
+}
+
+void TerrainRequestQueue::siftDown(size_t index) {
+    const size_t count = _heap.size();
+    while (true) {
+        size_t smallest = index;
+        size_t left = index * 2 + 1;
+        size_t right = left + 1;
+        if (left < count && _heap[left].priority < _heap[smallest].priority) smallest = left;
+        if (right < count && _heap[right].priority < _heap[smallest].priority) smallest = right;
+        if (smallest == index) break;
+        swapNodes(index, smallest);
+        index = smallest;
+    }
+}
+
+void TerrainRequestQueue::swapNodes(size_t a, size_t b) {
+    std::swap(_heap[a], _heap[b]);
+    _slots[_heap[a].coord.hash()] = a;
+    _slots[_heap[b].coord.hash()] = b;
+}
+
 TerrainGenerator::TerrainGenerator(MTL::Device* device, MTL::CommandQueue* queue,
                                    NoiseGenerator* noise, BiomeManager* biomes)
     : _device(device)
@@ -958,6 +1057,7 @@ TerrainGenerator::TerrainGenerator(MTL::Device* device, MTL::CommandQueue* queue
     , _currentLOD(0)
     , _pendingCount(0)
     , _generatedCount(0)
+    , _cancelledCount(0)
 {
     // Démarrer les workers
     uint32_t numWorkers = std::max(2u, std::thread::hardware_concurrency() / 2);
@@ -984,13 +1084,47 @@ TerrainGenerator::~TerrainGenerator() {
 void TerrainGenerator::requestChunk(Types::ChunkCoord coord, uint32_t priority,
                                     std::function<void(std::shared_ptr<ChunkMap>)> callback) {
     std::lock_guard<std::mutex> lock(_queueMutex);
-    _requestQueue.push({ coord, priority, std::move(callback) });
-    _pendingCount++;
+    if (_requestQueue.push({ coord, priority, std::move(callback) }))
+        _pendingCount++;
     _queueCondition.notify_one();
 }
 
-void TerrainGenerator::cancelRequest(Types::ChunkCoord coord) {
-    // Note: simplification - dans une vraie implémentation, on filtrerait la queue
+bool TerrainGenerator::cancelRequest(Types::ChunkCoord coord) {
+    std::lock_guard<std::mutex> lock(_queueMutex);
+    if (!_requestQueue.remove(coord.hash())) return false;
+    _pendingCount--;
+    _cancelledCount++;
+    return true;
+}
+
+bool TerrainGenerator::reprioritizeRequest(Types::ChunkCoord coord, uint32_t priority) {
+    std::lock_guard<std::mutex> lock(_queueMutex);
+    return _requestQueue.updatePriority(coord.hash(), priority);
+}
+
+void TerrainGenerator::refreshRequests(const std::function<bool(Types::ChunkCoord, uint32_t&)>& priorityOf,
+                                       std::vector<Types::ChunkCoord>& cancelled) {
+    std::lock_guard<std::mutex> lock(_queueMutex);
+    
+    // Décider d'abord, modifier ensuite : le tas bouge sous les mises à jour
+    std::vector<std::pair<Types::ChunkCoord, uint32_t>> updates;
+    size_t firstCancelled = cancelled.size();
+    for (const auto& request : _requestQueue.requests()) {
+        uint32_t priority = request.priority;
+        if (!priorityOf(request.coord, priority))
+            cancelled.push_back(request.coord);
+        else if (priority != request.priority)
+            updates.emplace_back(request.coord, priority);
+    }
+    
+    for (size_t i = firstCancelled; i < cancelled.size(); i++) {
+        _requestQueue.remove(cancelled[i].hash());
+        _pendingCount--;
+        _cancelledCount++;
+    }
+    for (const auto& [coord, priority] : updates) {
+        _requestQueue.updatePriority(coord.hash(), priority);
+    }
 }
 
 void TerrainGenerator::workerThread() {
@@ -1005,8 +1139,7 @@ void TerrainGenerator::workerThread() {
             
             if (!_running && _requestQueue.empty()) return;
             
-            request = _requestQueue.top();
-            _requestQueue.pop();
+            request = _requestQueue.pop();
         }
         
         generateChunk(request);
@@ -1229,6 +1362,21 @@ void TerrainManager::update(simd::float3 cameraPosition, float deltaTime) {
 }
 
 void TerrainManager::updateChunkLoading(simd::float3 cameraPosition) {
+    // Requêtes en attente : priorité recalculée depuis la caméra, annulées si le chunk
+    // serait déchargé dès son arrivée
+    _cancelledChunks.clear();
+    _generator->refreshRequests([this, cameraPosition](Types::ChunkCoord coord, uint32_t& priority) {
+        priority = calculatePriority(coord, cameraPosition);
+        return priority <= OfficialConfig::CHUNK_UNLOAD_DISTANCE;
+    }, _cancelledChunks);
+    
+    if (!_cancelledChunks.empty()) {
+        std::lock_guard<std::mutex> lock(_chunksMutex);
+        for (const auto& coord : _cancelledChunks) {
+            _pendingChunks.erase(coord.hash());
+        }
+    }
+    
     Types::ChunkCoord cameraChunk = {
         static_cast<int32_t>(std::floor(cameraPosition.x / OfficialConfig::CHUNK_SIZE)),
         static_cast<int32_t>(std::floor(cameraPosition.z / OfficialConfig::CHUNK_SIZE))
@@ -1258,7 +1406,7 @@ void TerrainManager::updateChunkLoading(simd::float3 cameraPosition) {
             // Limite de chunks
             if (_chunks.size() + _pendingChunks.size() >= OfficialConfig::MAX_LOADED_CHUNKS) continue;
             
-            _pendingChunks.insert(hash);
+            _pendingChunks.emplace(hash, coord);
             
             uint32_t priority = calculatePriority(coord, cameraPosition);
             
@@ -1288,7 +1436,7 @@ void TerrainManager::updateChunkLODs(simd::float3 cameraPosition) {
 }
 
 void TerrainManager::unloadDistantChunks(simd::float3 cameraPosition) {
-    float maxDist = OfficialConfig::VIEW_DISTANCE_CHUNKS * OfficialConfig::CHUNK_SIZE * 1.5f;
+    float maxDist = OfficialConfig::CHUNK_UNLOAD_DISTANCE;
     
     std::lock_guard<std::mutex> lock(_chunksMutex);
     
@@ -1331,12 +1479,23 @@ void TerrainManager::render(MTL::RenderCommandEncoder* encoder, const GPU::Camer
     
     std::lock_guard<std::mutex> lock(_chunksMutex);
     
+    _chunkCuller.clear();
+    _cullCandidates.clear();
+    _visibleChunks.clear();
+    
     for (auto& [coord, chunk] : _chunks) {
         if (chunk->getState() != ChunkState::Ready) continue;
         if (!chunk->getVertexBuffer()) continue;
         
-        // Frustum culling basique
-        // TODO: implémenter frustum culling complet
+        const Types::AABB& bounds = chunk->getBounds();
+        _chunkCuller.addBox(bounds.min, bounds.max);
+        _cullCandidates.push_back(chunk.get());
+    }
+    
+    _chunkCuller.cull(RMDLCamera::frustumFromViewProjection(camera.viewProjectionMatrix), _visibleChunks);
+    
+    for (uint32_t index : _visibleChunks) {
+        ChunkMap* chunk = _cullCandidates[index];
         
         GPU::TerrainPushConstants constants = {
             .chunkWorldPos = chunk->getWorldPosition(),
@@ -1455,11 +1614,56 @@ bool TerrainManager::raycast(const Types::Ray& ray, Types::RayHit& hit, float ma
     return false;
 }
 
+SimulationClock::SimulationClock()
+    : _started(false)
+    , _frameTime(0.0f)
+    , _accumulator(0.0f)
+    , _substeps(0)
+{
+}
+
+float SimulationClock::tick() {
+    auto now = std::chrono::steady_clock::now();
+    _frameTime = _started ? std::chrono::duration<float>(now - _lastTick).count() : 0.0f;
+    _lastTick = now;
+    _started = true;
+    return _frameTime;
+}
+
+uint32_t SimulationClock::advance(float frameTime) {
+    _frameTime = frameTime;
+    _accumulator += std::max(frameTime, 0.0f);
+    
+    const float step = OfficialConfig::PHYSICS_TIMESTEP;
+    _substeps = 0;
+    while (_accumulator >= step && _substeps < OfficialConfig::MAX_PHYSICS_SUBSTEPS) {
+        _accumulator -= step;
+        _substeps++;
+    }
+    
+    // Retard abandonné : garder seulement la fraction de pas pour l'interpolation
+    if (_accumulator >= step)
+        _accumulator = std::fmod(_accumulator, step);
+    
+    return _substeps;
+}
+
+void SimulationClock::reset() {
+    _started = false;
+    _frameTime = 0.0f;
+    _accumulator = 0.0f;
+    _substeps = 0;
+}
+
 PhysicsSystem::PhysicsSystem(TerrainManager* terrain)
     : _terrain(terrain)
     , _gravity(simd::make_float3(0.0f, OfficialConfig::GRAVITY, 0.0f))
-    , _timeAccumulator(0.0f)
     , _nextId(1)
+    , _integrationMode(IntegrationMode::Simd)
+    , _broadPhaseMode(BroadPhaseMode::SweepAndPrune)
+    , _broadPhaseStats{}
+    , _sweepAxis(0)
+    , _endpointsDirty(true)
 {
     _bodies.reserve(1024);
 }
@@ -1468,13 +1672,9 @@ PhysicsSystem::~PhysicsSystem() {
 }
 
 void PhysicsSystem::update(float deltaTime) {
-    _timeAccumulator += deltaTime;
-    
-    uint32_t substeps = 0;
-    while (_timeAccumulator >= OfficialConfig::PHYSICS_TIMESTEP && substeps < OfficialConfig::MAX_PHYSICS_SUBSTEPS) {
+    uint32_t substeps = _clock.advance(deltaTime);
+    for (uint32_t i = 0; i < substeps; i++) {
         fixedUpdate();
-        _timeAccumulator -= OfficialConfig::PHYSICS_TIMESTEP;
-        substeps++;
     }
 }
 
@@ -1483,6 +1683,9 @@ void PhysicsSystem::fixedUpdate() {
     
     const float dt = OfficialConfig::PHYSICS_TIMESTEP;
     
+    // Réécrire dans le store les vues modifiées depuis le dernier pas
+    flushViews();
+    
     // Appliquer gravité et intégrer vélocités
     integrateVelocities(dt);
     
@@ -1495,81 +1698,421 @@ void PhysicsSystem::fixedUpdate() {
     // Intégrer positions
     integratePositions(dt);
     
-    // Clear forces
-    for (auto& body : _bodies) {
-        if (!body.active) continue;
-        body.accumulatedForce = simd::make_float3(0.0f);
-        body.accumulatedTorque = simd::make_float3(0.0f);
+    clearForces();
+}
+
+void PhysicsSystem::integrate(float dt) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    
+    flushViews();
+    integrateVelocities(dt);
+    integratePositions(dt);
+    clearForces();
+}
+
+void PhysicsSystem::clearForces() {
+    std::fill(_store.forceX.begin(), _store.forceX.end(), 0.0f);
+    std::fill(_store.forceY.begin(), _store.forceY.end(), 0.0f);
+    std::fill(_store.forceZ.begin(), _store.forceZ.end(), 0.0f);
+    for (uint32_t i = 0; i < _bodies.size(); i++) {
+        if (!(_store.flags[i] & PhysicsBodyStore::Active)) continue;
+        _bodies[i].accumulatedTorque = simd::make_float3(0.0f);
     }
 }
 
+static inline simd::float4 loadFloat4(const float* src) {
+    simd::float4 value;
+    std::memcpy(&value, src, sizeof(float) * 4);
+    return value;
+}
+
+static inline void storeFloat4(float* dst, simd::float4 value) {
+    std::memcpy(dst, &value, sizeof(float) * 4);
+}
+
 void PhysicsSystem::integrateVelocities(float dt) {
-    for (auto& body : _bodies) {
-        if (!body.active || body.isStatic) continue;
-        
-        // Gravité
-        if (body.useGravity) {
-            body.linearVelocity += _gravity * dt;
+    const size_t count = _store.size();
+    size_t i = 0;
+    
+    // Les bodies statiques ou inactifs ont moveScale = 0 : ni gravité, ni force, ni damping
+    if (_integrationMode == IntegrationMode::Simd) {
+        for (; i + 4 <= count; i += 4) {
+            simd::float4 step = loadFloat4(&_store.moveScale[i]) * dt;
+            simd::float4 gravity = loadFloat4(&_store.gravityScale[i]) * dt;
+            simd::float4 invMass = loadFloat4(&_store.invMass[i]) * step;
+            simd::float4 damping = 1.0f - loadFloat4(&_store.damping[i]) * step;
+            
+            simd::float4 vx = loadFloat4(&_store.velocityX[i]) + gravity * _gravity.x + loadFloat4(&_store.forceX[i]) * invMass;
+            simd::float4 vy = loadFloat4(&_store.velocityY[i]) + gravity * _gravity.y + loadFloat4(&_store.forceY[i]) * invMass;
+            simd::float4 vz = loadFloat4(&_store.velocityZ[i]) + gravity * _gravity.z + loadFloat4(&_store.forceZ[i]) * invMass;
+            
+            storeFloat4(&_store.velocityX[i], vx * damping);
+            storeFloat4(&_store.velocityY[i], vy * damping);
+            storeFloat4(&_store.velocityZ[i], vz * damping);
         }
+    }
+    
+    for (; i < count; i++) {
+        if (_store.moveScale[i] == 0.0f) continue;
         
-        // Forces accumulées
-        body.linearVelocity += body.accumulatedForce * body.invMass * dt;
-        body.angularVelocity += body.accumulatedTorque * body.invInertia * dt;
+        float gravity = _store.gravityScale[i] * dt;
+        float invMass = _store.invMass[i] * dt;
+        float damping = 1.0f - _store.damping[i] * dt;
+        
+        _store.velocityX[i] = (_store.velocityX[i] + gravity * _gravity.x + _store.forceX[i] * invMass) * damping;
+        _store.velocityY[i] = (_store.velocityY[i] + gravity * _gravity.y + _store.forceY[i] * invMass) * damping;
+        _store.velocityZ[i] = (_store.velocityZ[i] + gravity * _gravity.z + _store.forceZ[i] * invMass) * damping;
+    }
+    
+    // Angulaire : reste dans PhysicsBody
+    for (uint32_t index = 0; index < count; index++) {
+        if (_store.moveScale[index] == 0.0f) continue;
+        PhysicsBody& body = _bodies[index];
         
-        // Damping
-        body.linearVelocity *= (1.0f - body.linearDamping * dt);
+        body.angularVelocity += body.accumulatedTorque * body.invInertia * dt;
         body.angularVelocity *= (1.0f - body.angularDamping * dt);
     }
 }
 
 void PhysicsSystem::integratePositions(float dt) {
-    for (auto& body : _bodies) {
-        if (!body.active || body.isStatic) continue;
+    const size_t count = _store.size();
+    size_t i = 0;
+    
+    if (_integrationMode == IntegrationMode::Simd) {
+        for (; i + 4 <= count; i += 4) {
+            simd::float4 step = loadFloat4(&_store.moveScale[i]) * dt;
+            
+            storeFloat4(&_store.positionX[i], loadFloat4(&_store.positionX[i]) + loadFloat4(&_store.velocityX[i]) * step);
+            storeFloat4(&_store.positionY[i], loadFloat4(&_store.positionY[i]) + loadFloat4(&_store.velocityY[i]) * step);
+            storeFloat4(&_store.positionZ[i], loadFloat4(&_store.positionZ[i]) + loadFloat4(&_store.velocityZ[i]) * step);
+        }
+    }
+    
+    for (; i < count; i++) {
+        if (_store.moveScale[i] == 0.0f) continue;
         
-        body.position += body.linearVelocity * dt;
+        _store.positionX[i] += _store.velocityX[i] * dt;
+        _store.positionY[i] += _store.velocityY[i] * dt;
+        _store.positionZ[i] += _store.velocityZ[i] * dt;
+    }
+    
+    // Rotation via quaternion
+    for (uint32_t index = 0; index < count; index++) {
+        if (_store.moveScale[index] == 0.0f) continue;
+        PhysicsBody& body = _bodies[index];
         
-        // Rotation via quaternion
         if (simd::length(body.angularVelocity) > 0.001f) {
             float angle = simd::length(body.angularVelocity) * dt;
             simd::float3 axis = simd::normalize(body.angularVelocity);
             simd::quatf deltaRot = simd::quatf(angle, axis);
             body.rotation = simd::normalize(deltaRot * body.rotation);
         }
-        
-        // Update bounds
-        body.bounds.min = body.position - simd::make_float3(body.radius);
-        body.bounds.max = body.position + simd::make_float3(body.radius);
     }
 }
 
+void PhysicsBodyStore::resize(size_t count) {
+    for (auto* array : { &positionX, &positionY, &positionZ, &velocityX, &velocityY, &velocityZ,
+                         &forceX, &forceY, &forceZ, &invMass, &damping, &moveScale, &gravityScale }) {
+        array->resize(count, 0.0f);
+    }
+    flags.resize(count, 0);
+}
+
+void PhysicsBodyStore::setFlags(uint32_t index, uint8_t value) {
+    flags[index] = value;
+    bool moving = (value & Active) && !(value & Static);
+    moveScale[index] = moving ? 1.0f : 0.0f;
+    gravityScale[index] = (moving && (value & UseGravity)) ? 1.0f : 0.0f;
+}
+
+void PhysicsSystem::syncView(uint32_t index) {
+    PhysicsBody& body = _bodies[index];
+    uint8_t flags = _store.flags[index];
+    
+    body.active = flags & PhysicsBodyStore::Active;
+    body.isStatic = flags & PhysicsBodyStore::Static;
+    body.useGravity = flags & PhysicsBodyStore::UseGravity;
+    body.position = _store.position(index);
+    body.linearVelocity = _store.velocity(index);
+    body.accumulatedForce = _store.force(index);
+    body.invMass = _store.invMass[index];
+    body.linearDamping = _store.damping[index];
+    updateBounds(index);
+}
+
+void PhysicsSystem::flushView(uint32_t index) {
+    const PhysicsBody& body = _bodies[index];
+    uint8_t flags = (body.active ? PhysicsBodyStore::Active : 0)
+                  | (body.isStatic ? PhysicsBodyStore::Static : 0)
+                  | (body.useGravity ? PhysicsBodyStore::UseGravity : 0);
+    
+    _store.setFlags(index, flags);
+    _store.setPosition(index, body.position);
+    _store.setVelocity(index, body.linearVelocity);
+    _store.setForce(index, body.accumulatedForce);
+    _store.invMass[index] = body.invMass;
+    _store.damping[index] = body.linearDamping;
+}
+
+void PhysicsSystem::flushViews() {
+    for (uint32_t index : _dirtyViews) {
+        flushView(index);
+        _viewDirty[index] = 0;
+    }
+    _dirtyViews.clear();
+}
+
+// Une vue rendue par getBody() et pas encore réécrite est plus récente que le store
+simd::float3 PhysicsSystem::bodyPosition(uint32_t index) const {
+    return _viewDirty[index] ? _bodies[index].position : _store.position(index);
+}
+
+void PhysicsSystem::updateBounds(uint32_t index) {
+    PhysicsBody& body = _bodies[index];
+    simd::float3 position = bodyPosition(index);
+    simd::float3 extents = body.shape == PhysicsShape::Box ? body.halfExtents : simd::make_float3(body.radius);
+    body.bounds.min = position - extents;
+    body.bounds.max = position + extents;
+}
+
 void PhysicsSystem::detectCollisions() {
     _contacts.clear();
     
-    for (auto& body : _bodies) {
-        if (!body.active || body.isStatic) continue;
+    for (uint32_t i = 0; i < _bodies.size(); i++) {
+        uint8_t flags = _store.flags[i];
+        if (!(flags & PhysicsBodyStore::Active)) continue;
+        
+        // Les bodies statiques peuvent être déplacés à la main entre deux pas
+        updateBounds(i);
         
         // Collision avec terrain
-        collideWithTerrain(body);
+        if (!(flags & PhysicsBodyStore::Static))
+            collideWithTerrain(i);
+    }
+    
+    // Collision body-body : broad phase puis narrow phase
+    _broadPhaseStats = {};
+    _candidatePairs.clear();
+    if (_broadPhaseMode == BroadPhaseMode::SweepAndPrune)
+        broadPhaseSweepAndPrune();
+    else
+        broadPhaseAllPairs();
+    _broadPhaseStats.pairsFound = static_cast<uint32_t>(_candidatePairs.size());
+    
+    for (const auto& [indexA, indexB] : _candidatePairs) {
+        CollisionContact contact;
+        if (narrowPhase(_bodies[indexA], _bodies[indexB], contact)) {
+            _contacts.push_back(contact);
+            _broadPhaseStats.contacts++;
+        }
+    }
+}
+
+// Sort and sweep sur un axe : les extrémités restent triées d'un pas à l'autre,
+// le tri par insertion ne paie donc que les quelques échanges dus aux déplacements
+void PhysicsSystem::broadPhaseSweepAndPrune() {
+    // Axe de plus grande variance des centres ; en changer oblige à un tri complet
+    simd::float3 sum = simd::make_float3(0.0f);
+    simd::float3 sumSq = simd::make_float3(0.0f);
+    uint32_t count = 0;
+    for (const auto& body : _bodies) {
+        if (!body.active) continue;
+        simd::float3 center = (body.bounds.min + body.bounds.max) * 0.5f;
+        sum += center;
+        sumSq += center * center;
+        count++;
+    }
+    if (count < 2) return;
+    
+    simd::float3 mean = sum / (float)count;
+    simd::float3 variance = sumSq / (float)count - mean * mean;
+    int axis = 0;
+    if (variance.y > variance[axis]) axis = 1;
+    if (variance.z > variance[axis]) axis = 2;
+    
+    bool fullSort = false;
+    if (axis != _sweepAxis) {
+        _sweepAxis = axis;
+        fullSort = true;
+    }
+    
+    if (_endpointsDirty) {
+        _endpoints.clear();
+        for (const auto& body : _bodies) {
+            if (!body.active) continue;
+            SweepEndpoint endpoint;
+            endpoint.value = 0.0f;
+            endpoint.bodyIndex = body.id - 1;
+            endpoint.isMax = 0;
+            _endpoints.push_back(endpoint);
+            endpoint.isMax = 1;
+            _endpoints.push_back(endpoint);
+        }
+        _endpointsDirty = false;
+        fullSort = true;
+    }
+    
+    for (auto& endpoint : _endpoints) {
+        const Types::AABB& bounds = _bodies[endpoint.bodyIndex].bounds;
+        endpoint.value = endpoint.isMax ? bounds.max[axis] : bounds.min[axis];
+    }
+    
+    // À valeur égale, les min passent avant les max : des AABB qui se touchent se chevauchent (cf. AABB::intersects)
+    auto endpointLess = [](const SweepEndpoint& a, const SweepEndpoint& b) {
+        return a.value < b.value || (a.value == b.value && a.isMax < b.isMax);
+    };
+    
+    if (fullSort) {
+        std::sort(_endpoints.begin(), _endpoints.end(), endpointLess);
+    } else {
+        for (size_t i = 1; i < _endpoints.size(); i++) {
+            SweepEndpoint endpoint = _endpoints[i];
+            size_t j = i;
+            while (j > 0 && endpointLess(endpoint, _endpoints[j - 1])) {
+                _endpoints[j] = _endpoints[j - 1];
+                j--;
+            }
+            _endpoints[j] = endpoint;
+        }
+    }
+    
+    _sweepActive.clear();
+    _sweepSlot.resize(_bodies.size());
+    
+    for (const auto& endpoint : _endpoints) {
+        uint32_t index = endpoint.bodyIndex;
+        
+        if (endpoint.isMax) {
+            // Retrait en O(1) par échange avec le dernier
+            uint32_t slot = _sweepSlot[index];
+            uint32_t last = _sweepActive.back();
+            _sweepActive[slot] = last;
+            _sweepSlot[last] = slot;
+            _sweepActive.pop_back();
+            continue;
+        }
+        
+        const PhysicsBody& body = _bodies[index];
+        for (uint32_t other : _sweepActive) {
+            const PhysicsBody& otherBody = _bodies[other];
+            if (body.isStatic && otherBody.isStatic) continue;
+            
+            _broadPhaseStats.pairsTested++;
+            if (body.bounds.intersects(otherBody.bounds)) {
+                _candidatePairs.emplace_back(std::min(index, other), std::max(index, other));
+            }
+        }
+        _sweepSlot[index] = static_cast<uint32_t>(_sweepActive.size());
+        _sweepActive.push_back(index);
+    }
+}
+
+void PhysicsSystem::broadPhaseAllPairs() {
+    for (size_t i = 0; i < _bodies.size(); i++) {
+        const PhysicsBody& a = _bodies[i];
+        if (!a.active) continue;
+        
+        for (size_t j = i + 1; j < _bodies.size(); j++) {
+            const PhysicsBody& b = _bodies[j];
+            if (!b.active || (a.isStatic && b.isStatic)) continue;
+            
+            _broadPhaseStats.pairsTested++;
+            if (a.bounds.intersects(b.bounds)) {
+                _candidatePairs.emplace_back(static_cast<uint32_t>(i), static_cast<uint32_t>(j));
+            }
+        }
+    }
+}
+
+// Sphère/sphère, boîte/boîte (alignées sur les axes, la rotation est ignorée) et sphère/boîte
+bool PhysicsSystem::narrowPhase(const PhysicsBody& a, const PhysicsBody& b, CollisionContact& contact) const {
+    contact.bodyA = a.id;
+    contact.bodyB = b.id;
+    
+    const simd::float3 positionA = _store.position(a.id - 1);
+    const simd::float3 positionB = _store.position(b.id - 1);
+    
+    if (a.shape == PhysicsShape::Sphere && b.shape == PhysicsShape::Sphere) {
+        simd::float3 delta = positionA - positionB;
+        float distSq = simd::dot(delta, delta);
+        float radii = a.radius + b.radius;
+        if (distSq >= radii * radii) return false;
+        
+        float dist = std::sqrt(distSq);
+        contact.normal = dist > 1e-6f ? delta / dist : simd::make_float3(0.0f, 1.0f, 0.0f);
+        contact.penetration = radii - dist;
+        contact.point = positionB + contact.normal * b.radius;
+        return true;
+    }
+    
+    if (a.shape == PhysicsShape::Box && b.shape == PhysicsShape::Box) {
+        simd::float3 overlap = simd::min(a.bounds.max, b.bounds.max) - simd::max(a.bounds.min, b.bounds.min);
+        if (overlap.x <= 0.0f || overlap.y <= 0.0f || overlap.z <= 0.0f) return false;
+        
+        int axis = 0;
+        if (overlap.y < overlap[axis]) axis = 1;
+        if (overlap.z < overlap[axis]) axis = 2;
         
-        // TODO: Collision body-body avec broad phase
+        contact.normal = simd::make_float3(0.0f);
+        contact.normal[axis] = positionA[axis] >= positionB[axis] ? 1.0f : -1.0f;
+        contact.penetration = overlap[axis];
+        contact.point = (simd::max(a.bounds.min, b.bounds.min) + simd::min(a.bounds.max, b.bounds.max)) * 0.5f;
+        return true;
+    }
+    
+    // Sphère contre boîte : point de la boîte le plus proche du centre
+    const PhysicsBody& sphere = a.shape == PhysicsShape::Sphere ? a : b;
+    const PhysicsBody& box = a.shape == PhysicsShape::Sphere ? b : a;
+    const simd::float3 center = (&sphere == &a) ? positionA : positionB;
+    
+    simd::float3 closest = simd::clamp(center, box.bounds.min, box.bounds.max);
+    simd::float3 delta = center - closest;
+    float distSq = simd::dot(delta, delta);
+    if (distSq >= sphere.radius * sphere.radius) return false;
+    
+    simd::float3 normal;
+    float penetration;
+    if (distSq > 1e-12f) {
+        float dist = std::sqrt(distSq);
+        normal = delta / dist;
+        penetration = sphere.radius - dist;
+    } else {
+        // Centre dans la boîte : sortie par la face la plus proche
+        simd::float3 toMin = center - box.bounds.min;
+        simd::float3 toMax = box.bounds.max - center;
+        simd::float3 exit = simd::min(toMin, toMax);
+        int axis = 0;
+        if (exit.y < exit[axis]) axis = 1;
+        if (exit.z < exit[axis]) axis = 2;
+        normal = simd::make_float3(0.0f);
+        normal[axis] = toMin[axis] < toMax[axis] ? -1.0f : 1.0f;
+        penetration = exit[axis] + sphere.radius;
     }
+    
+    // normal va de la boîte vers la sphère ; le contact veut B vers A
+    contact.normal = (&sphere == &a) ? normal : -normal;
+    contact.penetration = penetration;
+    contact.point = closest;
+    return true;
 }
 
-void PhysicsSystem::collideWithTerrain(PhysicsBody& body) {
+void PhysicsSystem::collideWithTerrain(uint32_t index) {
+    PhysicsBody& body = _bodies[index];
     body.onGround = false;
     
     if (!_terrain) return;
     
-    float terrainHeight = _terrain->getHeightAt(body.position.x, body.position.z);
-    float penetration = (terrainHeight + body.radius) - body.position.y;
+    simd::float3 position = _store.position(index);
+    float terrainHeight = _terrain->getHeightAt(position.x, position.z);
+    float penetration = (terrainHeight + body.radius) - position.y;
     
     if (penetration > 0.0f) {
-        simd::float3 normal = _terrain->getNormalAt(body.position.x, body.position.z);
+        simd::float3 normal = _terrain->getNormalAt(position.x, position.z);
         
         CollisionContact contact;
         contact.bodyA = body.id;
         contact.bodyB = 0; // Terrain
-        contact.point = body.position - simd::make_float3(0.0f, body.radius, 0.0f);
+        contact.point = position - simd::make_float3(0.0f, body.radius, 0.0f);
         contact.normal = normal;
         contact.penetration = penetration;
         
@@ -1582,33 +2125,78 @@ void PhysicsSystem::collideWithTerrain(PhysicsBody& body) {
 
 void PhysicsSystem::resolveCollisions() {
     for (const auto& contact : _contacts) {
-        PhysicsBody* bodyA = getBody(contact.bodyA);
-        if (!bodyA) continue;
+        uint32_t indexA = contact.bodyA - 1;
+        if (!(_store.flags[indexA] & PhysicsBodyStore::Active)) continue;
+        const PhysicsBody& bodyA = _bodies[indexA];
         
         // Terrain collision (bodyB = 0)
         if (contact.bodyB == 0) {
             // Position correction
-            bodyA->position += contact.normal * contact.penetration;
+            _store.setPosition(indexA, _store.position(indexA) + contact.normal * contact.penetration);
             
             // Velocity reflection
-            float vn = simd::dot(bodyA->linearVelocity, contact.normal);
+            simd::float3 velocity = _store.velocity(indexA);
+            float vn = simd::dot(velocity, contact.normal);
             
             if (vn < 0.0f) {
                 simd::float3 vNormal = contact.normal * vn;
-                simd::float3 vTangent = bodyA->linearVelocity - vNormal;
+                simd::float3 vTangent = velocity - vNormal;
                 
                 // Restitution (bounce)
-                vNormal *= -bodyA->restitution;
+                vNormal *= -bodyA.restitution;
                 
                 // Friction
-                float frictionCoeff = bodyA->friction;
+                float frictionCoeff = bodyA.friction;
                 if (simd::length(vTangent) > 0.001f) {
                     vTangent *= std::max(0.0f, 1.0f - frictionCoeff);
                 }
                 
-                bodyA->linearVelocity = vNormal + vTangent;
+                _store.setVelocity(indexA, vNormal + vTangent);
             }
+            continue;
+        }
+        
+        // Body contre body : correction de position et impulsion répartis selon la masse inverse
+        uint32_t indexB = contact.bodyB - 1;
+        if (!(_store.flags[indexB] & PhysicsBodyStore::Active)) continue;
+        const PhysicsBody& bodyB = _bodies[indexB];
+        
+        float invMassA = _store.invMass[indexA] * _store.moveScale[indexA];
+        float invMassB = _store.invMass[indexB] * _store.moveScale[indexB];
+        float invMassSum = invMassA + invMassB;
+        if (invMassSum <= 0.0f) continue;
+        
+        simd::float3 correction = contact.normal * (contact.penetration / invMassSum);
+        _store.setPosition(indexA, _store.position(indexA) + correction * invMassA);
+        _store.setPosition(indexB, _store.position(indexB) - correction * invMassB);
+        
+        simd::float3 velocityA = _store.velocity(indexA);
+        simd::float3 velocityB = _store.velocity(indexB);
+        simd::float3 relativeVelocity = velocityA - velocityB;
+        float vn = simd::dot(relativeVelocity, contact.normal);
+        if (vn >= 0.0f) continue;
+        
+        float restitution = std::min(bodyA.restitution, bodyB.restitution);
+        float j = -(1.0f + restitution) * vn / invMassSum;
+        simd::float3 impulse = contact.normal * j;
+        velocityA += impulse * invMassA;
+        velocityB -= impulse * invMassB;
+        
+        // Friction de Coulomb sur la vitesse tangentielle restante
+        relativeVelocity = velocityA - velocityB;
+        simd::float3 tangent = relativeVelocity - contact.normal * simd::dot(relativeVelocity, contact.normal);
+        float tangentLength = simd::length(tangent);
+        if (tangentLength > 0.001f) {
+            tangent /= tangentLength;
+            float jt = -simd::dot(relativeVelocity, tangent) / invMassSum;
+            float maxFriction = j * std::sqrt(bodyA.friction * bodyB.friction);
+            jt = std::max(-maxFriction, std::min(jt, maxFriction));
+            velocityA += tangent * (jt * invMassA);
+            velocityB -= tangent * (jt * invMassB);
         }
+        
+        _store.setVelocity(indexA, velocityA);
+        _store.setVelocity(indexB, velocityB);
     }
 }
 
@@ -1623,7 +2211,10 @@ uint32_t PhysicsSystem::createBody() {
     } else {
         id = _nextId++;
         _bodies.emplace_back();
+        _store.resize(_bodies.size());
+        _viewDirty.resize(_bodies.size(), 0);
     }
+    _endpointsDirty = true;
     
     PhysicsBody& body = _bodies[id - 1];
     body.id = id;
@@ -1643,11 +2234,15 @@ uint32_t PhysicsSystem::createBody() {
     body.restitution = 0.3f;
     body.linearDamping = 0.1f;
     body.angularDamping = 0.1f;
+    body.shape = PhysicsShape::Sphere;
     body.radius = 0.5f;
+    body.halfExtents = simd::make_float3(0.5f);
     body.onGround = false;
     body.groundNormal = simd::make_float3(0.0f, 1.0f, 0.0f);
     body.accumulatedForce = simd::make_float3(0.0f);
     body.accumulatedTorque = simd::make_float3(0.0f);
+    flushView(id - 1);
+    updateBounds(id - 1);
     
     return id;
 }
@@ -1658,20 +2253,41 @@ void PhysicsSystem::destroyBody(uint32_t id) {
     if (id == 0 || id > _bodies.size()) return;
     
     _bodies[id - 1].active = false;
+    _store.setFlags(id - 1, 0);
     _freeIds.push_back(id);
+    _endpointsDirty = true;
 }
 
 PhysicsBody* PhysicsSystem::getBody(uint32_t id) {
     if (id == 0 || id > _bodies.size()) return nullptr;
-    PhysicsBody& body = _bodies[id - 1];
+    uint32_t index = id - 1;
+    
+    if (!_viewDirty[index]) {
+        if (!(_store.flags[index] & PhysicsBodyStore::Active)) return nullptr;
+        syncView(index);
+        _viewDirty[index] = 1;
+        _dirtyViews.push_back(index);
+    }
+    
+    PhysicsBody& body = _bodies[index];
     return body.active ? &body : nullptr;
 }
 
+// Sans vue ouverte, la force va directement dans le store : ouvrir une vue la ferait réécrire en entier au pas suivant
 void PhysicsSystem::applyForce(uint32_t id, simd::float3 force) {
-    PhysicsBody* body = getBody(id);
-    if (body && !body->isStatic) {
-        body->accumulatedForce += force;
+    if (id == 0 || id > _bodies.size()) return;
+    uint32_t index = id - 1;
+    
+    if (_viewDirty[index]) {
+        PhysicsBody& body = _bodies[index];
+        if (body.active && !body.isStatic) {
+            body.accumulatedForce += force;
+        }
+        return;
     }
+    // moveScale = 0 : inactif ou statique
+    if (_store.moveScale[index] == 0.0f) return;
+    _store.setForce(index, _store.force(index) + force);
 }
 
 void PhysicsSystem::applyForceAtPoint(uint32_t id, simd::float3 force, simd::float3 point) {
@@ -1684,10 +2300,18 @@ void PhysicsSystem::applyForceAtPoint(uint32_t id, simd::float3 force, simd::flo
 }
 
 void PhysicsSystem::applyImpulse(uint32_t id, simd::float3 impulse) {
-    PhysicsBody* body = getBody(id);
-    if (body && !body->isStatic) {
-        body->linearVelocity += impulse * body->invMass;
+    if (id == 0 || id > _bodies.size()) return;
+    uint32_t index = id - 1;
+    
+    if (_viewDirty[index]) {
+        PhysicsBody& body = _bodies[index];
+        if (body.active && !body.isStatic) {
+            body.linearVelocity += impulse * body.invMass;
+        }
+        return;
     }
+    if (_store.moveScale[index] == 0.0f) return;
+    _store.setVelocity(index, _store.velocity(index) + impulse * _store.invMass[index]);
 }
 
 void PhysicsSystem::applyTorque(uint32_t id, simd::float3 torque) {
@@ -1712,11 +2336,13 @@ bool PhysicsSystem::raycast(const Types::Ray& ray, Types::RayHit& hit, float max
     // Raycast bodies
     std::lock_guard<std::mutex> lock(_mutex);
     
-    for (const auto& body : _bodies) {
+    for (uint32_t i = 0; i < _bodies.size(); i++) {
+        const PhysicsBody& body = _bodies[i];
         if (!body.active) continue;
         
         // Sphere intersection
-        simd::float3 oc = ray.origin - body.position;
+        simd::float3 position = bodyPosition(i);
+        simd::float3 oc = ray.origin - position;
         float b = simd::dot(oc, ray.direction);
         float c = simd::dot(oc, oc) - body.radius * body.radius;
         float discriminant = b * b - c;
@@ -1727,7 +2353,7 @@ bool PhysicsSystem::raycast(const Types::Ray& ray, Types::RayHit& hit, float max
                 hit.hit = true;
                 hit.distance = t;
                 hit.position = ray.origin + ray.direction * t;
-                hit.normal = simd::normalize(hit.position - body.position);
+                hit.normal = simd::normalize(hit.position - position);
                 hit.materialId = body.id;
             }
         }
@@ -1743,10 +2369,11 @@ void PhysicsSystem::overlapSphere(simd::float3 center, float radius, std::vector
     
     float radiusSq = radius * radius;
     
-    for (const auto& body : _bodies) {
+    for (uint32_t i = 0; i < _bodies.size(); i++) {
+        const PhysicsBody& body = _bodies[i];
         if (!body.active) continue;
         
-        simd::float3 diff = body.position - center;
+        simd::float3 diff = bodyPosition(i) - center;
         float distSq = simd::dot(diff, diff);
         float combinedRadius = radius + body.radius;
         
@@ -12,6 +12,7 @@
 #include <QuartzCore/QuartzCore.hpp>
 
 #include "RMDLMathUtils.hpp"
+#include "RMDLFrustumCulling.hpp"
 #include "Utils/NoiseGen.hpp"
 
 #include <dispatch/dispatch.h>
@@ -27,9 +28,11 @@
 #include <cmath>
 #include <algorithm>
 #include <cstdint>
+#include <cstring>
 #include <array>
 #include <string>
 #include <atomic>
+#include <chrono>
 #include <unordered_map>
 #include <unordered_set>
 
@@ -50,6 +53,7 @@ constexpr uint32_t CHUNK_HEIGHT = 256;
 constexpr float TERRAIN_SCALE = 1.0f;
 constexpr uint32_t VIEW_DISTANCE_CHUNKS = 12;
 constexpr uint32_t MAX_LOADED_CHUNKS = 512;
+constexpr float CHUNK_UNLOAD_DISTANCE = VIEW_DISTANCE_CHUNKS * CHUNK_SIZE * 1.5f;
 
 constexpr uint32_t LOD_LEVELS = 5;
 constexpr float LOD_DISTANCES[LOD_LEVELS] = { 64.0f, 128.0f, 256.0f, 512.0f, 1024.0f };
@@ -119,8 +123,9 @@ namespace Types {
         
         uint64_t hash() const
         {
-            uint64_t hx = static_cast<uint64_t>(x + 0x7FFFFFFF);
-            uint64_t hz = static_cast<uint64_t>(z + 0x7FFFFFFF);
+            // En non signé : x + 0x7FFFFFFF débordait pour x > 0 et l'extension de signe mélangeait x et z
+            uint64_t hx = static_cast<uint32_t>(x) + 0x7FFFFFFFu;
+            uint64_t hz = static_cast<uint32_t>(z) + 0x7FFFFFFFu;
             return (hx << 32) | hz;
         }
     };
@@ -378,6 +383,30 @@ struct TerrainGenerationRequest {
     }
 };
 
+// Tas binaire min indexé par hash de chunk : les priorités ne sont plus figées à
+// l'insertion, annuler ou changer la priorité d'une requête coûte O(log n)
+class TerrainRequestQueue {
+public:
+    bool empty() const { return _heap.empty(); }
+    size_t size() const { return _heap.size(); }
+    bool contains(uint64_t key) const { return _slots.find(key) != _slots.end(); }
+    const std::vector<TerrainGenerationRequest>& requests() const { return _heap; }
+    
+    // Une requête déjà en attente pour le même chunk est remplacée (renvoie false)
+    bool push(TerrainGenerationRequest request);
+    TerrainGenerationRequest pop();
+    bool remove(uint64_t key);
+    bool updatePriority(uint64_t key, uint32_t priority);
+    
+private:
+    void siftUp(size_t index);
+    void siftDown(size_t index);
+    void swapNodes(size_t a, size_t b);
+    
+    std::vector<TerrainGenerationRequest> _heap;
+    std::unordered_map<uint64_t, size_t> _slots;   // hash -> position dans _heap
+};
+
 class TerrainGenerator {
 public:
     TerrainGenerator(MTL::Device* device, MTL::CommandQueue* queue,
@@ -387,7 +416,13 @@ public:
     void requestChunk(Types::ChunkCoord coord, uint32_t priority,
                      std::function<void(std::shared_ptr<ChunkMap>)> callback);
     
-    void cancelRequest(Types::ChunkCoord coord);
+    // false si la requête n'est plus en attente (déjà prise par un worker)
+    bool cancelRequest(Types::ChunkCoord coord);
+    bool reprioritizeRequest(Types::ChunkCoord coord, uint32_t priority);
+    // Recalcule la priorité de toutes les requêtes en attente sous un seul verrou ;
+    // priorityOf renvoie false pour annuler, les chunks annulés sont ajoutés à cancelled
+    void refreshRequests(const std::function<bool(Types::ChunkCoord, uint32_t&)>& priorityOf,
+                         std::vector<Types::ChunkCoord>& cancelled);
     void processRequests();
     
     void setLODLevel(uint32_t lod) { _currentLOD = lod; }
@@ -395,6 +430,7 @@ public:
     // Statistiques
     uint32_t getPendingCount() const { return _pendingCount.load(); }
     uint32_t getGeneratedCount() const { return _generatedCount.load(); }
+    uint32_t getCancelledCount() const { return _cancelledCount.load(); }
 
 private:
     void workerThread();
@@ -413,7 +449,7 @@ private:
     
     // Threading
     std::vector<std::thread> _workers;
-    std::priority_queue<TerrainGenerationRequest> _requestQueue;
+    TerrainRequestQueue _requestQueue;
     std::mutex _queueMutex;
     std::condition_variable _queueCondition;
     std::atomic<bool> _running;
@@ -427,6 +463,7 @@ private:
     uint32_t _currentLOD;
     std::atomic<uint32_t> _pendingCount;
     std::atomic<uint32_t> _generatedCount;
+    std::atomic<uint32_t> _cancelledCount;
 };
 
 struct ChunkCoordHash {
@@ -474,17 +511,31 @@ private:
     TerrainGenerator* _generator;
     
     std::unordered_map<Types::ChunkCoord, std::shared_ptr<ChunkMap>, ChunkCoordHash> _chunks;
-    std::unordered_set<uint64_t> _pendingChunks;
+    std::unordered_map<uint64_t, Types::ChunkCoord> _pendingChunks;
+    std::vector<Types::ChunkCoord> _cancelledChunks;
     mutable std::mutex _chunksMutex;
     
     simd::float3 _lastCameraPosition;
     uint32_t _visibleChunkCount;
     
+    // Culling : AABB (hauteurs min/max du heightfield) de chaque chunk prêt, testées par lots
+    culling::BoxCuller _chunkCuller;
+    std::vector<ChunkMap*> _cullCandidates;
+    std::vector<uint32_t> _visibleChunks;
+    
     // Render state
     MTL::RenderPipelineState* _terrainPipeline;
     MTL::DepthStencilState* _depthState;
 };
 
+enum class PhysicsShape : uint8_t {
+    Sphere,     // radius
+    Box         // halfExtents, alignée sur les axes
+};
+
+// Vue sur un body. Position, linearVelocity, accumulatedForce, invMass, linearDamping
+// et les flags vivent dans PhysicsBodyStore : getBody() les recopie ici, et ce qui y
+// est modifié est réécrit dans le store au pas suivant (durée de vie : voir PhysicsSystem::getBody)
 struct PhysicsBody {
     uint32_t id;
     bool active;
@@ -511,8 +562,10 @@ struct PhysicsBody {
     float angularDamping;
     
     // Collision
+    PhysicsShape shape;
     Types::AABB bounds;
     float radius;
+    simd::float3 halfExtents;
     bool onGround;
     simd::float3 groundNormal;
     
@@ -525,10 +578,86 @@ struct CollisionContact {
     uint32_t bodyA;
     uint32_t bodyB;
     simd::float3 point;
-    simd::float3 normal;
+    simd::float3 normal;    // de B vers A : A est repoussé le long de normal
     float penetration;
 };
 
+// Champs chauds des bodies en structure of arrays, indexés par id - 1 comme _bodies :
+// l'intégration lit des lignes de cache pleines et avance par blocs de 4 bodies
+struct PhysicsBodyStore {
+    enum Flags : uint8_t {
+        Active      = 1 << 0,
+        Static      = 1 << 1,
+        UseGravity  = 1 << 2
+    };
+    
+    std::vector<float> positionX, positionY, positionZ;
+    std::vector<float> velocityX, velocityY, velocityZ;
+    std::vector<float> forceX, forceY, forceZ;
+    std::vector<float> invMass;
+    std::vector<float> damping;
+    std::vector<uint8_t> flags;
+    
+    // Dérivés de flags pour intégrer sans branche : 1 si le body bouge / subit la gravité, 0 sinon
+    std::vector<float> moveScale;
+    std::vector<float> gravityScale;
+    
+    size_t size() const { return flags.size(); }
+    void resize(size_t count);
+    void setFlags(uint32_t index, uint8_t value);
+    
+    simd::float3 position(uint32_t index) const { return simd::make_float3(positionX[index], positionY[index], positionZ[index]); }
+    simd::float3 velocity(uint32_t index) const { return simd::make_float3(velocityX[index], velocityY[index], velocityZ[index]); }
+    simd::float3 force(uint32_t index) const { return simd::make_float3(forceX[index], forceY[index], forceZ[index]); }
+    
+    void setPosition(uint32_t index, simd::float3 value) { positionX[index] = value.x; positionY[index] = value.y; positionZ[index] = value.z; }
+    void setVelocity(uint32_t index, simd::float3 value) { velocityX[index] = value.x; velocityY[index] = value.y; velocityZ[index] = value.z; }
+    void setForce(uint32_t index, simd::float3 value) { forceX[index] = value.x; forceY[index] = value.y; forceZ[index] = value.z; }
+};
+
+enum class IntegrationMode : uint8_t {
+    Simd,       // blocs de 4 bodies
+    Scalar      // un body à la fois, pour comparer
+};
+
+enum class BroadPhaseMode : uint8_t {
+    SweepAndPrune,
+    AllPairs        // référence O(n²) pour comparer
+};
+
+struct BroadPhaseStats {
+    uint32_t pairsTested;   // tests de chevauchement AABB effectués
+    uint32_t pairsFound;    // paires candidates passées à la narrow phase
+    uint32_t contacts;      // contacts body-body retenus par la narrow phase
+};
+
+// Horloge de simulation : mesure le temps réel d'une frame et le découpe en pas fixes
+// de PHYSICS_TIMESTEP. Au-delà de MAX_PHYSICS_SUBSTEPS le retard est abandonné, une
+// frame lente ralentit la simulation au lieu de déclencher toujours plus de pas.
+class SimulationClock {
+public:
+    SimulationClock();
+    
+    // Temps réel écoulé depuis le tick précédent (0 au premier appel)
+    float tick();
+    // Ajoute frameTime à l'accumulateur, renvoie le nombre de pas fixes à jouer
+    uint32_t advance(float frameTime);
+    void reset();
+    
+    float frameTime() const { return _frameTime; }
+    float fixedStep() const { return OfficialConfig::PHYSICS_TIMESTEP; }
+    uint32_t substeps() const { return _substeps; }
+    // Position entre les deux derniers états physiques, dans [0, 1)
+    float alpha() const { return _accumulator / OfficialConfig::PHYSICS_TIMESTEP; }
+    
+private:
+    std::chrono::steady_clock::time_point _lastTick;
+    bool _started;
+    float _frameTime;
+    float _accumulator;
+    uint32_t _substeps;
+};
+
 class PhysicsSystem {
 public:
     PhysicsSystem(TerrainManager* terrain);
@@ -537,10 +666,17 @@ public:
     // Simulation
     void update(float deltaTime);
     void fixedUpdate();
+    // Un pas d'intégration seul (vitesses puis positions), sans détection ni résolution de collisions
+    void integrate(float dt);
     
     // Bodies
     uint32_t createBody();
     void destroyBody(uint32_t id);
+    // Vue modifiable sur le body, nullptr s'il est détruit. Le pointeur ne vaut que jusqu'au prochain
+    // update/fixedUpdate, qui réécrit la vue dans le store puis cesse de la suivre (une écriture plus
+    // tardive serait perdue, une lecture rendrait l'état d'avant le pas), ou jusqu'au prochain createBody
+    // (_bodies peut être réalloué). D'une frame à l'autre, garder l'id et rappeler getBody, ou passer par
+    // applyForce/applyImpulse. Sans verrou : à appeler depuis le thread de la simulation.
     PhysicsBody* getBody(uint32_t id);
     
     // Forces
@@ -556,22 +692,60 @@ public:
     // Configuration
     void setGravity(simd::float3 gravity) { _gravity = gravity; }
     simd::float3 getGravity() const { return _gravity; }
+    void setBroadPhaseMode(BroadPhaseMode mode) { _broadPhaseMode = mode; }
+    void setIntegrationMode(IntegrationMode mode) { _integrationMode = mode; }
+    const BroadPhaseStats& getBroadPhaseStats() const { return _broadPhaseStats; }
+    // Paires (index = id - 1) retenues par la broad phase au dernier pas, avant la narrow phase
+    const std::vector<std::pair<uint32_t, uint32_t>>& getCandidatePairs() const { return _candidatePairs; }
 
 private:
+    // Extrémité d'AABB sur l'axe de balayage ; bodyIndex = id - 1
+    struct SweepEndpoint {
+        float value;
+        uint32_t bodyIndex : 31;
+        uint32_t isMax : 1;
+    };
+    
     void integrateVelocities(float dt);
     void integratePositions(float dt);
+    void clearForces();
     void detectCollisions();
     void resolveCollisions();
-    void collideWithTerrain(PhysicsBody& body);
+    void collideWithTerrain(uint32_t index);
+    
+    // Synchronisation des vues PhysicsBody avec le store
+    void syncView(uint32_t index);
+    void flushView(uint32_t index);
+    void flushViews();
+    simd::float3 bodyPosition(uint32_t index) const;
+    
+    void updateBounds(uint32_t index);
+    void broadPhaseSweepAndPrune();
+    void broadPhaseAllPairs();
+    bool narrowPhase(const PhysicsBody& a, const PhysicsBody& b, CollisionContact& contact) const;
     
     TerrainManager* _terrain;
     
     std::vector<PhysicsBody> _bodies;
+    PhysicsBodyStore _store;
+    std::vector<uint8_t> _viewDirty;        // vue modifiable rendue par getBody(), à réécrire dans _store
+    std::vector<uint32_t> _dirtyViews;
+    IntegrationMode _integrationMode;
     std::vector<uint32_t> _freeIds;
     std::vector<CollisionContact> _contacts;
     
+    // Broad phase : extrémités triées gardées d'un pas à l'autre, retriées par insertion
+    BroadPhaseMode _broadPhaseMode;
+    BroadPhaseStats _broadPhaseStats;
+    std::vector<SweepEndpoint> _endpoints;
+    int _sweepAxis;
+    bool _endpointsDirty;
+    std::vector<uint32_t> _sweepActive;
+    std::vector<uint32_t> _sweepSlot;      // position de chaque body dans _sweepActive
+    std::vector<std::pair<uint32_t, uint32_t>> _candidatePairs;
+    
     simd::float3 _gravity;
-    float _timeAccumulator;
+    SimulationClock _clock;
     uint32_t _nextId;
     
     mutable std::mutex _mutex;
@@ -628,7 +628,7 @@ vertex BlockFragIn blockVertexOptimized(
     out.color = in.color * inst.tintColor;
     out.damage = inst.params.x;
     out.powered = inst.params.y;
-    out.time = inst.params.z;
+    out.time = uniforms.time + inst.params.z;
     out.textureIndex = uint(inst.params.w);
     
     return out;
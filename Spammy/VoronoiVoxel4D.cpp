@@ -312,6 +312,7 @@ void VoronoiVoxel4D::generateSitesForRegion(int chunkX, int chunkZ, float time)
         site.influence = distInfluence(localRng);
         sites.push_back(site);
     }
+    siteTree.build(sites);
 }
 
 void VoronoiVoxel4D::generateSitesForRegion2(int chunkX, int chunkZ, float time)
@@ -366,6 +367,181 @@ void VoronoiVoxel4D::generateSitesForRegion2(int chunkX, int chunkZ, float time)
         site.influence = distInfluence(localRng);
         sites.push_back(site);
     }
+    siteTree.build(sites);
+}
+
+void VoronoiSiteTree::build(const std::vector<VoronoiSite4D>& sites)
+{
+    nodes.clear();
+    order.resize(sites.size());
+    for (size_t i = 0; i < sites.size(); ++i)
+        order[i] = (uint32_t)i;
+    if (!sites.empty())
+        buildNode(sites, 0, (int)sites.size());
+
+    px.resize(sites.size());
+    py.resize(sites.size());
+    pz.resize(sites.size());
+    pw.resize(sites.size());
+    for (size_t i = 0; i < order.size(); ++i)
+    {
+        simd::float4 p = sites[order[i]].position;
+        px[i] = p.x;
+        py[i] = p.y;
+        pz[i] = p.z;
+        pw[i] = p.w;
+    }
+}
+
+int VoronoiSiteTree::buildNode(const std::vector<VoronoiSite4D>& sites, int begin, int end)
+{
+    int id = (int)nodes.size();
+    nodes.push_back({ begin, end, -1, -1, 0, 0.0f });
+    if (end - begin <= kSiteTreeLeafSize)
+        return id;
+
+    simd::float4 minP = sites[order[begin]].position;
+    simd::float4 maxP = minP;
+    for (int i = begin + 1; i < end; ++i)
+    {
+        minP = simd::min(minP, sites[order[i]].position);
+        maxP = simd::max(maxP, sites[order[i]].position);
+    }
+    simd::float4 spread = maxP - minP;
+    int axis = 0;
+    for (int a = 1; a < 4; ++a)
+    {
+        if (spread[a] > spread[axis])
+            axis = a;
+    }
+
+    int mid = (begin + end) / 2;
+    std::nth_element(order.begin() + begin, order.begin() + mid, order.begin() + end, [&](uint32_t a, uint32_t b) {
+        return sites[a].position[axis] < sites[b].position[axis];
+    });
+    float split = sites[order[mid]].position[axis];
+
+    int left = buildNode(sites, begin, mid);
+    int right = buildNode(sites, mid, end);
+    nodes[id].left = left;
+    nodes[id].right = right;
+    nodes[id].axis = axis;
+    nodes[id].split = split;
+    return id;
+}
+
+// Marge sur l'élagage et le filtre au carré : les arrondis float ne doivent jamais écarter un site que le scan linéaire garderait
+static constexpr float kSiteTreePruneSlack = 1.000001f;
+
+int VoronoiSiteTree::findNearest(simd::float4 pos4D, float& outDist) const
+{
+    int best = -1;
+    float bestDist = std::numeric_limits<float>::max();
+    float bestDist2 = std::numeric_limits<float>::infinity();
+
+    struct Pending { int node; float planeDist; };
+    Pending stack[64];
+    int top = 0;
+    if (!nodes.empty())
+        stack[top++] = { 0, 0.0f };
+
+    while (top > 0)
+    {
+        Pending pending = stack[--top];
+        if (pending.planeDist > bestDist * kSiteTreePruneSlack)
+            continue;
+
+        const Node& node = nodes[pending.node];
+        if (node.left < 0)
+        {
+            for (int i = node.begin; i < node.end; ++i)
+            {
+                // Même calcul que distance4D pour rendre des distances identiques au bit près ;
+                // la racine n'est prise que pour les candidats qui peuvent gagner ou égaler
+                float dx = pos4D.x - px[i], dy = pos4D.y - py[i], dz = pos4D.z - pz[i], dw = pos4D.w - pw[i];
+                float dist2 = dx * dx + dy * dy + dz * dz + dw * dw;
+                if (dist2 > bestDist2)
+                    continue;
+                float dist = sqrtf(dist2);
+                int index = (int)order[i];
+                if (dist < bestDist || (dist == bestDist && index < best))
+                {
+                    bestDist = dist;
+                    bestDist2 = dist * dist * kSiteTreePruneSlack;
+                    best = index;
+                }
+            }
+            continue;
+        }
+
+        // Le côté du point d'abord (empilé en dernier)
+        float diff = pos4D[node.axis] - node.split;
+        if (diff < 0.0f)
+        {
+            stack[top++] = { node.right, -diff };
+            stack[top++] = { node.left, 0.0f };
+        }
+        else
+        {
+            stack[top++] = { node.left, diff };
+            stack[top++] = { node.right, 0.0f };
+        }
+    }
+    outDist = bestDist;
+    return best;
+}
+
+void VoronoiSiteTree::findNearestTwo(simd::float4 pos4D, float outDists[2]) const
+{
+    outDists[0] = outDists[1] = std::numeric_limits<float>::max();
+    float secondDist2 = std::numeric_limits<float>::infinity();
+
+    struct Pending { int node; float planeDist; };
+    Pending stack[64];
+    int top = 0;
+    if (!nodes.empty())
+        stack[top++] = { 0, 0.0f };
+
+    while (top > 0)
+    {
+        Pending pending = stack[--top];
+        if (pending.planeDist > outDists[1] * kSiteTreePruneSlack)
+            continue;
+
+        const Node& node = nodes[pending.node];
+        if (node.left < 0)
+        {
+            for (int i = node.begin; i < node.end; ++i)
+            {
+                float dx = pos4D.x - px[i], dy = pos4D.y - py[i], dz = pos4D.z - pz[i], dw = pos4D.w - pw[i];
+                float dist2 = dx * dx + dy * dy + dz * dz + dw * dw;
+                if (dist2 > secondDist2)
+                    continue;
+                float dist = sqrtf(dist2);
+                if (dist < outDists[0])
+                {
+                    outDists[1] = outDists[0];
+                    outDists[0] = dist;
+                }
+                else if (dist < outDists[1])
+                    outDists[1] = dist;
+                secondDist2 = outDists[1] * outDists[1] * kSiteTreePruneSlack;
+            }
+            continue;
+        }
+
+        float diff = pos4D[node.axis] - node.split;
+        if (diff < 0.0f)
+        {
+            stack[top++] = { node.right, -diff };
+            stack[top++] = { node.left, 0.0f };
+        }
+        else
+        {
+            stack[top++] = { node.left, diff };
+            stack[top++] = { node.right, 0.0f };
+        }
+    }
 }
 
 float VoronoiVoxel4D::distance4D(simd::float4 a, simd::float4 b)
@@ -375,6 +551,15 @@ float VoronoiVoxel4D::distance4D(simd::float4 a, simd::float4 b)
 }
 
 VoronoiSite4D* VoronoiVoxel4D::findClosestSite(simd::float3 worldPos, float time)
+{
+    simd::float4 pos4D = {worldPos.x, worldPos.y, worldPos.z, time};
+    float dist;
+    int index = siteTree.findNearest(pos4D, dist);
+    return index >= 0 ? &sites[index] : nullptr;
+}
+
+// Scan linéaire d'origine, gardé comme référence pour le k-d tree
+VoronoiSite4D* VoronoiVoxel4D::findClosestSiteLinear(simd::float3 worldPos, float time)
 {
     simd::float4 pos4D = {worldPos.x, worldPos.y, worldPos.z, time};
 
@@ -405,6 +590,19 @@ float VoronoiVoxel4D::worleyNoise(simd::float3 pos, float time)
 }
 
 float VoronoiVoxel4D::worleyNoise2(simd::float3 pos, float time)
+{
+    // Seuls les deux plus proches servent au motif
+    simd::float4 pos4D = {pos.x, pos.y, pos.z, time};
+    float distances[2];
+    siteTree.findNearestTwo(pos4D, distances);
+
+    float f1 = distances[0] / 30.0f;
+    float f2 = distances[1] / 30.0f;
+
+    return f2 - f1; // Frontières de cellules
+}
+
+float VoronoiVoxel4D::worleyNoise2Linear(simd::float3 pos, float time)
 {
     // Distance aux 3 sites les plus proches
     simd::float4 pos4D = {pos.x, pos.y, pos.z, time};
@@ -449,7 +647,7 @@ BlockType VoronoiVoxel4D::getBlockAtPosition(int worldX, int worldY, int worldZ,
     
     simd::float4 pos4D = {pos.x, pos.y, pos.z, time};
     float dist = distance4D(pos4D, site->position);
-    float worley = worleyNoise(pos, time);
+    float worley = fminf(1.0f, dist / site->influence); // = worleyNoise(pos, time), sans refaire la recherche
     float density = 1.0f - (dist / site->influence);
 
     density += worley * 0.3f;
@@ -483,9 +681,15 @@ BlockType VoronoiVoxel4D::getBlockAtPosition(int worldX, int worldY, int worldZ,
 }
 
 BlockType VoxelWorld::getBlockAtPositionBiomed(int worldX, int worldY, int worldZ, float time)
+{
+    return getBlockAtPositionBiomed(voronoiGen, worldX, worldY, worldZ, time);
+}
+
+// Le générateur Voronoi a un état (sites de la région) : chaque worker passe le sien, biomeGen est seulement lu
+BlockType VoxelWorld::getBlockAtPositionBiomed(VoronoiVoxel4D& generator, int worldX, int worldY, int worldZ, float time)
 {
     if (!biomeGen) {
-        return voronoiGen.getBlockAtPosition(worldX, worldY, worldZ, time);
+        return generator.getBlockAtPosition(worldX, worldY, worldZ, time);
     }
     
     BiomeTypes biome = biomeGen->getBiomeAt(worldX, worldZ);
@@ -526,7 +730,7 @@ BlockType VoxelWorld::getBlockAtPositionBiomed(int worldX, int worldY, int world
 //        }
             
         case BiomeTypes::VORONOI_4D_VOID:
-            return voronoiGen.getBlockAtPosition(worldX, worldY, worldZ, time);  // Votre système actuel
+            return generator.getBlockAtPosition(worldX, worldY, worldZ, time);  // Votre système actuel
             
         case BiomeTypes::SNOW_PARTICLES:
             // Terrain de base + flag pour particules de neige
@@ -540,7 +744,7 @@ BlockType VoxelWorld::getBlockAtPositionBiomed(int worldX, int worldY, int world
 }
 
 
-Chunk::Chunk(int x, int z) : chunkX(x), chunkZ(z), vertexBuffer(nullptr), indexBuffer(nullptr), indexCount(0), needsRebuild(true)
+Chunk::Chunk(int x, int z) : chunkX(x), chunkZ(z), vertexBuffer(nullptr), indexBuffer(nullptr), indexCount(0), needsRebuild(true), meshingMode(MeshingMode::Naive), state(VoxelChunkState::Requested), pinCount(0), builtMinY(0.0f), builtMaxY((float)CHUNK_HEIGHT), meshMinY(0.0f), meshMaxY((float)CHUNK_HEIGHT)
 {
     ft_memset(blocks, 0, sizeof(blocks));
 //    for (int x = 0; x < CHUNK_SIZE; ++x)
@@ -555,8 +759,10 @@ Chunk::Chunk(int x, int z) : chunkX(x), chunkZ(z), vertexBuffer(nullptr), indexB
 
 Chunk::~Chunk()
 {
-    vertexBuffer->release();
-    indexBuffer->release();
+    if (vertexBuffer)
+        vertexBuffer->release();
+    if (indexBuffer)
+        indexBuffer->release();
 }
 
 BlockType Chunk::getBlock(int x, int y, int z) const
@@ -580,38 +786,49 @@ bool Chunk::isBlockSolid(int x, int y, int z) const
     return type != BlockType::AIR;
 }
 
-void Chunk::addCubeFace(std::vector<VoxelVertex>& vertices, std::vector<uint32_t>& indices, simd::float3 pos, BlockType type, int face)
+bool Chunk::isBlockSolid(int x, int y, int z, const ChunkNeighbors& neighbors) const
 {
-    simd::float4 color = BLOCK_COLORS[(int)type];
-    uint32_t baseIndex = (uint32_t)vertices.size();
+    if (y < 0 || y >= CHUNK_HEIGHT)
+        return false;
+    if (x < 0)
+        return neighbors.negX && neighbors.negX->blocks[CHUNK_SIZE - 1][y][z] != BlockType::AIR;
+    if (x >= CHUNK_SIZE)
+        return neighbors.posX && neighbors.posX->blocks[0][y][z] != BlockType::AIR;
+    if (z < 0)
+        return neighbors.negZ && neighbors.negZ->blocks[x][y][CHUNK_SIZE - 1] != BlockType::AIR;
+    if (z >= CHUNK_SIZE)
+        return neighbors.posZ && neighbors.posZ->blocks[x][y][0] != BlockType::AIR;
+    return blocks[x][y][z] != BlockType::AIR;
+}
 
-    simd::float3 normals[6] = { {0, 1, 0}, {0, -1, 0}, {0, 0, -1}, {0, 0, 1}, {1, 0, 0}, {-1, 0, 0} };
+static const simd::float3 kFaceNormals[6] = { {0, 1, 0}, {0, -1, 0}, {0, 0, -1}, {0, 0, 1}, {1, 0, 0}, {-1, 0, 0} };
 
-    simd::float3 faceVertices[6][4] =
-    {
-        {{0,1,0}, {1,1,0}, {1,1,1}, {0,1,1}},
-        {{0,0,0}, {0,0,1}, {1,0,1}, {1,0,0}},
-        {{0,0,0}, {1,0,0}, {1,1,0}, {0,1,0}},
-        {{1,0,1}, {0,0,1}, {0,1,1}, {1,1,1}},
-        {{1,0,0}, {1,0,1}, {1,1,1}, {1,1,0}},
-        {{0,0,1}, {0,0,0}, {0,1,0}, {0,1,1}}
-    };
+static const simd::float3 kFaceVertices[6][4] =
+{
+    {{0,1,0}, {1,1,0}, {1,1,1}, {0,1,1}},
+    {{0,0,0}, {0,0,1}, {1,0,1}, {1,0,0}},
+    {{0,0,0}, {1,0,0}, {1,1,0}, {0,1,0}},
+    {{1,0,1}, {0,0,1}, {0,1,1}, {1,1,1}},
+    {{1,0,0}, {1,0,1}, {1,1,1}, {1,1,0}},
+    {{0,0,1}, {0,0,0}, {0,1,0}, {0,1,1}}
+};
 
-    float brightness[6] = {1.0f, 0.5f, 0.7f, 0.7f, 0.9f, 0.6f};
-    simd::float4 shadedColor = color * brightness[face];
-    shadedColor.w = color.w;
+static const float kFaceBrightness[6] = {1.0f, 0.5f, 0.7f, 0.7f, 0.9f, 0.6f};
 
-    float variation = (hash((int)pos.x, (int)pos.y, (int)pos.z) % 100) / 1000.0f;
-    shadedColor.x += variation;
-    shadedColor.y += variation;
-    shadedColor.z += variation;
+// Axe de la normale (0 = x, 1 = y, 2 = z) et sens, dans l'ordre des faces ci-dessus
+static const int kFaceAxis[6] = {1, 1, 2, 2, 0, 0};
+static const int kFaceSign[6] = {1, -1, -1, 1, 1, -1};
+
+static void pushQuad(std::vector<VoxelVertex>& vertices, std::vector<uint32_t>& indices, simd::float3 pos, simd::float3 size, simd::float4 color, int face)
+{
+    uint32_t baseIndex = (uint32_t)vertices.size();
 
     for (int i = 0; i < 4; ++i)
     {
         VoxelVertex v;
-        v.position = pos + faceVertices[face][i] * VOXELSIZE;
-        v.color = shadedColor;
-        v.normal = normals[face];
+        v.position = pos + kFaceVertices[face][i] * size;
+        v.color = color;
+        v.normal = kFaceNormals[face];
         vertices.push_back(v);
     }
 
@@ -623,16 +840,34 @@ void Chunk::addCubeFace(std::vector<VoxelVertex>& vertices, std::vector<uint32_t
     indices.push_back(baseIndex + 3);
 }
 
-void Chunk::rebuildMesh(MTL::Device* device)
+void Chunk::addCubeFace(std::vector<VoxelVertex>& vertices, std::vector<uint32_t>& indices, simd::float3 pos, BlockType type, int face)
+{
+    simd::float4 color = BLOCK_COLORS[(int)type];
+    simd::float4 shadedColor = color * kFaceBrightness[face];
+    shadedColor.w = color.w;
+
+    float variation = (hash((int)pos.x, (int)pos.y, (int)pos.z) % 100) / 1000.0f;
+    shadedColor.x += variation;
+    shadedColor.y += variation;
+    shadedColor.z += variation;
+
+    pushQuad(vertices, indices, pos, simd::float3{VOXELSIZE, VOXELSIZE, VOXELSIZE}, shadedColor, face);
+}
+
+// Pas de variation par bloc ici : une face fusionnée couvre plusieurs blocs, la couleur ne dépend que du type et de la face.
+// La teinte par bloc de addCubeFace ne se répète jamais entre voisins : la mettre dans la clé de fusion ne fusionnerait rien,
+// d'où Naive par défaut tant que ce rendu plus uni n'est pas validé
+void Chunk::addGreedyFace(std::vector<VoxelVertex>& vertices, std::vector<uint32_t>& indices, simd::float3 pos, simd::float3 size, BlockType type, int face)
+{
+    simd::float4 color = BLOCK_COLORS[(int)type];
+    simd::float4 shadedColor = color * kFaceBrightness[face];
+    shadedColor.w = color.w;
+
+    pushQuad(vertices, indices, pos, size, shadedColor, face);
+}
+
+void Chunk::buildMeshNaive(std::vector<VoxelVertex>& vertices, std::vector<uint32_t>& indices, const ChunkNeighbors& neighbors) const
 {
-    if (!needsRebuild)
-        return;
-    
-    std::vector<VoxelVertex> vertices;
-    std::vector<uint32_t> indices;
-    vertices.reserve(CHUNK_SIZE * CHUNK_SIZE * 128 * 4);
-    indices.reserve(CHUNK_SIZE * CHUNK_SIZE * 128 * 6);
-    
     for (int x = 0; x < CHUNK_SIZE; ++x)
     {
         for (int y = 0; y < CHUNK_HEIGHT; ++y)
@@ -645,28 +880,176 @@ void Chunk::rebuildMesh(MTL::Device* device)
                 
                 simd::float3 worldPos = { (float)(chunkX * CHUNK_SIZE + x), (float)y, (float)(chunkZ * CHUNK_SIZE + z) };
                 
-                if (!isBlockSolid(x, y + 1, z))
+                if (!isBlockSolid(x, y + 1, z, neighbors))
                     addCubeFace(vertices, indices, worldPos, type, 0);
-                if (!isBlockSolid(x, y - 1, z))
+                if (!isBlockSolid(x, y - 1, z, neighbors))
                     addCubeFace(vertices, indices, worldPos, type, 1);
-                if (!isBlockSolid(x, y, z - 1))
+                if (!isBlockSolid(x, y, z - 1, neighbors))
                     addCubeFace(vertices, indices, worldPos, type, 2);
-                if (!isBlockSolid(x, y, z + 1))
+                if (!isBlockSolid(x, y, z + 1, neighbors))
                     addCubeFace(vertices, indices, worldPos, type, 3);
-                if (!isBlockSolid(x + 1, y, z))
+                if (!isBlockSolid(x + 1, y, z, neighbors))
                     addCubeFace(vertices, indices, worldPos, type, 4);
-                if (!isBlockSolid(x - 1, y, z))
+                if (!isBlockSolid(x - 1, y, z, neighbors))
                     addCubeFace(vertices, indices, worldPos, type, 5);
             }
         }
     }
+}
+
+void Chunk::buildMeshGreedy(std::vector<VoxelVertex>& vertices, std::vector<uint32_t>& indices, const ChunkNeighbors& neighbors) const
+{
+    const int dims[3] = { CHUNK_SIZE, CHUNK_HEIGHT, CHUNK_SIZE };
+    // Plus grande tranche possible : CHUNK_SIZE x CHUNK_HEIGHT
+    BlockType mask[CHUNK_SIZE * CHUNK_HEIGHT];
+
+    for (int face = 0; face < 6; ++face)
+    {
+        const int n = kFaceAxis[face];
+        const int u = (n + 1) % 3;
+        const int v = (n + 2) % 3;
+        const int sign = kFaceSign[face];
+
+        for (int d = 0; d < dims[n]; ++d)
+        {
+            // Masque des faces exposées de la tranche d (seul l'axe n peut sortir du chunk)
+            // Au bord en X/Z on lit la tranche opposée du voisin, en Y tout est de l'air
+            int nd = d + sign;
+            const Chunk* source = this;
+            if (nd < 0 || nd >= dims[n])
+            {
+                if (n == 0)
+                    source = sign > 0 ? neighbors.posX : neighbors.negX;
+                else if (n == 2)
+                    source = sign > 0 ? neighbors.posZ : neighbors.negZ;
+                else
+                    source = nullptr;
+                nd = sign > 0 ? 0 : dims[n] - 1;
+            }
+            bool sliceHasFaces = false;
+            int c[3];
+            int nb[3];
+            c[n] = d;
+            nb[n] = nd;
+            for (int j = 0; j < dims[v]; ++j)
+            {
+                c[v] = nb[v] = j;
+                for (int i = 0; i < dims[u]; ++i)
+                {
+                    c[u] = nb[u] = i;
+                    BlockType type = blocks[c[0]][c[1]][c[2]];
+                    bool exposed = type != BlockType::AIR && (!source || source->blocks[nb[0]][nb[1]][nb[2]] == BlockType::AIR);
+                    mask[i + j * dims[u]] = exposed ? type : BlockType::AIR;
+                    sliceHasFaces |= exposed;
+                }
+            }
+            if (!sliceHasFaces)
+                continue;
+
+            // Fusion en rectangles maximaux : on étend en largeur (u) puis en hauteur (v)
+            for (int j = 0; j < dims[v]; ++j)
+            {
+                for (int i = 0; i < dims[u];)
+                {
+                    BlockType type = mask[i + j * dims[u]];
+                    if (type == BlockType::AIR)
+                    {
+                        ++i;
+                        continue;
+                    }
+
+                    int w = 1;
+                    while (i + w < dims[u] && mask[i + w + j * dims[u]] == type)
+                        ++w;
+
+                    int h = 1;
+                    for (; j + h < dims[v]; ++h)
+                    {
+                        bool rowMatches = true;
+                        for (int k = 0; k < w; ++k)
+                        {
+                            if (mask[i + k + (j + h) * dims[u]] != type)
+                            {
+                                rowMatches = false;
+                                break;
+                            }
+                        }
+                        if (!rowMatches)
+                            break;
+                    }
+
+                    int origin[3];
+                    origin[n] = d;
+                    origin[u] = i;
+                    origin[v] = j;
+
+                    // Même emprise que les cubes naïfs : chaque bloc fait VOXELSIZE, les interstices internes disparaissent
+                    float extent[3];
+                    extent[n] = VOXELSIZE;
+                    extent[u] = (float)w - 1.0f + VOXELSIZE;
+                    extent[v] = (float)h - 1.0f + VOXELSIZE;
+
+                    simd::float3 worldPos = { (float)(chunkX * CHUNK_SIZE + origin[0]), (float)origin[1], (float)(chunkZ * CHUNK_SIZE + origin[2]) };
+                    simd::float3 size = { extent[0], extent[1], extent[2] };
+                    addGreedyFace(vertices, indices, worldPos, size, type, face);
+
+                    for (int l = 0; l < h; ++l)
+                        for (int k = 0; k < w; ++k)
+                            mask[i + k + (j + l) * dims[u]] = BlockType::AIR;
+
+                    i += w;
+                }
+            }
+        }
+    }
+}
+
+void Chunk::rebuildMesh(MTL::Device* device, const ChunkNeighbors& neighbors)
+{
+    if (!needsRebuild)
+        return;
+    
+    buildMesh(neighbors);
+    uploadMesh(device);
+    needsRebuild = false;
+}
+
+// Partie CPU, appelable depuis un worker tant que le chunk et ses voisins sont épinglés
+void Chunk::buildMesh(const ChunkNeighbors& neighbors)
+{
+    meshVertices.clear();
+    meshIndices.clear();
+
+    if (meshingMode == MeshingMode::Greedy)
+    {
+        meshVertices.reserve(CHUNK_SIZE * CHUNK_SIZE * 4 * 4);
+        meshIndices.reserve(CHUNK_SIZE * CHUNK_SIZE * 4 * 6);
+        buildMeshGreedy(meshVertices, meshIndices, neighbors);
+    }
+    else
+    {
+        meshVertices.reserve(CHUNK_SIZE * CHUNK_SIZE * 128 * 4);
+        meshIndices.reserve(CHUNK_SIZE * CHUNK_SIZE * 128 * 6);
+        buildMeshNaive(meshVertices, meshIndices, neighbors);
+    }
+    
+    builtMinY = (float)CHUNK_HEIGHT;
+    builtMaxY = 0.0f;
+    for (const VoxelVertex& vertex : meshVertices)
+    {
+        builtMinY = std::min(builtMinY, vertex.position.y);
+        builtMaxY = std::max(builtMaxY, vertex.position.y);
+    }
+}
 
+void Chunk::uploadMesh(MTL::Device* device)
+{
     if (vertexBuffer)
         vertexBuffer->release();
     if (indexBuffer)
         indexBuffer->release();
 
-    if (vertices.empty())
+    if (meshVertices.empty())
     {
         vertexBuffer = nullptr;
         indexBuffer = nullptr;
@@ -674,25 +1057,45 @@ void Chunk::rebuildMesh(MTL::Device* device)
     }
     else
     {
-        vertexBuffer = device->newBuffer(vertices.data(), vertices.size() * sizeof(VoxelVertex), MTL::ResourceStorageModeShared);
-        indexBuffer = device->newBuffer(indices.data(), indices.size() * sizeof(uint32_t), MTL::ResourceStorageModeShared);
-        indexCount = (uint32_t)indices.size();
+        vertexBuffer = device->newBuffer(meshVertices.data(), meshVertices.size() * sizeof(VoxelVertex), MTL::ResourceStorageModeShared);
+        indexBuffer = device->newBuffer(meshIndices.data(), meshIndices.size() * sizeof(uint32_t), MTL::ResourceStorageModeShared);
+        indexCount = (uint32_t)meshIndices.size();
     }
-    needsRebuild = false;
+    meshMinY = builtMinY;
+    meshMaxY = builtMaxY;
+
+    // Les données sont sur le GPU, inutile de garder la copie CPU
+    std::vector<VoxelVertex>().swap(meshVertices);
+    std::vector<uint32_t>().swap(meshIndices);
+    state = VoxelChunkState::Ready;
 }
 
 
 VoxelWorld::VoxelWorld(MTL::Device* pDevice, MTL::PixelFormat pPixelFormat, MTL::PixelFormat pDepthPixelFormat, MTL::Library* pShaderLibrary)
-: voronoiGen(89), currentTime(0.0f)
+: m_depthStencilState(nullptr), m_renderPipelineState(nullptr), voronoiGen(89), currentTime(0.0f), running(true), visibleChunkCount(0)
 {
-    createPipeline(pShaderLibrary, pPixelFormat, pDepthPixelFormat, pDevice);
+    // Sans library (tests headless) : pas de pipeline, update tourne quand même
+    if (pShaderLibrary)
+        createPipeline(pShaderLibrary, pPixelFormat, pDepthPixelFormat, pDevice);
+
+    uint32_t numWorkers = std::max(2u, std::thread::hardware_concurrency() / 2);
+    for (uint32_t i = 0; i < numWorkers; i++)
+        workers.emplace_back(&VoxelWorld::workerThread, this);
 }
 
 VoxelWorld::~VoxelWorld()
 {
+    running = false;
+    jobCondition.notify_all();
+    for (auto& worker : workers)
+    {
+        if (worker.joinable())
+            worker.join();
+    }
     for (auto& [key, chunk] : chunks)
         delete chunk;
-    m_renderPipelineState->release();
+    if (m_renderPipelineState)
+        m_renderPipelineState->release();
 }
 //void VoxelWorld::generateTerrainBiomed(int chunkX, int chunkZ)
 //{
@@ -731,23 +1134,40 @@ inline int floormod(int a, int b)
 
 void VoxelWorld::worldToChunk(int worldX, int worldZ, int& chunkX, int& chunkZ, int& localX, int& localZ)
 {
-    chunkX = worldX >> 5; // Division par 32
-    chunkZ = worldZ >> 5;
-    localX = worldX & 31; // Modulo 32
-    localZ = worldZ & 31;
-    
-    if (worldX < 0 && localX != 0)
-    {
-        chunkX--;
-        localX = CHUNK_SIZE + localX;
-    }
-    if (worldZ < 0 && localZ != 0)
+    chunkX = floordiv(worldX, CHUNK_SIZE);
+    chunkZ = floordiv(worldZ, CHUNK_SIZE);
+    localX = floormod(worldX, CHUNK_SIZE);
+    localZ = floormod(worldZ, CHUNK_SIZE);
+}
+
+Chunk* VoxelWorld::findChunk(int chunkX, int chunkZ) const
+{
+    auto it = chunks.find(chunkKey(chunkX, chunkZ));
+    return it != chunks.end() ? it->second : nullptr;
+}
+
+ChunkNeighbors VoxelWorld::neighborsOf(int chunkX, int chunkZ) const
+{
+    ChunkNeighbors neighbors;
+    neighbors.negX = findChunk(chunkX - 1, chunkZ);
+    neighbors.posX = findChunk(chunkX + 1, chunkZ);
+    neighbors.negZ = findChunk(chunkX, chunkZ - 1);
+    neighbors.posZ = findChunk(chunkX, chunkZ + 1);
+    return neighbors;
+}
+
+// Un voisin vient d'apparaître ou de disparaître : les faces de bord des chunks adjacents changent
+void VoxelWorld::markNeighborsDirty(int chunkX, int chunkZ)
+{
+    const int offsets[4][2] = { {-1, 0}, {1, 0}, {0, -1}, {0, 1} };
+    for (const auto& offset : offsets)
     {
-        chunkZ--;
-        localZ = CHUNK_SIZE + localZ;
+        if (Chunk* neighbor = findChunk(chunkX + offset[0], chunkZ + offset[1]))
+            neighbor->needsRebuild = true;
     }
 }
 
+// Chemin synchrone (getBlock, setBlock, raycast) : un chunk absent est généré tout de suite sur le thread appelant
 Chunk* VoxelWorld::getChunk(int chunkX, int chunkZ)
 {
     uint64_t key = chunkKey(chunkX, chunkZ);
@@ -758,36 +1178,52 @@ Chunk* VoxelWorld::getChunk(int chunkX, int chunkZ)
 
     Chunk* chunk = new Chunk(chunkX, chunkZ);
     chunks[key] = chunk;
-    generateTerrainVoronoi(chunkX, chunkZ);
+    generateChunkBlocks(*chunk, voronoiGen, currentTime);
+    chunk->state = VoxelChunkState::Generated;
+    markNeighborsDirty(chunkX, chunkZ);
     return chunk;
 }
 
 void VoxelWorld::generateTerrainVoronoi(int chunkX, int chunkZ)
 {
-    Chunk* chunk = getChunk(chunkX, chunkZ);
+    Chunk* chunk = findChunk(chunkX, chunkZ);
+    if (!chunk)
+    {
+        getChunk(chunkX, chunkZ);
+        return;
+    }
+    if (chunk->state == VoxelChunkState::Requested || chunk->pinCount > 0)
+        return;
 
-    voronoiGen.generateSitesForRegion(chunkX, chunkZ, currentTime);
+    generateChunkBlocks(*chunk, voronoiGen, currentTime);
+    chunk->needsRebuild = true;
+    markNeighborsDirty(chunkX, chunkZ);
+}
+
+// Écrit directement dans blocks (pas de setBlock) : sur un worker, le thread principal peut toucher needsRebuild
+void VoxelWorld::generateChunkBlocks(Chunk& chunk, VoronoiVoxel4D& generator, float time)
+{
+    generator.generateSitesForRegion(chunk.chunkX, chunk.chunkZ, time);
 
     for (int x = 0; x < CHUNK_SIZE; ++x)
     {
         for (int z = 0; z < CHUNK_SIZE; ++z)
         {
-            int worldX = chunkX * CHUNK_SIZE + x;
-            int worldZ = chunkZ * CHUNK_SIZE + z;
+            int worldX = chunk.chunkX * CHUNK_SIZE + x;
+            int worldZ = chunk.chunkZ * CHUNK_SIZE + z;
 
             for (int y = 0; y < CHUNK_HEIGHT; ++y)
             {
-//                BlockType type = voronoiGen.getBlockAtPosition(worldX, y, worldZ, currentTime);
                 BlockType type;
                 if (biomeGen)
-                    type = getBlockAtPositionBiomed(worldX, y, worldZ, currentTime);
+                    type = getBlockAtPositionBiomed(generator, worldX, y, worldZ, time);
                 else
-                    type = voronoiGen.getBlockAtPosition(worldX, y, worldZ, currentTime);
+                    type = generator.getBlockAtPosition(worldX, y, worldZ, time);
 
                 if (y < 5 || y > 100)
                     type = BlockType::AIR;
 
-                chunk->setBlock(x, y, z, type);
+                chunk.blocks[x][y][z] = type;
             }
         }
     }
@@ -802,6 +1238,8 @@ BlockType VoxelWorld::getBlock(int worldX, int worldY, int worldZ)
     worldToChunk(worldX, worldZ, chunkX, chunkZ, localX, localZ);
 
     Chunk* chunk = getChunk(chunkX, chunkZ);
+    if (chunk->state == VoxelChunkState::Requested)
+        return BlockType::AIR;
     return chunk->getBlock(localX, worldY, localZ);
 }
 
@@ -810,11 +1248,40 @@ void VoxelWorld::setBlock(int worldX, int worldY, int worldZ, BlockType type)
     if (worldY < 0 || worldY >= CHUNK_HEIGHT)
         return;
 
+    PendingEdit edit = { worldX, worldY, worldZ, type };
+    if (!applyEdit(edit))
+        pendingEdits.push_back(edit);
+}
+
+// Refuse l'écriture tant qu'un job en vol lit le chunk ; update la rejoue plus tard
+bool VoxelWorld::applyEdit(const PendingEdit& edit)
+{
     int chunkX, chunkZ, localX, localZ;
-    worldToChunk(worldX, worldZ, chunkX, chunkZ, localX, localZ);
+    worldToChunk(edit.worldX, edit.worldZ, chunkX, chunkZ, localX, localZ);
 
     Chunk* chunk = getChunk(chunkX, chunkZ);
-    chunk->setBlock(localX, worldY, localZ, type);
+    if (chunk->state == VoxelChunkState::Requested || chunk->pinCount > 0)
+        return false;
+    chunk->setBlock(localX, edit.worldY, localZ, edit.type);
+
+    // Un bloc de bord modifie aussi la face visible du voisin
+    if (localX == 0)
+        if (Chunk* neighbor = findChunk(chunkX - 1, chunkZ)) neighbor->needsRebuild = true;
+    if (localX == CHUNK_SIZE - 1)
+        if (Chunk* neighbor = findChunk(chunkX + 1, chunkZ)) neighbor->needsRebuild = true;
+    if (localZ == 0)
+        if (Chunk* neighbor = findChunk(chunkX, chunkZ - 1)) neighbor->needsRebuild = true;
+    if (localZ == CHUNK_SIZE - 1)
+        if (Chunk* neighbor = findChunk(chunkX, chunkZ + 1)) neighbor->needsRebuild = true;
+    return true;
+}
+
+void VoxelWorld::applyPendingEdits()
+{
+    auto it = std::remove_if(pendingEdits.begin(), pendingEdits.end(), [this](const PendingEdit& edit) {
+        return applyEdit(edit);
+    });
+    pendingEdits.erase(it, pendingEdits.end());
 }
 
 void VoxelWorld::removeBlock(int worldX, int worldY, int worldZ)
@@ -861,48 +1328,240 @@ void VoxelWorld::createPipeline(MTL::Library* shaderLibrary, MTL::PixelFormat pi
     m_depthStencilState = device->newDepthStencilState(depthStencilDescriptor.get());
 }
 
+void VoxelWorld::workerThread()
+{
+    // Un générateur par worker : generateSitesForRegion réécrit ses sites à chaque chunk
+    VoronoiVoxel4D generator(WORLD_SEED);
+
+    while (running)
+    {
+        VoxelJob job;
+        {
+            std::unique_lock<std::mutex> lock(jobMutex);
+            jobCondition.wait(lock, [this] {
+                return !running || !jobQueue.empty();
+            });
+
+            if (!running)
+                return;
+
+            std::pop_heap(jobQueue.begin(), jobQueue.end(), [](const VoxelJob& a, const VoxelJob& b) {
+                return a.priority > b.priority;
+            });
+            job = jobQueue.back();
+            jobQueue.pop_back();
+        }
+
+        if (job.type == VoxelJob::Type::Generate)
+            generateChunkBlocks(*job.chunk, generator, job.time);
+        else
+            job.chunk->buildMesh(job.neighbors);
+
+        std::lock_guard<std::mutex> lock(completedMutex);
+        completedJobs.push_back(job);
+    }
+}
+
+void VoxelWorld::pinJob(const VoxelJob& job, int delta)
+{
+    job.chunk->pinCount += delta;
+    for (const Chunk* neighbor : { job.neighbors.negX, job.neighbors.posX, job.neighbors.negZ, job.neighbors.posZ })
+    {
+        if (neighbor)
+            neighbor->pinCount += delta;
+    }
+}
+
+void VoxelWorld::pushJob(const VoxelJob& job)
+{
+    pinJob(job, 1);
+    {
+        std::lock_guard<std::mutex> lock(jobMutex);
+        jobQueue.push_back(job);
+        std::push_heap(jobQueue.begin(), jobQueue.end(), [](const VoxelJob& a, const VoxelJob& b) {
+            return a.priority > b.priority;
+        });
+    }
+    jobCondition.notify_one();
+}
+
+size_t VoxelWorld::getQueuedJobCount()
+{
+    std::lock_guard<std::mutex> lock(jobMutex);
+    return jobQueue.size();
+}
+
+// Récupère les jobs terminés sans attendre les workers ; les uploads GPU restent sur le thread principal
+void VoxelWorld::drainCompletedJobs(MTL::Device* device)
+{
+    std::vector<VoxelJob> done;
+    {
+        std::lock_guard<std::mutex> lock(completedMutex);
+        done.swap(completedJobs);
+    }
+
+    for (const VoxelJob& job : done)
+    {
+        pinJob(job, -1);
+        Chunk* chunk = job.chunk;
+        if (job.type == VoxelJob::Type::Generate)
+        {
+            chunk->state = VoxelChunkState::Generated;
+            chunk->needsRebuild = true;
+            markNeighborsDirty(chunk->chunkX, chunk->chunkZ);
+        }
+        else
+        {
+            chunk->state = VoxelChunkState::Meshed;
+            uploadQueue.push_back(chunk);
+        }
+    }
+
+    // Budget d'uploads par frame pour borner le temps passé ici quand beaucoup de maillages arrivent ensemble
+    for (int i = 0; i < kMaxMeshUploadsPerUpdate && !uploadQueue.empty(); ++i)
+    {
+        uploadQueue.front()->uploadMesh(device);
+        uploadQueue.pop_front();
+    }
+}
+
+// Re-trie la file selon la caméra actuelle et abandonne ce qui est sorti du rayon de déchargement
+void VoxelWorld::reprioritizeJobs(int camChunkX, int camChunkZ)
+{
+    std::vector<VoxelJob> dropped;
+    {
+        std::lock_guard<std::mutex> lock(jobMutex);
+        auto it = std::remove_if(jobQueue.begin(), jobQueue.end(), [&](VoxelJob& job) {
+            int dx = job.chunk->chunkX - camChunkX;
+            int dz = job.chunk->chunkZ - camChunkZ;
+            if (abs(dx) > RENDER_DISTANCE + 3 || abs(dz) > RENDER_DISTANCE + 3)
+            {
+                dropped.push_back(job);
+                return true;
+            }
+            job.priority = (float)(dx * dx + dz * dz);
+            return false;
+        });
+        jobQueue.erase(it, jobQueue.end());
+        std::make_heap(jobQueue.begin(), jobQueue.end(), [](const VoxelJob& a, const VoxelJob& b) {
+            return a.priority > b.priority;
+        });
+    }
+
+    // Un chunk jamais généré retourne à l'état absent ; le déchargement le supprimera une fois désépinglé
+    for (const VoxelJob& job : dropped)
+    {
+        pinJob(job, -1);
+        if (job.type == VoxelJob::Type::Mesh)
+            job.chunk->needsRebuild = true;
+    }
+}
+
+// Un chunk part au maillage quand ses voisins de la fenêtre ont leurs blocs, pour ne pas émettre de faces de bord à tort
+void VoxelWorld::scheduleMeshing(int camChunkX, int camChunkZ)
+{
+    for (int x = -RENDER_DISTANCE; x <= RENDER_DISTANCE; ++x)
+    {
+        for (int z = -RENDER_DISTANCE; z <= RENDER_DISTANCE; ++z)
+        {
+            int chunkX = camChunkX + x;
+            int chunkZ = camChunkZ + z;
+            Chunk* chunk = findChunk(chunkX, chunkZ);
+            if (!chunk || chunk->state == VoxelChunkState::Requested || chunk->state == VoxelChunkState::Meshed || !chunk->needsRebuild || chunk->pinCount > 0)
+                continue;
+
+            ChunkNeighbors neighbors = neighborsOf(chunkX, chunkZ);
+            bool neighborsReady = true;
+            for (const Chunk* neighbor : { neighbors.negX, neighbors.posX, neighbors.negZ, neighbors.posZ })
+            {
+                if (neighbor && neighbor->state == VoxelChunkState::Requested)
+                    neighborsReady = false;
+            }
+            if (!neighborsReady)
+                continue;
+
+            chunk->needsRebuild = false;
+            pushJob({ VoxelJob::Type::Mesh, chunk, neighbors, (float)(x * x + z * z), currentTime });
+        }
+    }
+}
+
 void VoxelWorld::update(float dt, simd::float3 cameraPos, MTL::Device* device)
 {
     int camChunkX = (int)floorf(cameraPos.x / CHUNK_SIZE);
     int camChunkZ = (int)floorf(cameraPos.z / CHUNK_SIZE);
 
+    drainCompletedJobs(device);
+    reprioritizeJobs(camChunkX, camChunkZ);
+
+    // Demande la génération de toute la fenêtre, la file est triée par distance
     for (int x = -RENDER_DISTANCE; x <= RENDER_DISTANCE; ++x)
     {
         for (int z = -RENDER_DISTANCE; z <= RENDER_DISTANCE; ++z)
         {
             int chunkX = camChunkX + x;
             int chunkZ = camChunkZ + z;
-            Chunk* chunk = getChunk(chunkX, chunkZ);
-
-            if (chunk->needsRebuild)
-                chunk->rebuildMesh(device);
+            Chunk* chunk = findChunk(chunkX, chunkZ);
+            if (!chunk)
+            {
+                chunk = new Chunk(chunkX, chunkZ);
+                chunks[chunkKey(chunkX, chunkZ)] = chunk;
+                pushJob({ VoxelJob::Type::Generate, chunk, {}, (float)(x * x + z * z), currentTime });
+            }
+            else if (chunk->state == VoxelChunkState::Requested && chunk->pinCount == 0)
+            {
+                // Job abandonné puis chunk revenu dans la fenêtre
+                pushJob({ VoxelJob::Type::Generate, chunk, {}, (float)(x * x + z * z), currentTime });
+            }
         }
     }
+
+    scheduleMeshing(camChunkX, camChunkZ);
+    applyPendingEdits();
+
     for (auto it = chunks.begin(); it != chunks.end();)
     {
         Chunk* chunk = it->second;
         int dx = abs(chunk->chunkX - camChunkX);
         int dz = abs(chunk->chunkZ - camChunkZ);
 
-        if (dx > RENDER_DISTANCE + 3 || dz > RENDER_DISTANCE + 3)
+        if ((dx > RENDER_DISTANCE + 3 || dz > RENDER_DISTANCE + 3) && chunk->pinCount == 0 && chunk->state != VoxelChunkState::Meshed)
         {
+            int unloadedX = chunk->chunkX;
+            int unloadedZ = chunk->chunkZ;
             delete chunk;
             it = chunks.erase(it);
+            markNeighborsDirty(unloadedX, unloadedZ);
         }
         else
             ++it;
     }
 }
 
-void VoxelWorld::render(MTL::RenderCommandEncoder* renderCommandEncoder, simd::float4x4 viewProjectionMatrix)
+void VoxelWorld::render(MTL::RenderCommandEncoder* renderCommandEncoder, simd::float4x4 viewProjectionMatrix, const Frustum& frustum)
 {
     renderCommandEncoder->setRenderPipelineState(m_renderPipelineState);
     renderCommandEncoder->setDepthStencilState(m_depthStencilState);
     renderCommandEncoder->setCullMode(MTL::CullModeBack);
+    
+    chunkCuller.clear();
+    cullCandidates.clear();
+    visibleChunks.clear();
     for (auto& [key, chunk] : chunks)
     {
         if (chunk->indexCount == 0)
             continue;
+        simd::float3 boxMin = { (float)(chunk->chunkX * CHUNK_SIZE), chunk->meshMinY, (float)(chunk->chunkZ * CHUNK_SIZE) };
+        simd::float3 boxMax = { (float)((chunk->chunkX + 1) * CHUNK_SIZE), chunk->meshMaxY, (float)((chunk->chunkZ + 1) * CHUNK_SIZE) };
+        chunkCuller.addBox(boxMin, boxMax);
+        cullCandidates.push_back(chunk);
+    }
+    chunkCuller.cull(frustum, visibleChunks);
+    visibleChunkCount = (uint32_t)visibleChunks.size();
+    
+    for (uint32_t index : visibleChunks)
+    {
+        Chunk* chunk = cullCandidates[index];
         renderCommandEncoder->setVertexBuffer(chunk->vertexBuffer, 0, 0);
         renderCommandEncoder->drawIndexedPrimitives(MTL::PrimitiveTypeTriangle, chunk->indexCount, MTL::IndexTypeUInt32, chunk->indexBuffer, 0);
     }
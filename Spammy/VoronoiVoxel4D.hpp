@@ -23,6 +23,7 @@
 #include <thread>
 #include <mutex>
 #include <queue>
+#include <deque>
 #include <condition_variable>
 #include <atomic>
 #include <future>
@@ -31,12 +32,14 @@
 
 #include "RMDLUtils.hpp"
 #include "RMDLMainRenderer_shared.h"
+#include "RMDLFrustumCulling.hpp"
 
 static constexpr int CHUNK_SIZE = 16;
 static constexpr int CHUNK_HEIGHT = 128;
 static constexpr float VOXELSIZE = 0.99f;
 static constexpr int RENDER_DISTANCE = 12;
 static constexpr int WORLD_SEED = 89;
+static constexpr int kMaxMeshUploadsPerUpdate = 16;
 
 enum class BlockType : uint8_t {
     AIR = 0,
@@ -110,6 +113,11 @@ struct VoxelVertex
     simd::float3 normal;
 };
 
+enum class MeshingMode : uint8_t {
+    Naive,  // 1 quad par face exposée, teinte propre à chaque bloc (par défaut)
+    Greedy  // faces coplanaires de même type fusionnées en rectangles maximaux, sans la teinte par bloc
+};
+
 struct VoronoiSite4D
 {
     simd::float4 position;
@@ -119,6 +127,35 @@ struct VoronoiSite4D
 
 uint32_t hash(int x, int y, int z);
 
+// k-d tree 4D sur les sites d'une région, reconstruit à chaque generateSitesForRegion
+// Feuilles de kSiteTreeLeafSize sites, positions recopiées en SoA dans l'ordre de l'arbre
+// Les requêtes rendent les mêmes sites et distances que le scan linéaire (départage par index)
+static constexpr int kSiteTreeLeafSize = 8;
+
+class VoronoiSiteTree
+{
+public:
+    void build(const std::vector<VoronoiSite4D>& sites);
+
+    int findNearest(simd::float4 pos4D, float& outDist) const;
+    void findNearestTwo(simd::float4 pos4D, float outDists[2]) const;
+
+private:
+    struct Node
+    {
+        int     begin, end;     // plage dans order / px..pw
+        int     left, right;    // -1 pour une feuille
+        int     axis;
+        float   split;
+    };
+
+    std::vector<Node>       nodes;
+    std::vector<uint32_t>   order;
+    std::vector<float>      px, py, pz, pw;
+
+    int buildNode(const std::vector<VoronoiSite4D>& sites, int begin, int end);
+};
+
 enum class BiomeTypes {
     PERLIN_VORONOI_MIXED,
     VOLCANO_ACTIVE,
@@ -189,6 +226,7 @@ public:
     
     // Trouve le site Voronoi le plus proche en 4D
     VoronoiSite4D* findClosestSite(simd::float3 worldPos, float time);
+    VoronoiSite4D* findClosestSiteLinear(simd::float3 worldPos, float time);
     
     // Distance 4D entre deux points
     float distance4D(simd::float4 a, simd::float4 b);
@@ -199,16 +237,37 @@ public:
     // Worley noise (distance au plus proche site)
     float worleyNoise(simd::float3 pos, float time);
     float worleyNoise2(simd::float3 pos, float time);
+    float worleyNoise2Linear(simd::float3 pos, float time);
     
     void setTimeOffset(float t) { timeOffset = t; }
     float getTimeOffset() const { return timeOffset; }
 
 private:
     std::vector<VoronoiSite4D>  sites;
+    VoronoiSiteTree             siteTree;
     std::mt19937                rng;
     float                       timeOffset; // 4ème dimension = temps
 };
 
+class Chunk;
+
+// Voisins directs d'un chunk, en lecture seule pour le mailleur (nullptr = pas chargé, traité comme de l'air)
+struct ChunkNeighbors
+{
+    const Chunk*    negX = nullptr;
+    const Chunk*    posX = nullptr;
+    const Chunk*    negZ = nullptr;
+    const Chunk*    posZ = nullptr;
+};
+
+// Cycle de vie d'un chunk dans le pipeline asynchrone de VoxelWorld (modifié sur le thread principal seulement)
+enum class VoxelChunkState : uint8_t {
+    Requested,  // génération en file ou en cours sur un worker, blocs invalides
+    Generated,  // blocs prêts, maillage à faire
+    Meshed,     // maillage CPU prêt dans meshVertices/meshIndices, upload GPU à faire
+    Ready       // buffers GPU à jour
+};
+
 class Chunk
 {
 public:
@@ -219,6 +278,19 @@ public:
     MTL::Buffer*    indexBuffer;
     uint32_t        indexCount;
     bool            needsRebuild;
+    MeshingMode     meshingMode;
+    
+    VoxelChunkState state;
+    mutable int     pinCount;   // jobs en vol qui lisent ce chunk : ni suppression ni écriture tant que > 0
+    
+    // Rempli par un worker, consommé par uploadMesh sur le thread principal
+    std::vector<VoxelVertex>    meshVertices;
+    std::vector<uint32_t>       meshIndices;
+    float                       builtMinY, builtMaxY;
+    
+    // Étendue verticale du maillage uploadé, pour l'AABB de culling : écrite par uploadMesh
+    // seulement, render la lit sur le thread principal pendant qu'un worker remaille
+    float           meshMinY, meshMaxY;
     
     Chunk(int x, int z);
     ~Chunk();
@@ -227,14 +299,29 @@ public:
     void setBlock(int x, int y, int z, BlockType type);
     bool isBlockSolid(int x, int y, int z) const;
     
-    void rebuildMesh(MTL::Device* device);
+    void rebuildMesh(MTL::Device* device, const ChunkNeighbors& neighbors = {});
+    void buildMesh(const ChunkNeighbors& neighbors);
+    void uploadMesh(MTL::Device* device);
+
+    // CPU seulement, sans device : utilisés par rebuildMesh et pour comparer les deux mailleurs
+    void buildMeshNaive(std::vector<VoxelVertex>& vertices, std::vector<uint32_t>& indices, const ChunkNeighbors& neighbors = {}) const;
+    void buildMeshGreedy(std::vector<VoxelVertex>& vertices, std::vector<uint32_t>& indices, const ChunkNeighbors& neighbors = {}) const;
+    
+    // Comme isBlockSolid, mais lit les chunks voisins au-delà des bords X/Z
+    bool isBlockSolid(int x, int y, int z, const ChunkNeighbors& neighbors) const;
     
 private:
-    void addCubeFace(std::vector<VoxelVertex>& vertices,
-                     std::vector<uint32_t>& indices,
-                     simd::float3 pos,
-                     BlockType type,
-                     int face);
+    static void addCubeFace(std::vector<VoxelVertex>& vertices,
+                            std::vector<uint32_t>& indices,
+                            simd::float3 pos,
+                            BlockType type,
+                            int face);
+    static void addGreedyFace(std::vector<VoxelVertex>& vertices,
+                              std::vector<uint32_t>& indices,
+                              simd::float3 pos,
+                              simd::float3 size,
+                              BlockType type,
+                              int face);
 };
 
 class VoxelWorld
@@ -258,7 +345,7 @@ public:
     
     void update(float dt, simd::float3 cameraPos, MTL::Device* device);
     void render(MTL::RenderCommandEncoder* encoder,
-                simd::float4x4 viewProjectionMatrix);
+                simd::float4x4 viewProjectionMatrix, const Frustum& frustum);
     
     void generateTerrainVoronoi(int chunkX, int chunkZ);
     
@@ -275,15 +362,68 @@ public:
 
     BlockType getBlockAtPositionBiomed(int worldX, int worldY, int worldZ, float time);
     
+    size_t getQueuedJobCount();
+    uint32_t getVisibleChunkCount() const { return visibleChunkCount; }
+    
 private:
+    struct VoxelJob
+    {
+        enum class Type : uint8_t { Generate, Mesh };
+        
+        Type            type;
+        Chunk*          chunk;
+        ChunkNeighbors  neighbors;
+        float           priority;   // distance² à la caméra en chunks, plus petit = plus urgent
+        float           time;
+    };
+    
+    struct PendingEdit
+    {
+        int         worldX, worldY, worldZ;
+        BlockType   type;
+    };
+    
     std::unordered_map<uint64_t, Chunk*> chunks;
     VoronoiVoxel4D voronoiGen;
     float currentTime;
     
+    // Pipeline asynchrone : génération et maillage sur les workers, upload et états sur le thread principal
+    std::vector<std::thread>    workers;
+    std::vector<VoxelJob>       jobQueue;       // tas min sur priority
+    std::vector<VoxelJob>       completedJobs;
+    std::vector<PendingEdit>    pendingEdits;   // setBlock sur un chunk lu par un job en vol
+    std::deque<Chunk*>          uploadQueue;    // chunks Meshed en attente d'upload GPU
+    std::mutex                  jobMutex;
+    std::mutex                  completedMutex;
+    std::condition_variable     jobCondition;
+    std::atomic<bool>           running;
+    
+    // Culling CPU des chunks avant l'encodeur
+    culling::BoxCuller          chunkCuller;
+    std::vector<Chunk*>         cullCandidates;
+    std::vector<uint32_t>       visibleChunks;
+    uint32_t                    visibleChunkCount;
+    
+    void workerThread();
+    void pushJob(const VoxelJob& job);
+    void pinJob(const VoxelJob& job, int delta);
+    void drainCompletedJobs(MTL::Device* device);
+    void scheduleMeshing(int camChunkX, int camChunkZ);
+    void reprioritizeJobs(int camChunkX, int camChunkZ);
+    void applyPendingEdits();
+    bool applyEdit(const PendingEdit& edit);
+    
+    void generateChunkBlocks(Chunk& chunk, VoronoiVoxel4D& generator, float time);
+    BlockType getBlockAtPositionBiomed(VoronoiVoxel4D& generator, int worldX, int worldY, int worldZ, float time);
+    
     uint64_t chunkKey(int x, int z) const {
         return ((uint64_t)(x) << 32) | ((uint64_t)(z) & 0xFFFFFFFF);
     }
     
+    Chunk* findChunk(int chunkX, int chunkZ) const;
+    ChunkNeighbors neighborsOf(int chunkX, int chunkZ) const;
+    void markNeighborsDirty(int chunkX, int chunkZ);
+    
     void worldToChunk(int worldX, int worldZ, int& chunkX, int& chunkZ, int& localX, int& localZ);
 
     std::unique_ptr<BiomeGenerator> biomeGen;
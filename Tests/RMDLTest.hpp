@@ -0,0 +1,102 @@
+//
+//  RMDLTest.hpp
+//  Spammy
+//
+//  Created by Rémy on 17/10/2026.
+//
+
+#ifndef RMDLTest_hpp
+#define RMDLTest_hpp
+
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+// Harnais minimal, sans dépendance : chaque exécutable de Tests/ enregistre ses cas avec
+// RMDL_TEST / RMDL_BENCH et RMDLTestMain.cpp les lance. Sans argument : les tests seulement,
+// avec --bench : les benchmarks seulement, avec un nom : ce cas-là.
+namespace rmdltest
+{
+
+struct Case
+{
+    const char* name;
+    void        (*run)();
+    bool        isBench;
+};
+
+inline std::vector<Case>& registry()
+{
+    static std::vector<Case> cases;
+    return cases;
+}
+
+inline int& failureCount()
+{
+    static int count = 0;
+    return count;
+}
+
+struct Registrar
+{
+    Registrar(const char* name, void (*run)(), bool isBench) { registry().push_back({ name, run, isBench }); }
+};
+
+inline void fail(const char* file, int line, const char* expression)
+{
+    failureCount()++;
+    fprintf(stderr, "%s:%d: échec : %s\n", file, line, expression);
+}
+
+// Chronomètre pour les benchmarks : affiche une ligne par mesure, sans seuil (les chiffres dépendent de la machine)
+class Stopwatch
+{
+public:
+    Stopwatch() : m_start(std::chrono::steady_clock::now()) {}
+    double elapsedMs() const { return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - m_start).count(); }
+    void restart() { m_start = std::chrono::steady_clock::now(); }
+
+private:
+    std::chrono::steady_clock::time_point m_start;
+};
+
+// xorshift32 : mêmes tirages sur toutes les plateformes, contrairement aux distributions de <random>
+struct Random
+{
+    uint32_t state = 0x9E3779B9u;
+
+    uint32_t next()
+    {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        return state;
+    }
+    int range(int lo, int hi) { return lo + (int)(next() % (uint32_t)(hi - lo + 1)); }
+    float uniform(float lo, float hi) { return lo + (hi - lo) * (float)(next() >> 8) * (1.0f / 16777216.0f); }
+};
+
+}
+
+#define RMDL_TEST_CONCAT2(a, b) a##b
+#define RMDL_TEST_CONCAT(a, b) RMDL_TEST_CONCAT2(a, b)
+
+#define RMDL_TEST(name) \
+    static void name(); \
+    static rmdltest::Registrar RMDL_TEST_CONCAT(name, _registrar)(#name, name, false); \
+    static void name()
+
+#define RMDL_BENCH(name) \
+    static void name(); \
+    static rmdltest::Registrar RMDL_TEST_CONCAT(name, _registrar)(#name, name, true); \
+    static void name()
+
+#define RMDL_CHECK(condition) \
+    do { if (!(condition)) rmdltest::fail(__FILE__, __LINE__, #condition); } while (0)
+
+#define RMDL_CHECK_NEAR(a, b, tolerance) \
+    do { if (!(std::fabs((double)(a) - (double)(b)) <= (double)(tolerance))) rmdltest::fail(__FILE__, __LINE__, #a " ~= " #b); } while (0)
+
+#endif /* RMDLTest_hpp */
@@ -0,0 +1,52 @@
+//
+//  RMDLTestMain.cpp
+//  Spammy
+//
+//  Created by Rémy on 17/10/2026.
+//
+
+#include "RMDLTest.hpp"
+
+#include <cstring>
+
+#ifdef RMDL_TEST_METAL
+// Une seule unité de traduction par exécutable porte l'implémentation de metal-cpp
+#define NS_PRIVATE_IMPLEMENTATION
+#define CA_PRIVATE_IMPLEMENTATION
+#define MTL_PRIVATE_IMPLEMENTATION
+#include <Foundation/Foundation.hpp>
+#include <Metal/Metal.hpp>
+#include <QuartzCore/QuartzCore.hpp>
+#endif
+
+int main(int argc, char** argv)
+{
+    bool bench = false;
+    const char* only = nullptr;
+    for (int i = 1; i < argc; i++)
+    {
+        if (!strcmp(argv[i], "--bench"))
+            bench = true;
+        else
+            only = argv[i];
+    }
+
+    int ran = 0;
+    for (const rmdltest::Case& testCase : rmdltest::registry())
+    {
+        if (only ? strcmp(only, testCase.name) != 0 : testCase.isBench != bench)
+            continue;
+        int failuresBefore = rmdltest::failureCount();
+        rmdltest::Stopwatch stopwatch;
+        testCase.run();
+        printf("[%s] %s (%.1f ms)\n", rmdltest::failureCount() == failuresBefore ? " ok " : "FAIL", testCase.name, stopwatch.elapsedMs());
+        ran++;
+    }
+
+    if (ran == 0)
+    {
+        fprintf(stderr, "aucun cas%s%s\n", only ? " nommé " : "", only ? only : "");
+        return only ? 1 : 0;
+    }
+    return rmdltest::failureCount() ? 1 : 0;
+}
@@ -0,0 +1,923 @@
+//
+//  TestAnimation.cpp
+//  Spammy
+//
+//  Created by Rémy on 17/10/2026.
+//
+
+// RMDLBlender.hpp tire MetalKit et stb_image : leurs implémentations vivent ici, comme dans l'outil de bake
+#define MTK_PRIVATE_IMPLEMENTATION
+#define STB_IMAGE_IMPLEMENTATION
+
+#include "RMDLTest.hpp"
+#include "RMDLBlender.hpp"
+#include "RMDLAnimationSystem.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace
+{
+
+// Balayage linéaire d'origine : dernière clé i avec keys[i + 1].time >= time, ou la dernière clé
+uint32_t linearKeyIndex(const std::vector<float>& times, float time)
+{
+    uint32_t i = 0;
+    while (i + 1 < times.size() && times[i + 1] < time)
+        i++;
+    return i;
+}
+
+std::vector<float> randomKeyTimes(rmdltest::Random& random, uint32_t count)
+{
+    std::vector<float> times(count);
+    float time = 0.0f;
+    for (uint32_t k = 0; k < count; k++)
+    {
+        times[k] = time;
+        // Quelques clés au même instant, comme en sortent certains exports
+        time += random.range(0, 9) == 0 ? 0.0f : random.uniform(0.005f, 0.1f);
+    }
+    return times;
+}
+
+}
+
+// Curseur et recherche binaire contre le balayage linéaire, sur une lecture réaliste : avance
+// frame par frame à vitesse variable, bouclage, seeks en arrière et grands sauts en avant,
+// temps exactement sur une clé et hors de la piste
+RMDL_TEST(keyCursorMatchesBinarySearchOnSeeksAndLoops)
+{
+    rmdltest::Random random;
+    int cursorMismatches = 0;
+    int binaryMismatches = 0;
+    int cursorOutOfRange = 0;
+    for (int track = 0; track < 200; track++)
+    {
+        uint32_t count = (uint32_t)random.range(2, track % 2 ? 12 : 400);
+        std::vector<float> times = randomKeyTimes(random, count);
+        auto timeAt = [&times](uint32_t k) { return times[k]; };
+        const float duration = times.back();
+
+        uint32_t cursor = 0;
+        float time = 0.0f;
+        for (int frame = 0; frame < 2000; frame++)
+        {
+            switch (random.range(0, 19))
+            {
+                case 0:  time = random.uniform(0.0f, duration); break;                              // seek n'importe où
+                case 1:  time = std::max(0.0f, time - random.uniform(0.0f, duration * 0.5f)); break; // retour en arrière
+                case 2:  time += random.uniform(0.0f, duration * 0.5f); break;                      // grand saut
+                case 3:  time = times[random.range(0, (int)count - 1)]; break;                      // pile sur une clé
+                case 4:  time = random.uniform(-1.0f, 0.0f); break;                                 // avant la première clé
+                default: time += random.uniform(0.0f, 0.04f) * random.uniform(0.25f, 3.0f); break;  // lecture, vitesse variable
+            }
+            // Bouclage comme dans updateBlender, avec parfois le temps juste après la fin
+            if (time > duration)
+                time = random.range(0, 3) == 0 ? duration + random.uniform(0.0f, 0.01f) : std::fmod(time, duration);
+
+            uint32_t expected = linearKeyIndex(times, time);
+            uint32_t fresh = count;     // curseur invalide : recherche binaire seule
+            cursorMismatches += findKeyIndex(count, timeAt, time, cursor) != expected;
+            binaryMismatches += findKeyIndex(count, timeAt, time, fresh) != expected;
+            cursorOutOfRange += cursor >= count;
+        }
+    }
+    RMDL_CHECK(cursorMismatches == 0);
+    RMDL_CHECK(binaryMismatches == 0);
+    RMDL_CHECK(cursorOutOfRange == 0);
+}
+
+// 100 squelettes de 64 canaux sur un clip long (60 s à 30 clés/s, 1801 clés par piste), chacun à
+// sa phase et sa vitesse, en lecture frame par frame : curseurs gardés d'une frame à l'autre
+// contre des curseurs invalidés à chaque échantillon (recherche binaire seule)
+RMDL_BENCH(keyCursorVersusBinarySearch)
+{
+    rmdltest::Random random;
+    Animation anim;
+    anim.name = "long";
+    anim.duration = 60.0f;
+    anim.ticksPerSec = 1.0f;
+    const uint32_t channelCount = 64;
+    const uint32_t keyCount = 1801;
+    for (uint32_t c = 0; c < channelCount; c++)
+    {
+        BoneAnimation channel;
+        channel.boneName = "bone_" + std::to_string(c);
+        float phase = random.uniform(0.0f, 6.28f);
+        simd::float3 axis = simd::normalize(simd::float3{ random.uniform(-1.0f, 1.0f), random.uniform(-1.0f, 1.0f), random.uniform(0.1f, 1.0f) });
+        for (uint32_t k = 0; k < keyCount; k++)
+        {
+            float time = anim.duration * k / (keyCount - 1);
+            float wave = std::sin(phase + 2.0f * time);
+            channel.positions.push_back({ time, simd::float3{ 0.1f * wave, 0.0f, 0.0f } });
+            channel.rotations.push_back({ time, simd_quaternion(0.8f * wave, axis) });
+            channel.scales.push_back({ time, simd::float3{ 1.0f, 1.0f, 1.0f } });
+        }
+        anim.channels.push_back(std::move(channel));
+    }
+
+    const uint32_t skeletonCount = 100;
+    std::vector<float> offsets(skeletonCount), speeds(skeletonCount);
+    for (uint32_t s = 0; s < skeletonCount; s++)
+    {
+        offsets[s] = random.uniform(0.0f, anim.duration);
+        speeds[s] = random.uniform(0.5f, 1.5f);
+    }
+
+    const int frames = 600;
+    const KeyCursor invalid{ keyCount, keyCount, keyCount };
+    auto run = [&](bool keepCursors) {
+        std::vector<KeyCursor> cursors(skeletonCount * channelCount);
+        simd::float3 translation, scale, sum = { 0.0f, 0.0f, 0.0f };
+        simd::quatf rotation;
+        rmdltest::Stopwatch stopwatch;
+        for (int frame = 0; frame < frames; frame++)
+        {
+            for (uint32_t s = 0; s < skeletonCount; s++)
+            {
+                float time = std::fmod(offsets[s] + frame * speeds[s] / 60.0f, anim.duration);
+                KeyCursor* skeletonCursors = &cursors[s * channelCount];
+                for (uint32_t c = 0; c < channelCount; c++)
+                {
+                    if (!keepCursors)
+                        skeletonCursors[c] = invalid;
+                    RMDLBlender::sampleChannel(time, anim, c, skeletonCursors[c], translation, rotation, scale);
+                    sum += translation + rotation.vector.xyz + scale;
+                }
+            }
+        }
+        return std::make_pair(stopwatch.elapsedMs() / frames, sum.x + sum.y + sum.z);
+    };
+    auto [cursorMs, cursorSum] = run(true);
+    auto [binaryMs, binarySum] = run(false);
+    const double samples = (double)skeletonCount * channelCount;
+    printf("%u squelettes x %u canaux, %u clés/piste : curseurs %.3f ms/frame (%.1f ns/canal), "
+           "recherche binaire %.3f ms/frame (%.1f ns/canal), x%.2f\n",
+           skeletonCount, channelCount, keyCount, cursorMs, cursorMs * 1e6 / samples, binaryMs, binaryMs * 1e6 / samples,
+           binaryMs / cursorMs);
+    printf("  somme %.3f / %.3f\n", cursorSum, binarySum);
+}
+
+namespace
+{
+
+aiMatrix4x4 randomTransform(rmdltest::Random& random)
+{
+    aiVector3D axis(random.uniform(-1.0f, 1.0f), random.uniform(-1.0f, 1.0f), random.uniform(0.1f, 1.0f));
+    aiQuaternion rotation(axis.Normalize(), random.uniform(-3.0f, 3.0f));
+    aiVector3D scaling(random.uniform(0.5f, 1.5f), random.uniform(0.5f, 1.5f), random.uniform(0.5f, 1.5f));
+    aiVector3D position(random.uniform(-2.0f, 2.0f), random.uniform(-2.0f, 2.0f), random.uniform(-2.0f, 2.0f));
+    return aiMatrix4x4(scaling, rotation, position);
+}
+
+// Arbre aiNode aléatoire (le parent de chaque noeud est tiré parmi les précédents), comme en
+// sort l'import assimp ; la racine possède tout l'arbre
+aiNode* randomHierarchy(rmdltest::Random& random, uint32_t count)
+{
+    std::vector<aiNode*> nodes;
+    std::vector<std::vector<aiNode*>> children(count);
+    for (uint32_t n = 0; n < count; n++)
+    {
+        nodes.push_back(new aiNode("node_" + std::to_string(n)));
+        nodes.back()->mTransformation = randomTransform(random);
+        if (n > 0)
+            children[random.range(0, (int)n - 1)].push_back(nodes.back());
+    }
+    for (uint32_t n = 0; n < count; n++)
+        if (!children[n].empty())
+            nodes[n]->addChildren((unsigned)children[n].size(), children[n].data());
+    return nodes[0];
+}
+
+// Parcours préfixe de référence : noeud, parent et nom, dans l'ordre des enfants d'assimp
+void preorder(const aiNode* node, int32_t parent, std::vector<const aiNode*>& nodes, std::vector<int32_t>& parents)
+{
+    int32_t index = (int32_t)nodes.size();
+    nodes.push_back(node);
+    parents.push_back(parent);
+    for (unsigned i = 0; i < node->mNumChildren; i++)
+        preorder(node->mChildren[i], index, nodes, parents);
+}
+
+// Bones sur une partie des noeuds, plus un bone dont le noeud n'existe pas ; clips animant
+// chacun une partie des noeuds dans le désordre, avec un canal orphelin et un doublon
+void randomRig(rmdltest::Random& random, const std::vector<const aiNode*>& nodes, Blender& model)
+{
+    for (const aiNode* node : nodes)
+    {
+        if (random.range(0, 2) == 0)
+            continue;
+        BoneInfo bone;
+        bone.id = model.boneCount++;
+        bone.offset = matrix_identity_float4x4;
+        model.boneMap[node->mName.C_Str()] = bone;
+        model.boneOffsets.push_back(bone.offset);
+    }
+    model.boneMap["absent_bone"] = BoneInfo{ model.boneCount++, matrix_identity_float4x4 };
+    model.boneOffsets.push_back(matrix_identity_float4x4);
+    
+    for (int clip = 0; clip < 3; clip++)
+    {
+        Animation anim;
+        anim.name = "clip_" + std::to_string(clip);
+        for (const aiNode* node : nodes)
+        {
+            if (random.range(0, 1) == 0)
+                continue;
+            BoneAnimation channel;
+            channel.boneName = node->mName.C_Str();
+            anim.channels.push_back(channel);
+        }
+        anim.channels.push_back({ "absent_node", {}, {}, {} });
+        anim.channels.push_back(anim.channels[random.range(0, (int)anim.channels.size() - 1)]);
+        for (size_t c = anim.channels.size(); c > 1; c--)
+            std::swap(anim.channels[c - 1], anim.channels[random.range(0, (int)c - 1)]);
+        model.animations.push_back(std::move(anim));
+    }
+}
+
+}
+
+// Tables résolues au chargement contre une recherche par nom : le Skeleton suit l'ordre préfixe
+// d'assimp (parents, noms, transforms locales), nodeBones[n] est l'id du bone du même nom et
+// nodeChannels[n] le premier canal du clip qui porte ce nom, -1 sinon
+RMDL_TEST(bindingTablesMapNodesToBonesAndChannels)
+{
+    rmdltest::Random random;
+    int hierarchyErrors = 0;
+    int boneErrors = 0;
+    int channelErrors = 0;
+    int boundChannels = 0;
+    for (int rig = 0; rig < 50; rig++)
+    {
+        aiNode* root = randomHierarchy(random, (uint32_t)random.range(1, 80));
+        std::vector<const aiNode*> nodes;
+        std::vector<int32_t> parents;
+        preorder(root, -1, nodes, parents);
+        
+        Blender model;
+        RMDLBlender::flattenHierarchy(root, -1, model.skeleton);
+        randomRig(random, nodes, model);
+        RMDLBlender::bindSkeleton(model);
+        
+        const Skeleton& skeleton = model.skeleton;
+        hierarchyErrors += skeleton.size() != nodes.size() || skeleton.parents != parents
+                           || skeleton.nodeBones.size() != nodes.size();
+        for (uint32_t n = 0; n < skeleton.size() && n < nodes.size(); n++)
+        {
+            const aiMatrix4x4& m = nodes[n]->mTransformation;
+            const simd::float4x4& local = skeleton.localBind[n];
+            // Colonne 3 = translation (a4, b4, c4) de la matrice assimp en lignes
+            hierarchyErrors += skeleton.names[n] != nodes[n]->mName.C_Str() || skeleton.parents[n] >= (int32_t)n
+                               || local.columns[3].x != m.a4 || local.columns[3].y != m.b4 || local.columns[3].z != m.c4
+                               || local.columns[0].y != m.b1 || local.columns[1].x != m.a2;
+            
+            auto bone = model.boneMap.find(skeleton.names[n]);
+            boneErrors += skeleton.nodeBones[n] != (bone != model.boneMap.end() ? bone->second.id : -1);
+            
+            for (const Animation& anim : model.animations)
+            {
+                int32_t expected = -1;
+                for (size_t c = 0; c < anim.channels.size() && expected < 0; c++)
+                    if (anim.channels[c].boneName == skeleton.names[n])
+                        expected = (int32_t)c;
+                channelErrors += anim.nodeChannels.size() != skeleton.size() || anim.nodeChannels[n] != expected;
+                boundChannels += expected >= 0;
+            }
+        }
+        delete root;
+    }
+    RMDL_CHECK(hierarchyErrors == 0);
+    RMDL_CHECK(boneErrors == 0);
+    RMDL_CHECK(channelErrors == 0);
+    RMDL_CHECK(boundChannels > 0);
+}
+
+namespace
+{
+
+simd::quatf randomRotation(rmdltest::Random& random)
+{
+    simd::float3 axis = simd::normalize(simd::float3{ random.uniform(-1.0f, 1.0f), random.uniform(-1.0f, 1.0f), random.uniform(0.1f, 1.0f) });
+    return simd_quaternion(random.uniform(-3.0f, 3.0f), axis);
+}
+
+simd::float4x4 randomMatrix(rmdltest::Random& random)
+{
+    simd::float4x4 m = simd::float4x4(randomRotation(random));
+    m.columns[3] = simd::float4{ random.uniform(-1.0f, 1.0f), random.uniform(-1.0f, 1.0f), random.uniform(-1.0f, 1.0f), 1.0f };
+    return m;
+}
+
+template<typename T, typename Make>
+std::vector<KeyFrame<T>> randomTrack(rmdltest::Random& random, float duration, Make make)
+{
+    uint32_t count = (uint32_t)random.range(1, 12);
+    std::vector<KeyFrame<T>> keys(count);
+    for (uint32_t k = 0; k < count; k++)
+        keys[k] = { count > 1 ? duration * k / (count - 1) : 0.0f, make() };
+    return keys;
+}
+
+// Rig complet sur la hiérarchie : bones avec offsets, un clip à clés sur une partie des noeuds
+void randomAnimatedRig(rmdltest::Random& random, aiNode* root, Blender& model, bool compressed)
+{
+    RMDLBlender::flattenHierarchy(root, -1, model.skeleton);
+    
+    Animation anim;
+    anim.name = "clip";
+    anim.duration = 2.0f;
+    anim.ticksPerSec = 1.0f;
+    for (const std::string& name : model.skeleton.names)
+    {
+        if (random.range(0, 3) != 0)
+        {
+            BoneInfo bone{ model.boneCount++, randomMatrix(random) };
+            model.boneMap[name] = bone;
+            model.boneOffsets.push_back(bone.offset);
+        }
+        if (random.range(0, 2) != 0)
+        {
+            BoneAnimation channel;
+            channel.boneName = name;
+            channel.positions = randomTrack<simd::float3>(random, anim.duration, [&] {
+                return simd::float3{ random.uniform(-1.0f, 1.0f), random.uniform(-1.0f, 1.0f), random.uniform(-1.0f, 1.0f) }; });
+            channel.rotations = randomTrack<simd::quatf>(random, anim.duration, [&] { return randomRotation(random); });
+            channel.scales = randomTrack<simd::float3>(random, anim.duration, [&] {
+                return simd::float3{ random.uniform(0.8f, 1.2f), random.uniform(0.8f, 1.2f), random.uniform(0.8f, 1.2f) }; });
+            anim.channels.push_back(channel);
+        }
+    }
+    if (compressed)
+        animcompression::compress(anim, animcompression::Settings{}, anim.compressed);
+    
+    model.keyCursors.emplace_back(anim.channels.size());
+    model.animations.push_back(std::move(anim));
+    model.boneMatrices.assign(model.boneCount, matrix_identity_float4x4);
+    RMDLBlender::bindSkeleton(model);
+    RMDLBlender::preparePoses(model);
+}
+
+// Évaluateur récursif d'avant l'aplatissement en Skeleton, gardé tel quel comme référence :
+// copie de l'arbre en NodeData, puis parcours en profondeur qui résout bone et canal par nom
+struct NodeData
+{
+    std::string name;
+    simd::float4x4 transform;
+    std::vector<NodeData> children;
+};
+
+NodeData copyNodeHierarchy(const aiNode* node)
+{
+    const aiMatrix4x4& m = node->mTransformation;
+    NodeData data;
+    data.name = node->mName.C_Str();
+    data.transform = simd::float4x4{simd::float4{m.a1, m.b1, m.c1, m.d1},
+                                    simd::float4{m.a2, m.b2, m.c2, m.d2},
+                                    simd::float4{m.a3, m.b3, m.c3, m.d3},
+                                    simd::float4{m.a4, m.b4, m.c4, m.d4}};
+    data.children.reserve(node->mNumChildren);
+    for (unsigned i = 0; i < node->mNumChildren; i++)
+        data.children.push_back(copyNodeHierarchy(node->mChildren[i]));
+    return data;
+}
+
+// Même composition que makeTRS dans RMDLBlender.cpp
+simd::float4x4 referenceTRS(simd::float3 t, simd::quatf r, simd::float3 s)
+{
+    simd::float4x4 T{simd::float4{ 1, 0, 0, 0 },
+                     simd::float4{ 0, 1, 0, 0 },
+                     simd::float4{ 0, 0, 1, 0 }, simd::float4{ t.x, t.y, t.z, 1 }};
+
+    simd::float4x4 S{simd::float4{ s.x, 0,   0,   0 },
+                     simd::float4{ 0,   s.y, 0,   0 },
+                     simd::float4{ 0,   0,   s.z, 0 }, simd::float4{ 0, 0, 0, 1 }};
+
+    return T * simd::float4x4(r) * S;
+}
+
+void computeBoneTransformsRecursive(float time, const NodeData& node, const simd::float4x4& parentTf,
+                                    const Blender& model, std::vector<simd::float4x4>& boneMatrices)
+{
+    const Animation& anim = model.animations[model.currentAnimation];
+    simd::float4x4 localTf = node.transform;
+    for (size_t c = 0; c < anim.channels.size(); c++)
+    {
+        if (anim.channels[c].boneName == node.name)
+        {
+            KeyCursor cursor;
+            simd::float3 translation, scale;
+            simd::quatf rotation;
+            RMDLBlender::sampleChannel(time, anim, c, cursor, translation, rotation, scale);
+            localTf = referenceTRS(translation, rotation, scale);
+            break;
+        }
+    }
+    simd::float4x4 globalTf = parentTf * localTf;
+    
+    auto bone = model.boneMap.find(node.name);
+    if (bone != model.boneMap.end())
+        boneMatrices[bone->second.id] = globalTf * model.boneOffsets[bone->second.id];
+    
+    for (const auto& child : node.children)
+        computeBoneTransformsRecursive(time, child, globalTf, model, boneMatrices);
+}
+
+}
+
+// Passe linéaire sur le Skeleton contre l'évaluateur récursif : mêmes matrices de bones finales,
+// à l'égalité flottante près, sur des hiérarchies aléatoires, clips bruts et compressés, en
+// lecture, après bouclage et sur des seeks
+RMDL_TEST(flattenedSkeletonMatchesRecursiveEvaluator)
+{
+    rmdltest::Random random;
+    const simd::float4x4 identity = matrix_identity_float4x4;
+    int mismatchedMatrices = 0;
+    size_t comparedMatrices = 0;
+    for (int rig = 0; rig < 40; rig++)
+    {
+        aiNode* root = randomHierarchy(random, (uint32_t)random.range(1, 60));
+        Blender model;
+        randomAnimatedRig(random, root, model, rig % 2 == 1);
+        NodeData tree = copyNodeHierarchy(root);
+        delete root;
+        
+        std::vector<simd::float4x4> reference(model.boneCount);
+        float time = 0.0f;
+        for (int frame = 0; frame < 120; frame++)
+        {
+            time = frame % 40 == 39 ? random.uniform(0.0f, 2.0f) : std::fmod(time + 0.037f, 2.0f);
+            RMDLBlender::computeBoneTransforms(time, model);
+            std::fill(reference.begin(), reference.end(), identity);
+            computeBoneTransformsRecursive(time, tree, identity, model, reference);
+            
+            for (int b = 0; b < model.boneCount; b++)
+            {
+                bool same = true;
+                for (int c = 0; c < 4; c++)
+                    for (int r = 0; r < 4; r++)
+                        same = same && model.boneMatrices[b].columns[c][r] == reference[b].columns[c][r];
+                mismatchedMatrices += !same;
+                comparedMatrices++;
+            }
+        }
+    }
+    RMDL_CHECK(mismatchedMatrices == 0);
+    RMDL_CHECK(comparedMatrices > 0);
+}
+
+// Rigs d'environ 60 et 100 bones, 200 instances chacune à sa phase : passe linéaire sur le
+// Skeleton contre l'évaluateur récursif (copie NodeData, bone et canal cherchés par nom)
+RMDL_BENCH(flattenedSkeletonVersusRecursive)
+{
+    rmdltest::Random random;
+    const simd::float4x4 identity = matrix_identity_float4x4;
+    const uint32_t instanceCount = 200;
+    const int frames = 60;
+    for (uint32_t nodeCount : { 80u, 130u })
+    {
+        aiNode* root = randomHierarchy(random, nodeCount);
+        Blender model;
+        randomAnimatedRig(random, root, model, false);
+        NodeData tree = copyNodeHierarchy(root);
+        delete root;
+
+        std::vector<float> offsets(instanceCount);
+        for (float& offset : offsets)
+            offset = random.uniform(0.0f, 2.0f);
+
+        float checksum = 0.0f;
+        rmdltest::Stopwatch stopwatch;
+        for (int frame = 0; frame < frames; frame++)
+            for (uint32_t i = 0; i < instanceCount; i++)
+            {
+                RMDLBlender::computeBoneTransforms(std::fmod(offsets[i] + frame / 60.0f, 2.0f), model);
+                checksum += model.boneMatrices[0].columns[3].x;
+            }
+        double flattenedMs = stopwatch.elapsedMs() / frames;
+
+        std::vector<simd::float4x4> reference(model.boneCount);
+        stopwatch.restart();
+        for (int frame = 0; frame < frames; frame++)
+            for (uint32_t i = 0; i < instanceCount; i++)
+            {
+                std::fill(reference.begin(), reference.end(), identity);
+                computeBoneTransformsRecursive(std::fmod(offsets[i] + frame / 60.0f, 2.0f), tree, identity, model, reference);
+                checksum -= reference[0].columns[3].x;
+            }
+        double recursiveMs = stopwatch.elapsedMs() / frames;
+
+        printf("%u instances x %d bones (%u noeuds, %zu canaux) : aplati %.3f ms/frame (%.2f us/instance), "
+               "récursif %.3f ms/frame (%.2f us/instance), x%.1f (%.3f)\n",
+               instanceCount, model.boneCount, nodeCount, model.animations[0].channels.size(),
+               flattenedMs, flattenedMs * 1e3 / instanceCount, recursiveMs, recursiveMs * 1e3 / instanceCount,
+               recursiveMs / flattenedMs, checksum);
+    }
+}
+
+namespace
+{
+
+LocalPose randomPose(rmdltest::Random& random, uint32_t count)
+{
+    LocalPose pose;
+    pose.resize(count);
+    for (uint32_t n = 0; n < count; n++)
+    {
+        pose.translations[n] = simd::float3{ random.uniform(-1.0f, 1.0f), random.uniform(-1.0f, 1.0f), random.uniform(-1.0f, 1.0f) };
+        pose.rotations[n] = randomRotation(random);
+        pose.scales[n] = simd::float3{ random.uniform(0.5f, 1.5f), random.uniform(0.5f, 1.5f), random.uniform(0.5f, 1.5f) };
+    }
+    return pose;
+}
+
+// q et -q sont la même rotation
+bool sameRotation(simd::quatf a, simd::quatf b, float tolerance)
+{
+    return std::fabs(std::fabs(simd::dot(a, b)) - 1.0f) <= tolerance;
+}
+
+bool samePose(const LocalPose& a, const LocalPose& b, uint32_t n, float tolerance)
+{
+    return simd::distance(a.translations[n], b.translations[n]) <= tolerance && sameRotation(a.rotations[n], b.rotations[n], tolerance)
+           && simd::distance(a.scales[n], b.scales[n]) <= tolerance;
+}
+
+bool identicalPose(const LocalPose& a, const LocalPose& b, uint32_t n)
+{
+    return simd::all(a.translations[n] == b.translations[n]) && simd::all(a.rotations[n].vector == b.rotations[n].vector)
+           && simd::all(a.scales[n] == b.scales[n]);
+}
+
+}
+
+// blendPose : poids 0 ou masque nul laissent la pose intacte au bit près, poids 1 donne la source,
+// 0.5 le milieu (translation moyenne, moitié de l'angle), et le masque multiplie le poids du layer
+RMDL_TEST(blendPoseHonoursWeightAndMask)
+{
+    rmdltest::Random random;
+    const uint32_t count = 64;
+    int errors = 0;
+    for (int round = 0; round < 50; round++)
+    {
+        const LocalPose a = randomPose(random, count);
+        const LocalPose b = randomPose(random, count);
+        
+        LocalPose pose = a;
+        RMDLBlender::blendPose(pose, b, 0.0f, nullptr);
+        for (uint32_t n = 0; n < count; n++)
+            errors += !identicalPose(pose, a, n);
+        
+        pose = a;
+        RMDLBlender::blendPose(pose, b, 1.0f, nullptr);
+        for (uint32_t n = 0; n < count; n++)
+            errors += !samePose(pose, b, n, 1e-5f);
+        
+        pose = a;
+        RMDLBlender::blendPose(pose, b, 0.5f, nullptr);
+        for (uint32_t n = 0; n < count; n++)
+        {
+            float full = std::acos(std::min(1.0f, std::fabs(simd::dot(a.rotations[n], b.rotations[n]))));
+            float half = std::acos(std::min(1.0f, std::fabs(simd::dot(a.rotations[n], pose.rotations[n]))));
+            errors += simd::distance(pose.translations[n], (a.translations[n] + b.translations[n]) * 0.5f) > 1e-5f
+                      || std::fabs(half - full * 0.5f) > 1e-3f;
+        }
+        
+        // Masque 0 / 0.5 / 1 par noeud sous un layer à 0.8 : équivalent à un poids 0 / 0.4 / 0.8
+        std::vector<float> mask(count);
+        for (uint32_t n = 0; n < count; n++)
+            mask[n] = 0.5f * random.range(0, 2);
+        pose = a;
+        RMDLBlender::blendPose(pose, b, 0.8f, mask.data());
+        for (uint32_t n = 0; n < count; n++)
+        {
+            LocalPose single = a;
+            RMDLBlender::blendPose(single, b, 0.8f * mask[n], nullptr);
+            errors += mask[n] == 0.0f ? !identicalPose(pose, a, n) : !samePose(pose, single, n, 1e-6f);
+        }
+    }
+    RMDL_CHECK(errors == 0);
+}
+
+// addPose : une source égale à la référence ne change rien ; sinon l'écart (translation ajoutée,
+// rotation prémultipliée, échelle en rapport) est appliqué en entier à poids 1, à moitié à 0.5,
+// et seulement là où le masque est non nul
+RMDL_TEST(additivePoseAppliesDeltaFromReference)
+{
+    rmdltest::Random random;
+    const uint32_t count = 64;
+    int errors = 0;
+    for (int round = 0; round < 50; round++)
+    {
+        const LocalPose base = randomPose(random, count);
+        const LocalPose reference = randomPose(random, count);
+        
+        LocalPose pose = base;
+        RMDLBlender::addPose(pose, reference, reference, 1.0f, nullptr);
+        for (uint32_t n = 0; n < count; n++)
+            errors += !samePose(pose, base, n, 1e-5f);
+        
+        LocalPose source = reference;
+        std::vector<simd::float3> offsets(count);
+        std::vector<simd::quatf> deltas(count);
+        std::vector<simd::float3> ratios(count);
+        for (uint32_t n = 0; n < count; n++)
+        {
+            offsets[n] = simd::float3{ random.uniform(-1.0f, 1.0f), random.uniform(-1.0f, 1.0f), random.uniform(-1.0f, 1.0f) };
+            deltas[n] = simd_quaternion(random.uniform(-1.5f, 1.5f), simd::normalize(simd::float3{ random.uniform(-1.0f, 1.0f), 1.0f, random.uniform(-1.0f, 1.0f) }));
+            ratios[n] = simd::float3{ random.uniform(0.5f, 2.0f), random.uniform(0.5f, 2.0f), random.uniform(0.5f, 2.0f) };
+            source.translations[n] += offsets[n];
+            source.rotations[n] = deltas[n] * source.rotations[n];
+            source.scales[n] *= ratios[n];
+        }
+        
+        pose = base;
+        RMDLBlender::addPose(pose, source, reference, 1.0f, nullptr);
+        for (uint32_t n = 0; n < count; n++)
+            errors += simd::distance(pose.translations[n], base.translations[n] + offsets[n]) > 1e-5f
+                      || !sameRotation(pose.rotations[n], deltas[n] * base.rotations[n], 1e-5f)
+                      || simd::distance(pose.scales[n], base.scales[n] * ratios[n]) > 1e-4f;
+        
+        std::vector<float> mask(count);
+        for (uint32_t n = 0; n < count; n++)
+            mask[n] = (float)random.range(0, 1);
+        pose = base;
+        RMDLBlender::addPose(pose, source, reference, 0.5f, mask.data());
+        for (uint32_t n = 0; n < count; n++)
+        {
+            if (mask[n] == 0.0f)
+            {
+                errors += !identicalPose(pose, base, n);
+                continue;
+            }
+            simd::quatf halfDelta = simd::slerp(simd_quaternion(0.0f, 0.0f, 0.0f, 1.0f), deltas[n], 0.5f);
+            errors += simd::distance(pose.translations[n], base.translations[n] + offsets[n] * 0.5f) > 1e-5f
+                      || !sameRotation(pose.rotations[n], halfDelta * base.rotations[n], 1e-5f)
+                      || simd::distance(pose.scales[n], base.scales[n] * (1.0f + (ratios[n] - 1.0f) * 0.5f)) > 1e-4f;
+        }
+    }
+    RMDL_CHECK(errors == 0);
+}
+
+// maskSubtree contre une remontée des parents : seuls root et ses descendants prennent le poids,
+// le reste garde 1 (ou sa valeur précédente), et includeChildren = false ne touche que root
+RMDL_TEST(boneMaskCoversExactlyTheSubtree)
+{
+    rmdltest::Random random;
+    int errors = 0;
+    for (int rig = 0; rig < 50; rig++)
+    {
+        aiNode* hierarchy = randomHierarchy(random, (uint32_t)random.range(1, 80));
+        Skeleton skeleton;
+        RMDLBlender::flattenHierarchy(hierarchy, -1, skeleton);
+        delete hierarchy;
+        
+        int32_t root = random.range(0, (int)skeleton.size() - 1);
+        std::vector<float> mask;
+        RMDLBlender::maskSubtree(skeleton, root, 0.25f, true, mask);
+        
+        int32_t leaf = random.range(0, (int)skeleton.size() - 1);
+        std::vector<float> single(skeleton.size(), 0.5f);
+        RMDLBlender::maskSubtree(skeleton, leaf, 0.0f, false, single);
+        
+        errors += mask.size() != skeleton.size();
+        for (uint32_t n = 0; n < skeleton.size() && n < mask.size(); n++)
+        {
+            bool inSubtree = false;
+            for (int32_t node = (int32_t)n; node >= 0 && !inSubtree; node = skeleton.parents[node])
+                inSubtree = node == root;
+            errors += mask[n] != (inSubtree ? 0.25f : 1.0f);
+            errors += single[n] != ((int32_t)n == leaf ? 0.0f : 0.5f);
+        }
+    }
+    RMDL_CHECK(errors == 0);
+}
+
+// Coût par bone de blendPose et addPose sur un rig de 100 noeuds : sans masque, masque de layer
+// sur un sous-arbre d'environ la moitié du rig (0 ailleurs), masque plein. Chaque appel repart de
+// la même pose ; le coût de cette recopie, mesuré seul, est déduit
+RMDL_BENCH(blendCostPerBone)
+{
+    rmdltest::Random random;
+    aiNode* hierarchy = randomHierarchy(random, 100);
+    Skeleton skeleton;
+    RMDLBlender::flattenHierarchy(hierarchy, -1, skeleton);
+    delete hierarchy;
+    const uint32_t count = skeleton.size();
+
+    // Sous-arbre le plus proche de la moitié du rig, comme un haut du corps
+    int32_t subtreeRoot = 0;
+    uint32_t bestSize = count;
+    for (uint32_t n = 1; n < count; n++)
+    {
+        uint32_t size = 1;
+        while (n + size < count && skeleton.parents[n + size] >= (int32_t)n)
+            size++;
+        if (std::abs((int)size - (int)count / 2) < std::abs((int)bestSize - (int)count / 2))
+        {
+            subtreeRoot = (int32_t)n;
+            bestSize = size;
+        }
+    }
+    std::vector<float> layerMask(count, 0.0f);
+    RMDLBlender::maskSubtree(skeleton, subtreeRoot, 1.0f, true, layerMask);
+    std::vector<float> fullMask(count, 1.0f);
+
+    const LocalPose base = randomPose(random, count);
+    const LocalPose source = randomPose(random, count);
+    const LocalPose reference = randomPose(random, count);
+    LocalPose pose = base;
+    const int iterations = 20000;
+    float checksum = 0.0f;
+
+    rmdltest::Stopwatch stopwatch;
+    for (int i = 0; i < iterations; i++)
+    {
+        pose = base;
+        checksum += pose.translations[i % count].x;
+    }
+    const double copyMs = stopwatch.elapsedMs();
+
+    struct Case { const char* name; const float* mask; uint32_t weighted; };
+    const Case cases[] = { { "sans masque", nullptr, count }, { "masque sous-arbre", layerMask.data(), bestSize }, { "masque plein", fullMask.data(), count } };
+    for (bool additive : { false, true })
+        for (const Case& entry : cases)
+        {
+            stopwatch.restart();
+            for (int i = 0; i < iterations; i++)
+            {
+                pose = base;
+                if (additive)
+                    RMDLBlender::addPose(pose, source, reference, 0.7f, entry.mask);
+                else
+                    RMDLBlender::blendPose(pose, source, 0.7f, entry.mask);
+                checksum += pose.translations[i % count].x;
+            }
+            double ms = std::max(0.0, stopwatch.elapsedMs() - copyMs);
+            printf("%s %u bones, %-17s : %.1f ns/bone du rig, %.1f ns/bone pondéré (%u)\n",
+                   additive ? "addPose  " : "blendPose", count, entry.name, ms * 1e6 / ((double)iterations * count),
+                   ms * 1e6 / ((double)iterations * entry.weighted), entry.weighted);
+        }
+    printf("  recopie de la pose déduite : %.1f ns/bone (%.3f)\n", copyMs * 1e6 / ((double)iterations * count), checksum);
+}
+
+// Débit du sampler : 128 canaux à 30 clés/s sur 4 s (courbes lisses, comme une capture), lus en
+// avançant dans le temps comme pendant le jeu. Clés brutes contre pools quantifiés du même clip.
+RMDL_BENCH(decodeCompressedClip)
+{
+    rmdltest::Random random;
+    Animation anim;
+    anim.name = "capture";
+    anim.duration = 4.0f;
+    anim.ticksPerSec = 1.0f;
+    const uint32_t channelCount = 128;
+    const uint32_t keyCount = 121;
+    for (uint32_t c = 0; c < channelCount; c++)
+    {
+        BoneAnimation channel;
+        channel.boneName = "bone_" + std::to_string(c);
+        float phase = random.uniform(0.0f, 6.28f);
+        float speed = random.uniform(0.5f, 3.0f);
+        simd::float3 axis = simd::normalize(simd::float3{ random.uniform(-1.0f, 1.0f), random.uniform(-1.0f, 1.0f), random.uniform(0.1f, 1.0f) });
+        for (uint32_t k = 0; k < keyCount; k++)
+        {
+            float time = anim.duration * k / (keyCount - 1);
+            float wave = std::sin(phase + speed * time);
+            channel.positions.push_back({ time, simd::float3{ 0.1f * wave, 0.05f * std::cos(speed * time), 0.0f } });
+            channel.rotations.push_back({ time, simd_quaternion(0.8f * wave, axis) });
+            channel.scales.push_back({ time, simd::float3{ 1.0f, 1.0f, 1.0f } });
+        }
+        anim.channels.push_back(std::move(channel));
+    }
+    Animation compressed = anim;
+    animcompression::Stats stats = animcompression::compress(anim, animcompression::Settings{}, compressed.compressed);
+
+    const int frames = 4000;
+    auto run = [&](const Animation& clip) {
+        std::vector<KeyCursor> cursors(channelCount);
+        simd::float3 translation, scale, sum = { 0.0f, 0.0f, 0.0f };
+        simd::quatf rotation;
+        rmdltest::Stopwatch stopwatch;
+        for (int frame = 0; frame < frames; frame++)
+        {
+            float time = std::fmod(frame * (1.0f / 60.0f), anim.duration);
+            for (uint32_t c = 0; c < channelCount; c++)
+            {
+                RMDLBlender::sampleChannel(time, clip, c, cursors[c], translation, rotation, scale);
+                sum += translation + rotation.vector.xyz + scale;
+            }
+        }
+        double ms = stopwatch.elapsedMs();
+        return std::make_pair(ms * 1e6 / ((double)frames * channelCount), sum.x + sum.y + sum.z);
+    };
+    auto [rawNs, rawSum] = run(anim);
+    auto [compressedNs, compressedSum] = run(compressed);
+    printf("échantillonnage : %.1f ns/canal en clés brutes, %.1f ns/canal compressé (%.1f M canaux/s)\n",
+           rawNs, compressedNs, 1e3 / compressedNs);
+    printf("  %zu -> %zu clés, %.1f Ko -> %.1f Ko (x%.1f), somme %.3f / %.3f\n", stats.rawKeys, stats.keptKeys,
+           stats.rawBytes / 1024.0, stats.compressedBytes / 1024.0, stats.ratio(), rawSum, compressedSum);
+}
+
+namespace
+{
+
+// Foule sur un même rig : positions sur un disque de 120 m autour de l'origine (les trois LOD),
+// vitesses différentes, un fondu de temps en temps pour passer par le chemin de blend
+void populateCrowd(rmdltest::Random& random, const Blender& rig, uint32_t count, AnimationSystem& crowd)
+{
+    for (uint32_t i = 0; i < count; i++)
+    {
+        uint32_t instance = crowd.addInstance(&rig);
+        float angle = random.uniform(0.0f, 6.28f);
+        float radius = random.uniform(0.0f, 120.0f);
+        crowd.setPosition(instance, simd::float3{ radius * std::cos(angle), 0.0f, radius * std::sin(angle) });
+        crowd.setSpeed(instance, random.uniform(0.5f, 1.5f));
+    }
+}
+
+void stepCrowd(AnimationSystem& crowd, int frame)
+{
+    if (frame % 30 == 0)
+        for (uint32_t i = (uint32_t)frame % 7; i < crowd.getInstanceCount(); i += 7)
+            crowd.play(i, 0, true, 0.25f);
+    crowd.update(1.0f / 60.0f, simd::float3{ 0.0f, 0.0f, 0.0f });
+}
+
+}
+
+// Le découpage en jobs ne change rien au résultat : mêmes palettes au bit près sans worker et
+// avec 4 workers, frame après frame (à lancer aussi sous TSan)
+RMDL_TEST(crowdPaletteIsIndependentOfWorkerCount)
+{
+    rmdltest::Random random;
+    aiNode* hierarchy = randomHierarchy(random, 40);
+    Blender rig;
+    randomAnimatedRig(random, hierarchy, rig, false);
+    delete hierarchy;
+
+    AnimationSystem serial, parallel;
+    serial.setWorkerCount(0);
+    parallel.setWorkerCount(4);
+    rmdltest::Random placement, placementCopy;
+    populateCrowd(placement, rig, 200, serial);
+    populateCrowd(placementCopy, rig, 200, parallel);
+
+    int mismatches = 0;
+    uint32_t evaluated = 0;
+    for (int frame = 0; frame < 90; frame++)
+    {
+        stepCrowd(serial, frame);
+        stepCrowd(parallel, frame);
+        const std::vector<simd::float4x4>& a = serial.getPaletteBuffer();
+        const std::vector<simd::float4x4>& b = parallel.getPaletteBuffer();
+        mismatches += a.size() != b.size() || std::memcmp(a.data(), b.data(), a.size() * sizeof(simd::float4x4)) != 0;
+        evaluated += parallel.getEvaluatedCount();
+    }
+    RMDL_CHECK(mismatches == 0);
+    RMDL_CHECK(evaluated > 0);
+}
+
+// 1000 instances d'un rig de 64 noeuds, LOD actives : ms par frame selon le nombre de workers
+RMDL_BENCH(crowdOfAThousandInstances)
+{
+    rmdltest::Random random;
+    aiNode* hierarchy = randomHierarchy(random, 64);
+    Blender rig;
+    randomAnimatedRig(random, hierarchy, rig, true);
+    delete hierarchy;
+
+    uint32_t hardware = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<uint32_t> workerCounts;
+    for (uint32_t workers = 0; workers < hardware - 1; workers = workers ? workers * 2 : 1)
+        workerCounts.push_back(workers);
+    workerCounts.push_back(hardware - 1);
+
+    const int frames = 600;
+    for (uint32_t workers : workerCounts)
+    {
+        AnimationSystem crowd;
+        crowd.setWorkerCount(workers);
+        rmdltest::Random placement;
+        populateCrowd(placement, rig, 1000, crowd);
+        stepCrowd(crowd, 0);    // démarre les workers hors mesure
+
+        double totalMs = 0.0;
+        double worstMs = 0.0;
+        size_t evaluated = 0;
+        for (int frame = 1; frame <= frames; frame++)
+        {
+            stepCrowd(crowd, frame);
+            totalMs += crowd.getLastUpdateMs();
+            worstMs = std::max(worstMs, crowd.getLastUpdateMs());
+            evaluated += crowd.getEvaluatedCount();
+        }
+        printf("foule 1000 x %u noeuds, %2u worker(s) + appelant : %.3f ms/frame (pire %.3f), %zu évaluées/frame\n",
+               rig.skeleton.size(), workers, totalMs / frames, worstMs, evaluated / frames);
+    }
+}
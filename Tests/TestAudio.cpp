@@ -0,0 +1,638 @@
+//
+//  TestAudio.cpp
+//  Spammy
+//
+//  Created by Rémy on 17/10/2026.
+//
+
+#include "RMDLTest.hpp"
+#include "RMDLHexagonSpace.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <complex>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace
+{
+
+BlockSoundProfile presetFor(int index)
+{
+    switch (index % 6)
+    {
+        case 0: return BlockPresets::Engine();
+        case 1: return BlockPresets::Thruster();
+        case 2: return BlockPresets::Generator();
+        case 3: return BlockPresets::Shield();
+        case 4: return BlockPresets::Weapon();
+        default: return BlockPresets::Cockpit();
+    }
+}
+
+// Sources réparties en distance et en throttle, notes datées au sample ; throttles sans rampe,
+// seule différence voulue entre process et processBlock (throttle constant sur le bloc)
+void scriptVoices(SpaceshipSynthesizer& synth, rmdltest::Random& random, int voiceCount, uint64_t totalFrames)
+{
+    std::vector<int> ids(voiceCount);
+    for (int v = 0; v < voiceCount; v++)
+    {
+        ids[v] = synth.addVoice(presetFor(v));
+        synth.setVoiceDistance(ids[v], random.uniform(2.0f, 60.0f));
+        synth.setVoiceThrottle(ids[v], random.uniform(0.0f, 1.0f));
+    }
+    for (int v = 0; v < voiceCount; v++)
+        synth.triggerVoice(ids[v], random.uniform(0.5f, 1.0f), (uint64_t)v * 37);
+    for (int v = 0; v < voiceCount; v += 3)
+        synth.releaseVoice(ids[v], totalFrames / 2 + (uint64_t)v * 53);
+}
+
+// FFT radix-2 en place, size puissance de 2
+void fft(std::vector<std::complex<double>>& data)
+{
+    const size_t size = data.size();
+    for (size_t i = 1, j = 0; i < size; i++)
+    {
+        size_t bit = size >> 1;
+        for (; j & bit; bit >>= 1)
+            j ^= bit;
+        j ^= bit;
+        if (i < j)
+            std::swap(data[i], data[j]);
+    }
+    for (size_t length = 2; length <= size; length <<= 1)
+    {
+        std::complex<double> step = std::polar(1.0, -2.0 * M_PI / (double)length);
+        for (size_t start = 0; start < size; start += length)
+        {
+            std::complex<double> twiddle = 1.0;
+            for (size_t k = 0; k < length / 2; k++)
+            {
+                std::complex<double> even = data[start + k];
+                std::complex<double> odd = data[start + k + length / 2] * twiddle;
+                data[start + k] = even + odd;
+                data[start + k + length / 2] = even - odd;
+                twiddle *= step;
+            }
+        }
+    }
+}
+
+}
+
+// Table lue à f = cycles * sampleRate / kSpectrumSize : les harmoniques tombent pile sur les bins
+// multiples de cycles. cycles est impair, donc un repliement autour de Nyquist tombe hors de cette
+// grille ; tout ce qui n'est pas harmonique (repliement et erreur d'interpolation) est mesuré
+// contre l'énergie totale. Phase calculée en double : c'est la table qu'on teste, pas l'accumulateur
+RMDL_TEST(wavetablesStayBelowNyquist)
+{
+    const WavetableBank& bank = WavetableBank::shared();
+    const float sampleRate = 48000.0f;
+    const int kSpectrumSize = 8192;
+    int aliasingErrors = 0;
+    int levelErrors = 0;
+    double worstDb = -INFINITY;
+
+    for (int harmonics = 1; harmonics <= WavetableBank::kMaxHarmonics; harmonics++)
+    {
+        for (int cycles : { 7, 19, 75, 233, 601, 1365 })      // ~41 Hz à 8 kHz
+        {
+            float frequency = cycles * sampleRate / kSpectrumSize;
+            const float* table = bank.table(harmonics, frequency, sampleRate);
+
+            std::vector<std::complex<double>> spectrum(kSpectrumSize);
+            for (int n = 0; n < kSpectrumSize; n++)
+            {
+                double phase = std::fmod((double)n * cycles / kSpectrumSize, 1.0);
+                spectrum[n] = WavetableBank::sample(table, (float)phase);
+            }
+            fft(spectrum);
+
+            double harmonicEnergy = 0.0;
+            double otherEnergy = 0.0;
+            for (int bin = 1; bin < kSpectrumSize / 2; bin++)
+            {
+                double energy = std::norm(spectrum[bin]);
+                (bin % cycles == 0 ? harmonicEnergy : otherEnergy) += energy;
+            }
+            double db = 10.0 * std::log10(otherEnergy / harmonicEnergy + 1e-30);
+            worstDb = std::max(worstDb, db);
+            aliasingErrors += db > -60.0;
+
+            // Niveau pas plus pauvre que nécessaire : la dernière harmonique présente a la suivante
+            // de même parité (le carré n'a que les impaires) au-delà de la moitié de la bande
+            int highest = 0;
+            for (int bin = cycles; bin < kSpectrumSize / 2; bin += cycles)
+            {
+                if (std::norm(spectrum[bin]) > harmonicEnergy * 1e-9)
+                    highest = bin / cycles;
+            }
+            levelErrors += (highest + 2) * cycles <= kSpectrumSize / 4;
+        }
+    }
+    printf("pire énergie hors harmoniques : %.1f dB\n", worstDb);
+    RMDL_CHECK(aliasingErrors == 0);
+    RMDL_CHECK(levelErrors == 0);
+}
+
+// renderMono (voix par blocs, effets vectorisés) contre processSample (un sample à la fois),
+// sur le même script : mêmes opérations dans le même ordre, l'écart reste au niveau de l'arrondi
+// tant que les notes tiennent. Après les noteOff, une voix retombée sous le seuil de isActive
+// finit son bloc au lieu de s'arrêter au sample : écart borné par ce seuil
+RMDL_TEST(renderBlockMatchesPerSamplePath)
+{
+    const float sampleRate = 48000.0f;
+    const uint64_t totalFrames = 48000;
+    auto perSample = std::make_unique<SpaceshipSynthesizer>();
+    auto blocks = std::make_unique<SpaceshipSynthesizer>();
+
+    for (SpaceshipSynthesizer* synth : { perSample.get(), blocks.get() })
+    {
+        rmdltest::Random random;
+        synth->init(sampleRate);
+        scriptVoices(*synth, random, 12, totalFrames);
+    }
+
+    std::vector<float> expected(totalFrames), output(totalFrames);
+    for (uint64_t i = 0; i < totalFrames; i++)
+        expected[i] = perSample->processSample();
+    blocks->renderMono(output.data(), (int)totalFrames);
+
+    float peak = 0.0f;
+    float heldError = 0.0f;
+    float maxError = 0.0f;
+    for (uint64_t i = 0; i < totalFrames; i++)
+    {
+        float error = std::fabs(output[i] - expected[i]);
+        peak = std::max(peak, std::fabs(expected[i]));
+        maxError = std::max(maxError, error);
+        if (i < totalFrames / 2)
+            heldError = std::max(heldError, error);
+    }
+    RMDL_CHECK(peak > 0.01f);
+    RMDL_CHECK(heldError <= 1e-5f);
+    RMDL_CHECK(maxError <= 1e-3f);
+    RMDL_CHECK(perSample->getRenderedFrames() == blocks->getRenderedFrames());
+    RMDL_CHECK(blocks->getDroppedEvents() == 0);
+}
+
+// Un événement daté loin dans le futur ne retient plus ceux envoyés après lui, et s'applique à sa frame
+RMDL_TEST(datedEventsDoNotBlockTheRing)
+{
+    const int block = SpaceshipSynthesizer::kBlockSize;
+    auto synth = std::make_unique<SpaceshipSynthesizer>();
+    synth->init(48000.0f);
+    int later = synth->addVoice(BlockPresets::Engine());
+    int now = synth->addVoice(BlockPresets::Shield());
+    synth->triggerVoice(later, 1.0f, 10 * block + 17);
+    synth->triggerVoice(now, 1.0f);
+
+    // Le noteOn non daté est appliqué au premier bloc, la voix démarre au suivant
+    std::vector<float> output(block);
+    int earlyErrors = 0;
+    for (int b = 0; b < 10; b++)
+    {
+        synth->renderMono(output.data(), block);
+        earlyErrors += b >= 1 && synth->getRenderedVoiceCount() != 1;
+    }
+    for (int b = 0; b < 2; b++)
+        synth->renderMono(output.data(), block);
+    RMDL_CHECK(earlyErrors == 0);
+    RMDL_CHECK(synth->getRenderedVoiceCount() == 2);
+
+    // Datés à la même frame : appliqués dans l'ordre d'envoi, le noteOff gagne
+    uint64_t at = synth->getRenderedFrames() + 4 * block;
+    synth->triggerVoice(now, 1.0f, at);
+    synth->releaseVoice(now, at);
+    for (int b = 0; b < 200; b++)
+        synth->renderMono(output.data(), block);
+    RMDL_CHECK(synth->getRenderedVoiceCount() == 1);
+
+    // Un Remove emporte les datés de sa source : l'id réutilisé ne reçoit pas le noteOn de l'ancienne
+    int stale = synth->addVoice(BlockPresets::Weapon());
+    synth->triggerVoice(stale, 1.0f, synth->getRenderedFrames() + 8 * block);
+    synth->removeVoice(stale);
+    int reused = synth->addVoice(BlockPresets::Cockpit());
+    for (int b = 0; b < 20; b++)
+        synth->renderMono(output.data(), block);
+    RMDL_CHECK(reused == stale);
+    RMDL_CHECK(synth->getRenderedVoiceCount() == 1);
+
+    // Plus de datés que m_scheduled n'en garde : le trop-plein le plus proche passe en avance
+    // au lieu d'être perdu (ici le noteOff, envoyé en dernier mais daté avant les autres)
+    at = synth->getRenderedFrames() + 1000 * block;
+    for (size_t i = 0; i < SpaceshipSynthesizer::kScheduledCapacity; i++)
+        synth->rampVoiceThrottle(later, (i % 10) / 10.0f, 0.0f, at + i);
+    synth->releaseVoice(later, at - 1);
+    for (int b = 0; b < 200; b++)
+        synth->renderMono(output.data(), block);
+    RMDL_CHECK(synth->getRenderedVoiceCount() == 0);
+    RMDL_CHECK(synth->getDroppedEvents() == 0);
+}
+
+// Ring pleine, pas de rendu : les réglages sont perdus, addVoice échoue sans consommer d'id,
+// mais NoteOff et Remove attendent côté jeu et repartent : aucune note ne reste tenue
+RMDL_TEST(droppedReleasesAreRetried)
+{
+    const int block = SpaceshipSynthesizer::kBlockSize;
+    auto synth = std::make_unique<SpaceshipSynthesizer>();
+    synth->init(48000.0f);
+    int held = synth->addVoice(BlockPresets::Engine());
+    int removed = synth->addVoice(BlockPresets::Generator());
+    synth->triggerVoice(held, 1.0f);
+    synth->triggerVoice(removed, 1.0f);
+    std::vector<float> output(block);
+    for (int b = 0; b < 4; b++)
+        synth->renderMono(output.data(), block);
+    RMDL_CHECK(synth->getRenderedVoiceCount() == 2);
+
+    for (size_t i = 0; i < SpaceshipSynthesizer::kEventCapacity + 10; i++)
+        synth->setVoiceThrottle(held, 0.5f);
+    RMDL_CHECK(synth->getDroppedEvents() == 10);
+    synth->releaseVoice(held);
+    synth->releaseVoice(removed);
+    synth->removeVoice(removed);
+    RMDL_CHECK(synth->getPendingReleases() == 2);
+    RMDL_CHECK(synth->addVoice(BlockPresets::Weapon()) == -1);
+
+    // Le premier bloc vide la ring ; le noteOn suivant renvoie d'abord les NoteOff/Remove en attente,
+    // sinon le NoteOff couperait la note relancée
+    synth->renderMono(output.data(), block);
+    synth->triggerVoice(held, 1.0f);
+    RMDL_CHECK(synth->getPendingReleases() == 0);
+    for (int b = 0; b < 48000 * 3 / block; b++)
+        synth->renderMono(output.data(), block);
+    RMDL_CHECK(synth->getRenderedVoiceCount() == 1);
+
+    synth->releaseVoice(held);
+    for (int b = 0; b < 48000 * 3 / block; b++)
+        synth->renderMono(output.data(), block);
+    RMDL_CHECK(synth->getRenderedVoiceCount() == 0);
+}
+
+// Un thread pousse sans relâche, l'autre consomme : rien de perdu ni de déchiré, ordre conservé
+RMDL_TEST(spscQueueUnderContention)
+{
+    struct Message
+    {
+        uint64_t sequence;
+        uint64_t payload[7];
+    };
+    static SPSCQueue<Message, 64> queue;
+    const uint64_t count = 200000;
+
+    std::thread producer([&] {
+        for (uint64_t n = 0; n < count; n++)
+        {
+            Message message;
+            message.sequence = n;
+            for (int i = 0; i < 7; i++)
+                message.payload[i] = n * 0x9E3779B97F4A7C15ull + i;
+            while (!queue.push(message))
+                std::this_thread::yield();
+        }
+    });
+
+    uint64_t expected = 0;
+    int orderErrors = 0;
+    int tearErrors = 0;
+    while (expected < count)
+    {
+        const Message* message = queue.front();
+        if (!message)
+        {
+            std::this_thread::yield();
+            continue;
+        }
+        orderErrors += message->sequence != expected;
+        for (int i = 0; i < 7; i++)
+            tearErrors += message->payload[i] != message->sequence * 0x9E3779B97F4A7C15ull + i;
+        queue.pop();
+        expected++;
+    }
+    producer.join();
+    RMDL_CHECK(orderErrors == 0);
+    RMDL_CHECK(tearErrors == 0);
+    RMDL_CHECK(queue.front() == nullptr);
+}
+
+// Le thread de jeu martèle le synthé (sources créées, jouées, réglées, libérées) pendant que le
+// thread audio rend : ring pleine par moments, mais à la fin plus aucune note tenue
+RMDL_TEST(synthUnderEventStorm)
+{
+    const int block = SpaceshipSynthesizer::kBlockSize;
+    auto synth = std::make_unique<SpaceshipSynthesizer>();
+    synth->init(48000.0f);
+    std::atomic<bool> stop{false};
+    std::atomic<int> badSamples{0};
+
+    std::thread audio([&] {
+        std::vector<float> output(block);
+        while (!stop.load(std::memory_order_acquire))
+        {
+            synth->renderMono(output.data(), block);
+            for (float sample : output)
+                badSamples.fetch_add(!std::isfinite(sample) || std::fabs(sample) > 1.0f, std::memory_order_relaxed);
+        }
+    });
+
+    rmdltest::Random random;
+    std::vector<int> live;
+    for (int round = 0; round < 200000; round++)
+    {
+        int action = random.range(0, 9);
+        if (action == 0 || live.empty())
+        {
+            int id = synth->addVoice(presetFor(random.range(0, 5)));
+            if (id >= 0)
+            {
+                live.push_back(id);
+                synth->triggerVoice(id, random.uniform(0.3f, 1.0f), random.range(0, 1) ? 0 : synth->getRenderedFrames() + random.range(0, 4 * block));
+            }
+            continue;
+        }
+        int id = live[random.range(0, (int)live.size() - 1)];
+        switch (action)
+        {
+            case 1: synth->removeVoice(id); live.erase(std::find(live.begin(), live.end(), id)); break;
+            case 2: synth->releaseVoice(id, random.range(0, 1) ? 0 : synth->getRenderedFrames() + random.range(0, 4 * block)); break;
+            case 3: synth->triggerVoice(id, random.uniform(0.3f, 1.0f)); break;
+            case 4: synth->setVoiceDistance(id, random.uniform(1.0f, 200.0f)); break;
+            default: synth->rampVoiceThrottle(id, random.uniform(0.0f, 1.0f), 0.05f); break;
+        }
+    }
+
+    // Datés après tous les noteOn datés encore en attente (au plus 4 blocs devant l'horloge)
+    uint64_t releaseFrame = synth->getRenderedFrames() + 5 * block;
+    for (int id : live)
+        synth->releaseVoice(id, releaseFrame);
+    while (!synth->flushEvents())
+        std::this_thread::yield();
+
+    // Les notes les plus longues retombent en ~2 s de rendu
+    while (synth->getRenderedFrames() < releaseFrame + 48000 * 3)
+        std::this_thread::yield();
+    stop.store(true, std::memory_order_release);
+    audio.join();
+
+    RMDL_CHECK(synth->getRenderedVoiceCount() == 0);
+    RMDL_CHECK(badSamples.load() == 0);
+    printf("%u réglages perdus, ring pleine par moments\n", synth->getDroppedEvents());
+}
+
+// Réponse impulsionnelle de processBlock contre process, pour des tailles de bloc qui tombent pile
+// sur kBlockSize, à côté ou au-dessus, et des retards plus courts que la portée vectorisée
+RMDL_TEST(effectsBlockMatchesPerSampleImpulse)
+{
+    const float sampleRate = 48000.0f;
+    const int length = 2 * 48000;
+    float reverbError = 0.0f;
+    float delayError = 0.0f;
+    float reverbTail = 0.0f;
+    float delayTail = 0.0f;
+
+    // Mêmes états au départ ; un bloc de silence amène le mix lissé du bloc sur sa cible
+    auto respond = [&](auto& perSample, auto& blocks, int blockFrames, float& error, float& tail) {
+        std::vector<float> settle(ReverbEffect::kBlockSize, 0.0f);
+        for (float& sample : settle)
+            perSample.process(sample);
+        blocks.processBlock(settle.data(), (int)settle.size());
+
+        std::vector<float> expected(length, 0.0f), output(length, 0.0f);
+        expected[0] = output[0] = 1.0f;
+        expected[length / 3] = output[length / 3] = -0.5f;
+        for (float& sample : expected)
+            sample = perSample.process(sample);
+        for (int start = 0; start < length; start += blockFrames)
+            blocks.processBlock(output.data() + start, std::min(blockFrames, length - start));
+        for (int i = 0; i < length; i++)
+        {
+            error = std::max(error, std::fabs(output[i] - expected[i]));
+            if (i > 0 && i < length / 3)
+                tail = std::max(tail, std::fabs(expected[i]));     // partie wet seule
+        }
+    };
+
+    for (int blockFrames : { 1, 37, ReverbEffect::kBlockSize, ReverbEffect::kBlockSize + 1, 1000 })
+    {
+        ReverbEffect reverb[2];
+        for (ReverbEffect& r : reverb)
+        {
+            r.init(sampleRate, 0.85f);
+            r.setMix(0.6f);
+        }
+        respond(reverb[0], reverb[1], blockFrames, reverbError, reverbTail);
+
+        for (float seconds : { 0.3f, 0.0015f, 1.0f / sampleRate })
+        {
+            DelayEffect delay[2];
+            for (DelayEffect& d : delay)
+            {
+                d.init(sampleRate, 1.0f);
+                d.setTime(seconds);
+                d.setFeedback(0.6f);
+                d.setMix(0.5f);
+            }
+            respond(delay[0], delay[1], blockFrames, delayError, delayTail);
+        }
+    }
+    RMDL_CHECK(reverbTail > 1e-3f);
+    RMDL_CHECK(delayTail > 1e-3f);
+    RMDL_CHECK(reverbError <= 1e-6f);
+    RMDL_CHECK(delayError <= 1e-6f);
+}
+
+// Débit hors ligne de la reverb et du delay sur 20 s de bruit : processBlock par blocs de
+// kBlockSize et de 512 frames contre process sample par sample, en M samples/s
+RMDL_BENCH(effectsBlockThroughput)
+{
+    const float sampleRate = 48000.0f;
+    const int length = 20 * 48000;
+    rmdltest::Random random;
+    std::vector<float> input(length);
+    for (float& sample : input)
+        sample = random.uniform(-0.5f, 0.5f);
+    std::vector<float> work(length);
+
+    // Même mesure pour les deux effets : -1 = process, sinon processBlock par blocs de blockFrames
+    auto throughput = [&](auto makeEffect, int blockFrames) {
+        auto effect = makeEffect();
+        std::copy(input.begin(), input.end(), work.begin());
+        rmdltest::Stopwatch stopwatch;
+        if (blockFrames < 0)
+            for (float& sample : work)
+                sample = effect.process(sample);
+        else
+            for (int start = 0; start < length; start += blockFrames)
+                effect.processBlock(work.data() + start, std::min(blockFrames, length - start));
+        double ms = stopwatch.elapsedMs();
+        return std::make_pair(length / (ms * 1e3), (double)work[length - 1]);
+    };
+    auto makeReverb = [&] {
+        ReverbEffect reverb;
+        reverb.init(sampleRate, 0.85f);
+        reverb.setMix(0.6f);
+        return reverb;
+    };
+    auto makeDelay = [&] {
+        DelayEffect delay;
+        delay.init(sampleRate, 1.0f);
+        delay.setTime(0.3f);
+        delay.setFeedback(0.6f);
+        delay.setMix(0.5f);
+        return delay;
+    };
+
+    auto report = [&](const char* name, auto makeEffect) {
+        auto [sampleRateM, sampleSum] = throughput(makeEffect, -1);
+        auto [blockRateM, blockSum] = throughput(makeEffect, ReverbEffect::kBlockSize);
+        auto [bufferRateM, bufferSum] = throughput(makeEffect, 512);
+        printf("%-6s : par sample %.1f M/s, blocs de %d %.1f M/s (x%.1f), blocs de 512 %.1f M/s (x%.1f), %.0fx temps réel (%.3f %.3f %.3f)\n",
+               name, sampleRateM, ReverbEffect::kBlockSize, blockRateM, blockRateM / sampleRateM, bufferRateM, bufferRateM / sampleRateM,
+               bufferRateM * 1e6 / sampleRate, sampleSum, blockSum, bufferSum);
+    };
+    report("reverb", makeReverb);
+    report("delay", makeDelay);
+}
+
+// Facteur temps réel du rendu par blocs avec 32 sources jouées en même temps, contre le chemin par sample
+RMDL_BENCH(thirtyTwoVoicesRealtimeFactor)
+{
+    const float sampleRate = 48000.0f;
+    const uint64_t totalFrames = 10 * 48000;
+    const int bufferFrames = 512;
+    auto synth = std::make_unique<SpaceshipSynthesizer>();
+    auto reference = std::make_unique<SpaceshipSynthesizer>();
+    for (SpaceshipSynthesizer* s : { synth.get(), reference.get() })
+    {
+        rmdltest::Random random;
+        s->init(sampleRate);
+        scriptVoices(*s, random, 32, totalFrames * 2);
+    }
+
+    std::vector<float> buffer(bufferFrames * 2);
+    double checksum = 0.0;
+    rmdltest::Stopwatch stopwatch;
+    for (uint64_t frame = 0; frame < totalFrames; frame += bufferFrames)
+    {
+        synth->renderBuffer(buffer.data(), bufferFrames, 2);
+        checksum += buffer[0];
+    }
+    double blockMs = stopwatch.elapsedMs();
+
+    stopwatch.restart();
+    for (uint64_t frame = 0; frame < totalFrames; frame++)
+        checksum += reference->processSample();
+    double sampleMs = stopwatch.elapsedMs();
+
+    double audioMs = totalFrames * 1000.0 / sampleRate;
+    printf("32 voix (%d rendues), %.0f s @ %.0f Hz : par blocs x%.1f temps réel (%.1f ms), par sample x%.1f (%.1f ms) (%.3f)\n",
+           synth->getRenderedVoiceCount(), audioMs / 1000.0, sampleRate, audioMs / blockMs, blockMs, audioMs / sampleMs, sampleMs, checksum);
+}
+
+// Voix tenables par cœur, preset par preset : SpaceVoice::processBlock seul, par blocs de kBlockSize
+RMDL_BENCH(voicesPerCore)
+{
+    const float sampleRate = 48000.0f;
+    const int voiceCount = 64;
+    const int blocks = 2 * 48000 / SpaceshipSynthesizer::kBlockSize;
+    const char* names[] = { "Engine", "Thruster", "Generator", "Shield", "Weapon", "Cockpit" };
+    float block[SpaceshipSynthesizer::kBlockSize];
+
+    for (int preset = 0; preset < 6; preset++)
+    {
+        std::vector<SpaceVoice> voices(voiceCount);
+        for (int v = 0; v < voiceCount; v++)
+        {
+            voices[v].setProfile(presetFor(preset));
+            voices[v].seedNoise(v);
+            voices[v].setThrottle(v / (float)voiceCount);
+            voices[v].noteOn(1.0f);
+        }
+
+        double checksum = 0.0;
+        rmdltest::Stopwatch stopwatch;
+        for (int b = 0; b < blocks; b++)
+        {
+            std::fill(block, block + SpaceshipSynthesizer::kBlockSize, 0.0f);
+            for (SpaceVoice& voice : voices)
+                voice.processBlock(block, SpaceshipSynthesizer::kBlockSize, sampleRate);
+            checksum += block[0];
+        }
+        double cpuSeconds = stopwatch.elapsedMs() / 1000.0;
+        double audioSeconds = (double)blocks * SpaceshipSynthesizer::kBlockSize / sampleRate;
+        printf("%-9s : %.0f voix par cœur @ %.0f Hz (%.3f)\n", names[preset], voiceCount * audioSeconds / cpuSeconds, sampleRate, checksum);
+    }
+}
+
+// Vaisseau de 2000 blocs qui demandent tous un son, à 2-300 m (la moitié au-delà de kMaxDistance),
+// dont 200 changent de distance et de throttle à chaque buffer comme en vol : CPU par buffer de 512
+// frames contre son budget temps réel, et voix rendues après vol et culling par distance
+RMDL_BENCH(twoThousandBlocksVoicePool)
+{
+    const float sampleRate = 48000.0f;
+    const int blockCount = 2000;
+    const int bufferFrames = 512;
+    const int buffers = 20 * 48000 / bufferFrames;
+    const int movedPerBuffer = 200;
+    rmdltest::Random random;
+    auto synth = std::make_unique<SpaceshipSynthesizer>();
+    synth->init(sampleRate);
+    std::vector<float> buffer(bufferFrames * 2);
+
+    // Quatre commandes par bloc : mise en place par paquets, un buffer vide la ring entre deux
+    std::vector<int> ids;
+    std::vector<float> distances;
+    for (int first = 0; first < blockCount; first += 500)
+    {
+        for (int b = first; b < std::min(blockCount, first + 500); b++)
+        {
+            ids.push_back(synth->addVoice(presetFor(b)));
+            distances.push_back(random.uniform(2.0f, 300.0f));
+            synth->setVoiceDistance(ids.back(), distances.back());
+            synth->setVoiceThrottle(ids.back(), random.uniform(0.0f, 1.0f));
+            synth->triggerVoice(ids.back(), random.uniform(0.5f, 1.0f));
+        }
+        synth->renderBuffer(buffer.data(), bufferFrames, 2);
+    }
+
+    std::vector<double> bufferMs;
+    bufferMs.reserve(buffers);
+    long renderedTotal = 0;
+    int renderedMax = 0;
+    long inRangeTotal = 0;
+    double checksum = 0.0;
+    rmdltest::Stopwatch stopwatch;
+    for (int b = 0; b < buffers; b++)
+    {
+        for (int m = 0; m < movedPerBuffer; m++)
+        {
+            int index = (b * movedPerBuffer + m) % blockCount;
+            distances[index] = std::clamp(distances[index] + random.uniform(-20.0f, 20.0f), 2.0f, 300.0f);
+            synth->setVoiceDistance(ids[index], distances[index]);
+            synth->setVoiceThrottle(ids[index], random.uniform(0.0f, 1.0f));
+        }
+
+        stopwatch.restart();
+        synth->renderBuffer(buffer.data(), bufferFrames, 2);
+        bufferMs.push_back(stopwatch.elapsedMs());
+        checksum += buffer[0];
+
+        renderedTotal += synth->getRenderedVoiceCount();
+        renderedMax = std::max(renderedMax, synth->getRenderedVoiceCount());
+        inRangeTotal += std::count_if(distances.begin(), distances.end(), [](float d) { return d < SpaceshipSynthesizer::kMaxDistance; });
+    }
+
+    double budgetMs = bufferFrames * 1000.0 / sampleRate;
+    double meanMs = 0.0;
+    for (double ms : bufferMs)
+        meanMs += ms / buffers;
+    std::sort(bufferMs.begin(), bufferMs.end());
+    printf("%d blocs, buffers de %d frames (budget %.2f ms) : %.3f ms/buffer en moyenne (%.1f %% du budget), p99 %.3f, pire %.3f\n",
+           blockCount, bufferFrames, budgetMs, meanMs, 100.0 * meanMs / budgetMs, bufferMs[buffers * 99 / 100], bufferMs.back());
+    printf("  voix rendues %.1f en moyenne (max %d, pool de %d), %.0f blocs à portée, %u commandes perdues (%.3f)\n",
+           (double)renderedTotal / buffers, renderedMax, SpaceshipSynthesizer::kPoolSize, (double)inRangeTotal / buffers,
+           synth->getDroppedEvents(), checksum);
+}
@@ -0,0 +1,164 @@
+//
+//  TestCulling.cpp
+//  Spammy
+//
+//  Created by Rémy on 17/10/2026.
+//
+
+#include "RMDLTest.hpp"
+#include "RMDLFrustumCulling.hpp"
+#include "RMDLCamera.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace
+{
+
+// Caméra du jeu, fov vertical 60°, 16/9, near 0.1 : regard vers -Z depuis eye, après un lacet yaw
+RMDLCamera makeCamera(simd::float3 eye, float yaw, float far)
+{
+    RMDLCamera camera;
+    camera.initPerspectiveWithPosition(eye, simd::make_float3(-sinf(yaw), 0.0f, -cosf(yaw)), simd::make_float3(0.0f, 1.0f, 0.0f),
+                                       60.0f * (float)M_PI / 180.0f, 16.0f / 9.0f, 0.1f, far);
+    return camera;
+}
+
+struct Box
+{
+    simd::float3    boxMin, boxMax;
+};
+
+Box boxAround(simd::float3 center, float halfExtent)
+{
+    return { center - halfExtent, center + halfExtent };
+}
+
+// Un point clairement dans le volume de clip Metal (x, y dans [-w, w], z dans [0, w]) rend sa boîte visible
+bool clipContains(const simd::float4x4& viewProjection, simd::float3 point)
+{
+    simd::float4 clip = viewProjection * simd::make_float4(point.x, point.y, point.z, 1.0f);
+    float margin = clip.w * 0.999f;
+    return clip.w > 0.0f && std::fabs(clip.x) < margin && std::fabs(clip.y) < margin && clip.z > clip.w * 0.001f && clip.z < margin;
+}
+
+std::vector<uint32_t> cullAll(const Frustum& frustum, const std::vector<Box>& boxes)
+{
+    culling::BoxCuller culler;
+    for (const Box& box : boxes)
+        culler.addBox(box.boxMin, box.boxMax);
+    std::vector<uint32_t> visible;
+    culler.cull(frustum, visible);
+    return visible;
+}
+
+}
+
+// Caméra connue : en (0, 10, 0), fov vertical 60°, 16/9, near 0.1, far 100. À 20 m devant,
+// le frustum couvre x dans [-20.5, 20.5] et y dans [-1.5, 21.5]
+RMDL_TEST(knownCameraCullsExpectedBoxes)
+{
+    const simd::float3 eye = simd::make_float3(0.0f, 10.0f, 0.0f);
+    struct Expected { Box box; bool visible; };
+    const std::vector<Expected> cases = {
+        { boxAround(simd::make_float3(0.0f, 10.0f, -20.0f), 0.5f), true },     // droit devant
+        { boxAround(simd::make_float3(0.0f, 10.0f, 20.0f), 0.5f), false },     // derrière
+        { boxAround(simd::make_float3(0.0f, 10.0f, -150.0f), 0.5f), false },   // au-delà du far
+        { boxAround(simd::make_float3(60.0f, 10.0f, -20.0f), 0.5f), false },   // à droite
+        { boxAround(simd::make_float3(-60.0f, 10.0f, -20.0f), 0.5f), false },  // à gauche
+        { boxAround(simd::make_float3(0.0f, 40.0f, -20.0f), 0.5f), false },    // au-dessus
+        { boxAround(simd::make_float3(0.0f, -20.0f, -20.0f), 0.5f), false },   // en dessous
+        { boxAround(eye, 1.0f), true },                                         // contient la caméra
+        { boxAround(simd::make_float3(0.0f, 10.0f, -0.07f), 0.02f), false },   // entre la caméra et le near
+        { { simd::make_float3(-1.0f, 9.0f, -101.0f), simd::make_float3(1.0f, 11.0f, -99.0f) }, true },  // coupe le far
+        { { simd::make_float3(19.0f, 9.0f, -21.0f), simd::make_float3(25.0f, 11.0f, -19.0f) }, true },  // coupe le bord droit
+        { { simd::make_float3(-400.0f, 0.0f, -40.0f), simd::make_float3(400.0f, 1.0f, -30.0f) }, true }, // traverse tout le champ
+    };
+
+    Frustum frustum = makeCamera(eye, 0.0f, 100.0f).frustum();
+    std::vector<Box> boxes;
+    std::vector<uint32_t> expected;
+    int scalarErrors = 0;
+    for (const Expected& entry : cases)
+    {
+        scalarErrors += culling::isBoxVisible(frustum, entry.box.boxMin, entry.box.boxMax) != entry.visible;
+        if (entry.visible)
+            expected.push_back((uint32_t)boxes.size());
+        boxes.push_back(entry.box);
+    }
+    RMDL_CHECK(scalarErrors == 0);
+    // 12 boîtes : trois paquets de 4, la queue scalaire est couverte par le test suivant
+    RMDL_CHECK(cullAll(frustum, boxes) == expected);
+
+    // Même scène vue de dos après un demi-tour : la boîte derrière devient la seule visible devant
+    frustum = makeCamera(eye, (float)M_PI, 100.0f).frustum();
+    RMDL_CHECK(culling::isBoxVisible(frustum, cases[1].box.boxMin, cases[1].box.boxMax));
+    RMDL_CHECK(!culling::isBoxVisible(frustum, cases[0].box.boxMin, cases[0].box.boxMax));
+}
+
+// Le chemin SIMD de BoxCuller::cull rend les mêmes indices que isBoxVisible boîte par boîte,
+// et aucune boîte dont le centre est dans le frustum n'est rejetée
+RMDL_TEST(boxCullerMatchesScalarAndIsConservative)
+{
+    rmdltest::Random random;
+    int mismatches = 0;
+    int falseNegatives = 0;
+    size_t totalVisible = 0;
+    for (int camera = 0; camera < 20; camera++)
+    {
+        simd::float3 eye = simd::make_float3(random.uniform(-50.0f, 50.0f), random.uniform(0.0f, 40.0f), random.uniform(-50.0f, 50.0f));
+        RMDLCamera view = makeCamera(eye, random.uniform(-3.14f, 3.14f), 200.0f);
+        simd::float4x4 viewProjection = view.uniforms().viewProjectionMatrix;
+        Frustum frustum = view.frustum();
+
+        std::vector<Box> boxes;
+        std::vector<uint32_t> expected;
+        size_t count = 1000 + (size_t)random.range(0, 3);  // queue scalaire de 0 à 3 boîtes
+        for (size_t i = 0; i < count; i++)
+        {
+            simd::float3 center = simd::make_float3(random.uniform(-250.0f, 250.0f), random.uniform(-20.0f, 60.0f), random.uniform(-250.0f, 250.0f));
+            simd::float3 halfExtents = simd::make_float3(random.uniform(0.1f, 8.0f), random.uniform(0.1f, 8.0f), random.uniform(0.1f, 8.0f));
+            Box box = { center - halfExtents, center + halfExtents };
+            bool visible = culling::isBoxVisible(frustum, box.boxMin, box.boxMax);
+            if (visible)
+                expected.push_back((uint32_t)i);
+            falseNegatives += !visible && clipContains(viewProjection, center);
+            boxes.push_back(box);
+        }
+        mismatches += cullAll(frustum, boxes) != expected;
+        totalVisible += expected.size();
+    }
+    RMDL_CHECK(mismatches == 0);
+    RMDL_CHECK(falseNegatives == 0);
+    RMDL_CHECK(totalVisible > 0);
+}
+
+// 10 000 AABB de chunks sur une grille, caméra qui tourne sur elle-même : coût par frame de
+// RMDLCamera::frustum (uniforms recalculés) + cull, en SoA, et nombre moyen de boîtes gardées
+RMDL_BENCH(cullTenThousandBoxes)
+{
+    culling::BoxCuller culler;
+    culler.reserve(10000);
+    for (int x = 0; x < 100; x++)
+        for (int z = 0; z < 100; z++)
+            culler.addBox(simd::make_float3((x - 50) * 16.0f, 0.0f, (z - 50) * 16.0f),
+                          simd::make_float3((x - 49) * 16.0f, 64.0f + (x * 7 + z * 13) % 64, (z - 49) * 16.0f));
+
+    const int frames = 2000;
+    std::vector<uint32_t> visible;
+    visible.reserve(10000);
+    size_t kept = 0;
+    RMDLCamera camera = makeCamera(simd::make_float3(0.0f, 80.0f, 0.0f), 0.0f, 500.0f);
+    rmdltest::Stopwatch stopwatch;
+    for (int frame = 0; frame < frames; frame++)
+    {
+        camera.setDirection(simd::make_float3(-sinf(frame * 0.01f), 0.0f, -cosf(frame * 0.01f)));
+        visible.clear();
+        culler.cull(camera.frustum(), visible);
+        kept += visible.size();
+    }
+    double ms = stopwatch.elapsedMs();
+    printf("cull 10k AABB : %.3f ms/frame, %.2f ns/boîte, %zu gardées en moyenne\n",
+           ms / frames, ms * 1e6 / (frames * 10000.0), kept / frames);
+}
@@ -0,0 +1,213 @@
+//
+//  TestInstanceStore.cpp
+//  Spammy
+//
+//  Created by Rémy on 17/10/2026.
+//
+
+#include "RMDLTest.hpp"
+#include "RMDLInstanceStore.hpp"
+
+#include <cstring>
+#include <unordered_map>
+#include <vector>
+
+namespace
+{
+
+// Même taille que BlockGPUInstance (matrice, couleur, paramètres) sans simd
+struct alignas(16) Instance
+{
+    float values[24];
+};
+
+constexpr uint32_t kCapacity = 8192;
+constexpr uint32_t kBufferCount = 3;
+using Store = InstanceStore<uint32_t, Instance, kCapacity, kBufferCount>;
+
+Instance makeInstance(uint32_t seed)
+{
+    Instance instance;
+    for (int i = 0; i < 24; i++)
+        instance.values[i] = (float)(seed * 31 + i);
+    return instance;
+}
+
+// Les buffers GPU remplacés par de la mémoire ordinaire, remplie d'un motif que l'upload doit écraser
+struct MockBuffers
+{
+    std::vector<Instance> buffers[kBufferCount];
+
+    MockBuffers()
+    {
+        for (std::vector<Instance>& buffer : buffers)
+        {
+            buffer.resize(kCapacity);
+            memset(buffer.data(), 0xAB, buffer.size() * sizeof(Instance));
+        }
+    }
+};
+
+// Chaque instance vivante est dans la plage de sa clé, les plages sont disjointes, sous le slot réservé,
+// et le buffer fraîchement uploadé a le contenu attendu à son slot
+int checkStore(const Store& store, const std::unordered_map<uint32_t, std::pair<uint32_t, Instance>>& model, const Instance* uploaded)
+{
+    int errors = store.count() != model.size();
+    std::vector<uint8_t> owner(kCapacity, 0);
+    for (const auto& [key, range] : store.ranges())
+    {
+        errors += range.count > range.capacity || range.offset + range.capacity > Store::kReservedSlot;
+        for (uint32_t slot = range.offset; slot < range.offset + range.capacity; slot++)
+            errors += owner[slot]++ != 0;
+    }
+    for (const auto& [id, entry] : model)
+    {
+        int32_t slot = store.slotOf(id);
+        auto rangeIt = store.ranges().find(entry.first);
+        if (slot < 0 || rangeIt == store.ranges().end() || (uint32_t)slot - rangeIt->second.offset >= rangeIt->second.count)
+        {
+            errors++;
+            continue;
+        }
+        errors += memcmp(&uploaded[slot], &entry.second, sizeof(Instance)) != 0;
+    }
+    return errors;
+}
+
+}
+
+// Ajouts, mises à jour, changements de clé et retraits aléatoires, un upload par frame sur trois
+// buffers en rotation : chaque buffer rattrape les slots manqués, relayouts compris
+RMDL_TEST(instanceStoreUploadsMatchModel)
+{
+    rmdltest::Random random;
+    Store store;
+    MockBuffers mock;
+    std::unordered_map<uint32_t, std::pair<uint32_t, Instance>> model;
+    std::vector<uint32_t> ids;
+    uint32_t nextId = 1;
+    int setErrors = 0;
+    int contentErrors = 0;
+    int reservedErrors = 0;
+
+    for (uint32_t frame = 0; frame < 600; frame++)
+    {
+        int edits = random.range(0, 40);
+        for (int e = 0; e < edits; e++)
+        {
+            int action = random.range(0, 9);
+            if (ids.empty() || action < 5)
+            {
+                uint32_t key = (uint32_t)random.range(0, 7);
+                Instance instance = makeInstance(nextId);
+                setErrors += !store.set(nextId, key, instance);
+                model[nextId] = { key, instance };
+                ids.push_back(nextId++);
+            }
+            else
+            {
+                size_t index = (size_t)random.range(0, (int)ids.size() - 1);
+                uint32_t id = ids[index];
+                if (action < 8)
+                {
+                    // Mise à jour sur place, ou changement de clé une fois sur trois
+                    uint32_t key = action == 7 ? (uint32_t)random.range(0, 7) : model[id].first;
+                    Instance instance = makeInstance(id + frame * 7919);
+                    setErrors += !store.set(id, key, instance);
+                    model[id] = { key, instance };
+                }
+                else
+                {
+                    setErrors += !store.remove(id);
+                    model.erase(id);
+                    ids[index] = ids.back();
+                    ids.pop_back();
+                }
+            }
+        }
+
+        uint32_t bufferIndex = frame % kBufferCount;
+        store.upload(bufferIndex, mock.buffers[bufferIndex].data());
+        contentErrors += checkStore(store, model, mock.buffers[bufferIndex].data());
+        reservedErrors += *(const uint8_t*)&mock.buffers[bufferIndex][Store::kReservedSlot] != 0xAB;
+    }
+    setErrors += store.remove(0) || store.remove(nextId);
+    RMDL_CHECK(setErrors == 0);
+    RMDL_CHECK(contentErrors == 0);
+    RMDL_CHECK(reservedErrors == 0);
+}
+
+// Buffer plein : un ajout échoue sans rien toucher, un changement de clé passe (l'ancien slot
+// est rendu avant), un retrait rend la place
+RMDL_TEST(instanceStoreRefusesWhenFull)
+{
+    Store store;
+    MockBuffers mock;
+    uint32_t id = 1;
+    while (store.set(id, id % 3, makeInstance(id)))
+        id++;
+    RMDL_CHECK(store.count() == Store::kReservedSlot);
+    RMDL_CHECK(id == Store::kReservedSlot + 1);
+
+    RMDL_CHECK(!store.set(id, 0, makeInstance(id)) && store.slotOf(id) < 0);
+    Instance moved = makeInstance(id + 1);
+    RMDL_CHECK(store.set(1, 2, moved));
+    int32_t slot = store.slotOf(1);
+    const Store::Range& range = store.ranges().at(2);
+    RMDL_CHECK(slot >= 0 && (uint32_t)slot - range.offset < range.count);
+    store.upload(0, mock.buffers[0].data());
+    RMDL_CHECK(memcmp(&mock.buffers[0][slot], &moved, sizeof(Instance)) == 0);
+
+    RMDL_CHECK(store.remove(2));
+    RMDL_CHECK(store.set(id, 1, makeInstance(id)));
+    RMDL_CHECK(!store.set(id + 1, 0, makeInstance(id + 1)));
+    RMDL_CHECK(store.count() == Store::kReservedSlot);
+}
+
+// Coût d'un frame selon la part d'instances modifiées, buffer plein (8191 instances, 16 types) :
+// mises à jour plus upload des slots sales, contre la recopie complète de l'image à chaque frame
+RMDL_BENCH(instanceStoreDirtiness)
+{
+    rmdltest::Random random;
+    Store store;
+    MockBuffers mock;
+    std::vector<Instance> image(kCapacity);
+    const uint32_t count = Store::kReservedSlot;
+    for (uint32_t id = 1; id <= count; id++)
+        store.set(id, id % 16, makeInstance(id));
+    for (uint32_t b = 0; b < kBufferCount; b++)
+        store.upload(b, mock.buffers[b].data());
+
+    const int frames = 600;
+    for (double dirtiness : { 0.0, 0.01, 1.0 })
+    {
+        uint32_t edits = (uint32_t)(dirtiness * count);
+        double setMs = 0.0;
+        double uploadMs = 0.0;
+        rmdltest::Stopwatch stopwatch;
+        for (int frame = 0; frame < frames; frame++)
+        {
+            stopwatch.restart();
+            for (uint32_t e = 0; e < edits; e++)
+            {
+                uint32_t id = edits == count ? e + 1 : (uint32_t)random.range(1, (int)count);
+                store.set(id, id % 16, makeInstance(id + frame));
+            }
+            setMs += stopwatch.elapsedMs();
+            stopwatch.restart();
+            store.upload(frame % kBufferCount, mock.buffers[frame % kBufferCount].data());
+            uploadMs += stopwatch.elapsedMs();
+        }
+        printf("store %u instances, %5.1f %% modifiées : set %.4f ms/frame, upload %.4f ms/frame\n",
+               count, dirtiness * 100.0, setMs / frames, uploadMs / frames);
+    }
+
+    rmdltest::Stopwatch stopwatch;
+    for (int frame = 0; frame < frames; frame++)
+    {
+        image[frame % count].values[0] = (float)frame;
+        memcpy(mock.buffers[frame % kBufferCount].data(), image.data(), count * sizeof(Instance));
+    }
+    printf("recopie complète %u instances : %.4f ms/frame (%.1f)\n", count, stopwatch.elapsedMs() / frames,
+           mock.buffers[0][1].values[0]);
+}
@@ -0,0 +1,392 @@
+//
+//  TestModelCache.cpp
+//  Spammy
+//
+//  Created by Rémy on 17/10/2026.
+//
+
+// RMDLBlender.hpp tire MetalKit et stb_image : leurs implémentations vivent ici, comme dans l'outil de bake
+#define MTK_PRIVATE_IMPLEMENTATION
+#define STB_IMAGE_IMPLEMENTATION
+
+#include "RMDLTest.hpp"
+#include "RMDLModelCache.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+namespace fs = std::filesystem;
+
+// Dossier vide et propre à chaque test sous le dossier temporaire du système
+std::string scratchDirectory(const char* name)
+{
+    fs::path directory = fs::temp_directory_path() / (std::string("rmdl-modelcache-") + name);
+    fs::remove_all(directory);
+    fs::create_directories(directory);
+    return directory.string() + "/";
+}
+
+void writeRandomFile(rmdltest::Random& random, const std::string& path, size_t size)
+{
+    std::vector<uint8_t> bytes(size);
+    for (uint8_t& byte : bytes)
+        byte = (uint8_t)random.next();
+    FILE* file = fopen(path.c_str(), "wb");
+    fwrite(bytes.data(), 1, bytes.size(), file);
+    fclose(file);
+}
+
+// Décale la date de modification sans toucher au contenu (touch, checkout)
+void touch(const std::string& path)
+{
+    fs::last_write_time(path, fs::last_write_time(path) + std::chrono::seconds(5));
+}
+
+modelcache::Dependency stamp(const std::string& directory, const std::string& relative)
+{
+    modelcache::Dependency dependency = modelcache::stampFile(directory + relative);
+    dependency.path = relative;
+    return dependency;
+}
+
+// Modèle skinné plausible sans passer par assimp : arbre aléatoire où chaque noeud est un bone,
+// clips qui animent tous les noeuds, vertex stream et indices séquentiels
+void syntheticModel(rmdltest::Random& random, uint32_t vertexCount, uint32_t nodeCount, uint32_t clipCount, uint32_t keyCount, Blender& model)
+{
+    Skeleton& skeleton = model.skeleton;
+    for (uint32_t n = 0; n < nodeCount; n++)
+    {
+        skeleton.names.push_back("node_" + std::to_string(n));
+        skeleton.parents.push_back(n ? random.range(0, (int)n - 1) : -1);
+        skeleton.localBind.push_back(matrix_identity_float4x4);
+        skeleton.nodeBones.push_back((int32_t)n);
+        model.boneMap[skeleton.names[n]] = { (int)n, matrix_identity_float4x4 };
+        model.boneOffsets.push_back(matrix_identity_float4x4);
+    }
+    model.boneCount = (int)nodeCount;
+
+    for (uint32_t c = 0; c < clipCount; c++)
+    {
+        Animation anim;
+        anim.name = "clip_" + std::to_string(c);
+        anim.duration = 4.0f;
+        anim.ticksPerSec = 1.0f;
+        for (uint32_t n = 0; n < nodeCount; n++)
+        {
+            BoneAnimation channel;
+            channel.boneName = skeleton.names[n];
+            for (uint32_t k = 0; k < keyCount; k++)
+            {
+                float time = anim.duration * k / (keyCount - 1);
+                channel.positions.push_back({ time, simd::float3{ random.uniform(-1.0f, 1.0f), 0.0f, 0.0f } });
+                channel.rotations.push_back({ time, simd_quaternion(random.uniform(-3.0f, 3.0f), simd::float3{ 0.0f, 1.0f, 0.0f }) });
+                channel.scales.push_back({ time, simd::float3{ 1.0f, 1.0f, 1.0f } });
+            }
+            anim.channels.push_back(std::move(channel));
+            anim.nodeChannels.push_back((int32_t)n);
+        }
+        model.animations.push_back(std::move(anim));
+    }
+
+    model.verticesFull.resize(vertexCount);
+    for (uint32_t v = 0; v < vertexCount; v++)
+    {
+        VertexBlenderFull& vertex = model.verticesFull[v];
+        vertex.position = simd::float3{ random.uniform(-1.0f, 1.0f), random.uniform(0.0f, 2.0f), random.uniform(-1.0f, 1.0f) };
+        vertex.joints = simd::int4{ random.range(0, (int)nodeCount - 1), 0, 0, 0 };
+        vertex.weights = simd::float4{ 1.0f, 0.0f, 0.0f, 0.0f };
+        model.indices.push_back(v);
+    }
+    model.hasAnimation = true;
+}
+
+}
+
+// Taille et date identiques : accepté sans relire le contenu, même si on l'a changé en douce.
+// Date seule modifiée : rehash, accepté si le contenu est le même. Tout autre changement rejette.
+RMDL_TEST(dependencyStampRehashesOnlyWhenTheDateMoves)
+{
+    rmdltest::Random random;
+    std::string directory = scratchDirectory("stamp");
+    std::string path = directory + "model.glb";
+    writeRandomFile(random, path, 4096);
+
+    modelcache::Dependency dependency = modelcache::stampFile(path);
+    RMDL_CHECK(dependency.size == 4096 && dependency.hash == modelcache::hashFile(path));
+    RMDL_CHECK(modelcache::isUnchanged(dependency));
+
+    touch(path);
+    RMDL_CHECK(modelcache::isUnchanged(dependency));
+
+    // Même taille, contenu différent, date remise à l'identique : le chemin rapide ne relit rien
+    fs::file_time_type stamped = fs::last_write_time(path);
+    modelcache::Dependency touched = modelcache::stampFile(path);
+    writeRandomFile(random, path, 4096);
+    fs::last_write_time(path, stamped);
+    RMDL_CHECK(modelcache::isUnchanged(touched));
+
+    touch(path);
+    RMDL_CHECK(!modelcache::isUnchanged(touched));
+
+    // Taille différente, date remise à l'identique : rejeté sans hash
+    modelcache::Dependency sized = modelcache::stampFile(path);
+    stamped = fs::last_write_time(path);
+    writeRandomFile(random, path, 4097);
+    fs::last_write_time(path, stamped);
+    RMDL_CHECK(!modelcache::isUnchanged(sized));
+
+    fs::remove(path);
+    RMDL_CHECK(!modelcache::isUnchanged(touched));
+
+    // Absent au bake : valide tant qu'il reste absent
+    modelcache::Dependency missing = modelcache::stampFile(path);
+    RMDL_CHECK(missing.hash == 0);
+    RMDL_CHECK(modelcache::isUnchanged(missing));
+    writeRandomFile(random, path, 16);
+    RMDL_CHECK(!modelcache::isUnchanged(missing));
+
+    fs::remove_all(directory);
+}
+
+// loadModel prend le cache tant que la source et ses textures externes n'ont pas bougé. La source
+// est un faux .glb : un cache rejeté retombe sur assimp, qui échoue et laisse un modèle vide.
+RMDL_TEST(cacheFollowsSourceAndExternalTextures)
+{
+    NS::SharedPtr<MTL::Device> device = NS::TransferPtr(MTL::CreateSystemDefaultDevice());
+    RMDL_CHECK(device.get() != nullptr);
+    if (!device.get())
+        return;
+
+    rmdltest::Random random;
+    std::string directory = scratchDirectory("textures");
+    fs::create_directories(directory + "textures");
+    std::string source = directory + "model.glb";
+    writeRandomFile(random, source, 1 << 16);
+    writeRandomFile(random, directory + "textures/albedo.png", 1 << 12);
+
+    Blender model;
+    syntheticModel(random, 300, 12, 2, 8, model);
+    auto bake = [&] {
+        std::vector<modelcache::Dependency> dependencies = { stamp(directory, "model.glb"),
+                                                             stamp(directory, "textures/albedo.png"),
+                                                             stamp(directory, "textures/normal.png") };
+        return modelcache::write(modelcache::cachePathFor(source), dependencies, model, {});
+    };
+    RMDL_CHECK(bake());
+
+    modelcache::Reader reader;
+    RMDL_CHECK(reader.open(modelcache::cachePathFor(source)));
+    std::vector<modelcache::Dependency> recorded = reader.dependencies();
+    RMDL_CHECK(recorded.size() == 3 && recorded[0].path == "model.glb" && recorded[1].path == "textures/albedo.png");
+    RMDL_CHECK(recorded.size() == 3 && recorded[2].hash == 0);
+
+    RMDLBlender blender(device.get());
+    auto loadsFromCache = [&] {
+        return blender.getModel(blender.loadModel(source))->verticesFull.size() == model.verticesFull.size();
+    };
+    RMDL_CHECK(loadsFromCache());
+
+    touch(directory + "textures/albedo.png");
+    RMDL_CHECK(loadsFromCache());
+
+    writeRandomFile(random, directory + "textures/albedo.png", 1 << 12);
+    touch(directory + "textures/albedo.png");
+    RMDL_CHECK(!loadsFromCache());
+
+    RMDL_CHECK(bake());
+    RMDL_CHECK(loadsFromCache());
+    writeRandomFile(random, directory + "textures/normal.png", 64);
+    RMDL_CHECK(!loadsFromCache());
+
+    RMDL_CHECK(bake());
+    writeRandomFile(random, source, (1 << 16) + 1);
+    RMDL_CHECK(!loadsFromCache());
+
+    fs::remove_all(directory);
+}
+
+// Clips compressés chargés sans copie : les pools pointent dans le fichier mappé que le modèle garde,
+// y compris après le déplacement des modèles dans m_models, et s'échantillonnent comme l'original
+RMDL_TEST(compressedClipsAreSampledInPlace)
+{
+    NS::SharedPtr<MTL::Device> device = NS::TransferPtr(MTL::CreateSystemDefaultDevice());
+    RMDL_CHECK(device.get() != nullptr);
+    if (!device.get())
+        return;
+
+    rmdltest::Random random;
+    std::string directory = scratchDirectory("inplace");
+    std::string source = directory + "model.glb";
+    writeRandomFile(random, source, 1 << 12);
+
+    Blender model;
+    syntheticModel(random, 64, 24, 3, 40, model);
+    for (Animation& anim : model.animations)
+        animcompression::compress(anim, animcompression::Settings{}, anim.compressed);
+    RMDL_CHECK(modelcache::write(modelcache::cachePathFor(source), { stamp(directory, "model.glb") }, model, {}));
+
+    RMDLBlender blender(device.get());
+    size_t first = blender.loadModel(source);
+    for (int i = 0; i < 8; i++)
+        blender.loadModel(source);
+    const Blender* loaded = blender.getModel(first);
+    RMDL_CHECK(loaded->cacheFile != nullptr && loaded->animations.size() == model.animations.size());
+    if (!loaded->cacheFile || loaded->animations.size() != model.animations.size())
+        return;
+
+    const uint8_t* mappedBegin = loaded->cacheFile->data();
+    const uint8_t* mappedEnd = mappedBegin + loaded->cacheFile->size();
+    auto inMapping = [&](const void* pointer) {
+        return (const uint8_t*)pointer >= mappedBegin && (const uint8_t*)pointer < mappedEnd;
+    };
+    int copies = 0;
+    int mismatches = 0;
+    for (size_t a = 0; a < model.animations.size(); a++)
+    {
+        const Animation& original = model.animations[a];
+        const Animation& mapped = loaded->animations[a];
+        copies += !inMapping(mapped.compressed.channels.data()) || !inMapping(mapped.compressed.times.data()) || !inMapping(mapped.compressed.values.data());
+        for (size_t c = 0; c < original.channels.size(); c++)
+        {
+            KeyCursor originalCursor, mappedCursor;
+            for (float time = 0.0f; time < original.duration; time += 0.07f)
+            {
+                simd::float3 t0, s0, t1, s1;
+                simd::quatf r0, r1;
+                RMDLBlender::sampleChannel(time, original, c, originalCursor, t0, r0, s0);
+                RMDLBlender::sampleChannel(time, mapped, c, mappedCursor, t1, r1, s1);
+                mismatches += simd::any(t0 != t1) || simd::any(r0.vector != r1.vector) || simd::any(s0 != s1);
+            }
+        }
+    }
+    RMDL_CHECK(copies == 0);
+    RMDL_CHECK(mismatches == 0);
+
+    fs::remove_all(directory);
+}
+
+// Cache aux bonnes tailles mais aux index croisés faux (canal hors du clip, bone inexistant,
+// parent qui ne précède pas son noeud) : rejeté, le modèle retombe sur l'import assimp
+RMDL_TEST(cacheWithBadCrossReferencesIsRejected)
+{
+    NS::SharedPtr<MTL::Device> device = NS::TransferPtr(MTL::CreateSystemDefaultDevice());
+    RMDL_CHECK(device.get() != nullptr);
+    if (!device.get())
+        return;
+
+    rmdltest::Random random;
+    std::string directory = scratchDirectory("crossrefs");
+    std::string source = directory + "model.glb";
+    writeRandomFile(random, source, 1 << 12);
+
+    Blender model;
+    syntheticModel(random, 64, 16, 2, 8, model);
+    RMDLBlender blender(device.get());
+    auto loadsFromCache = [&](const Blender& baked) {
+        RMDL_CHECK(modelcache::write(modelcache::cachePathFor(source), { stamp(directory, "model.glb") }, baked, {}));
+        return blender.getModel(blender.loadModel(source))->verticesFull.size() == baked.verticesFull.size();
+    };
+    RMDL_CHECK(loadsFromCache(model));
+
+    Blender corrupted = model;
+    corrupted.animations[1].nodeChannels[5] = (int32_t)corrupted.animations[1].channels.size();
+    RMDL_CHECK(!loadsFromCache(corrupted));
+
+    corrupted = model;
+    corrupted.skeleton.nodeBones[9] = corrupted.boneCount;
+    RMDL_CHECK(!loadsFromCache(corrupted));
+
+    corrupted = model;
+    corrupted.skeleton.parents[3] = 3;
+    RMDL_CHECK(!loadsFromCache(corrupted));
+
+    corrupted = model;
+    corrupted.skeleton.parents[0] = 15;
+    RMDL_CHECK(!loadsFromCache(corrupted));
+
+    // Négatif : pas de bone, pas de canal, racine
+    corrupted = model;
+    corrupted.animations[0].nodeChannels[2] = -1;
+    corrupted.skeleton.nodeBones[4] = -1;
+    corrupted.skeleton.parents[6] = -1;
+    RMDL_CHECK(loadsFromCache(corrupted));
+
+    fs::remove_all(directory);
+}
+
+// Chargement d'un modèle depuis le cache (100k vertices, 96 bones, 8 clips), et ce que coûte la
+// validation : stat de la source (32 Mo) et des textures contre un hash complet à chaque lancement.
+// RMDL_BENCH_MODEL=/chemin/vitesse.glb ajoute le même modèle chargé par assimp puis par le cache.
+RMDL_BENCH(loadModelFromCache)
+{
+    NS::SharedPtr<MTL::Device> device = NS::TransferPtr(MTL::CreateSystemDefaultDevice());
+    if (!device.get())
+        return;
+
+    rmdltest::Random random;
+    std::string directory = scratchDirectory("bench");
+    std::string source = directory + "model.glb";
+    writeRandomFile(random, source, 32 << 20);
+    std::vector<modelcache::Dependency> dependencies = { stamp(directory, "model.glb") };
+    for (const char* texture : { "albedo.png", "normal.png", "roughness.png", "metallic.png" })
+    {
+        writeRandomFile(random, directory + texture, 4 << 20);
+        dependencies.push_back(stamp(directory, texture));
+    }
+
+    Blender model;
+    syntheticModel(random, 100000, 96, 8, 120, model);
+    modelcache::write(modelcache::cachePathFor(source), dependencies, model, {});
+
+    for (modelcache::Dependency& dependency : dependencies)
+        dependency.path = directory + dependency.path;
+    const int checks = 1000;
+    rmdltest::Stopwatch stopwatch;
+    int unchanged = 0;
+    for (int i = 0; i < checks; i++)
+        for (const modelcache::Dependency& dependency : dependencies)
+            unchanged += modelcache::isUnchanged(dependency);
+    double statMs = stopwatch.elapsedMs() / checks;
+    const int hashes = 5;
+    stopwatch.restart();
+    for (int i = 0; i < hashes; i++)
+        for (const modelcache::Dependency& dependency : dependencies)
+            unchanged += modelcache::hashFile(dependency.path) == dependency.hash;
+    double hashMs = stopwatch.elapsedMs() / hashes;
+    printf("validation de 48 Mo de dépendances : %.4f ms en taille + date, %.2f ms en hash complet (%d valides)\n",
+           statMs, hashMs, unchanged);
+
+    const int loads = 20;
+    RMDLBlender blender(device.get());
+    stopwatch.restart();
+    for (int i = 0; i < loads; i++)
+        blender.loadModel(source);
+    printf("chargement depuis le cache : %.2f ms/modèle (%zu vertices, %zu clips)\n",
+           stopwatch.elapsedMs() / loads, model.verticesFull.size(), model.animations.size());
+    fs::remove_all(directory);
+
+    const char* benchModel = getenv("RMDL_BENCH_MODEL");
+    if (!benchModel)
+        return;
+    // Copie à part : le cache est écrit à côté de la source, on ne touche pas aux assets
+    std::string copyDirectory = scratchDirectory("asset");
+    std::string copy = copyDirectory + fs::path(benchModel).filename().string();
+    fs::copy_file(benchModel, copy);
+    stopwatch.restart();
+    blender.loadModel(copy);
+    double assimpMs = stopwatch.elapsedMs();
+    if (blender.bakeModelCache(copy))
+    {
+        stopwatch.restart();
+        blender.loadModel(copy);
+        printf("%s : %.2f ms par assimp, %.2f ms depuis le cache\n", benchModel, assimpMs, stopwatch.elapsedMs());
+    }
+    fs::remove_all(copyDirectory);
+}
@@ -0,0 +1,648 @@
+//
+//  TestPhysics.cpp
+//  Spammy
+//
+//  Created by Rémy on 17/10/2026.
+//
+
+#include "RMDLTest.hpp"
+#include "RMDLSystem.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <map>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace
+{
+
+using PairList = std::vector<std::pair<uint32_t, uint32_t>>;
+
+PairList sortedPairs(const PairList& pairs)
+{
+    PairList sorted;
+    sorted.reserve(pairs.size());
+    for (const auto& [a, b] : pairs)
+        sorted.emplace_back(std::min(a, b), std::max(a, b));
+    std::sort(sorted.begin(), sorted.end());
+    return sorted;
+}
+
+void randomizeBody(PhysicsBody& body, rmdltest::Random& random, float spread)
+{
+    body.position = simd::make_float3(random.uniform(-spread, spread), random.uniform(0.0f, 20.0f), random.uniform(-spread, spread));
+    body.linearVelocity = simd::make_float3(random.uniform(-3, 3), random.uniform(-3, 3), random.uniform(-3, 3));
+    body.isStatic = random.range(0, 6) == 0;
+    body.shape = random.range(0, 1) ? PhysicsShape::Box : PhysicsShape::Sphere;
+    body.radius = random.uniform(0.2f, 2.0f);
+    body.halfExtents = simd::make_float3(random.uniform(0.2f, 2.0f), random.uniform(0.2f, 2.0f), random.uniform(0.2f, 2.0f));
+}
+
+// Recopie dans reference l'état de sap qui compte pour la broad phase
+void mirrorBody(PhysicsSystem& sap, PhysicsSystem& reference, uint32_t id)
+{
+    PhysicsBody* source = sap.getBody(id);
+    PhysicsBody* target = reference.getBody(id);
+    if (!source || !target)
+        return;
+    target->position = source->position;
+    target->linearVelocity = source->linearVelocity;
+    target->isStatic = source->isStatic;
+    target->shape = source->shape;
+    target->radius = source->radius;
+    target->halfExtents = source->halfExtents;
+}
+
+}
+
+// Sweep and prune contre toutes les paires, pas après pas sur le même état : mêmes paires candidates,
+// sans doublon. Les extrémités triées survivent d'un pas à l'autre, d'où les déplacements progressifs,
+// un grand saut (changement d'axe de balayage), des bodies statiques et des créations/destructions.
+RMDL_TEST(sweepAndPruneMatchesAllPairs)
+{
+    rmdltest::Random random;
+    PhysicsSystem sap(nullptr);
+    PhysicsSystem reference(nullptr);
+    reference.setBroadPhaseMode(BroadPhaseMode::AllPairs);
+    sap.setGravity(simd::make_float3(0.0f));
+    reference.setGravity(simd::make_float3(0.0f));
+
+    std::vector<uint32_t> ids;
+    for (int i = 0; i < 400; i++)
+    {
+        uint32_t id = sap.createBody();
+        RMDL_CHECK(reference.createBody() == id);
+        randomizeBody(*sap.getBody(id), random, 60.0f);
+        ids.push_back(id);
+    }
+
+    int mismatches = 0;
+    int duplicates = 0;
+    size_t totalPairs = 0;
+    for (int step = 0; step < 150; step++)
+    {
+        if (step % 10 == 5)
+        {
+            for (int k = 0; k < 8; k++)
+            {
+                size_t slot = random.range(0, (int)ids.size() - 1);
+                sap.destroyBody(ids[slot]);
+                reference.destroyBody(ids[slot]);
+                ids[slot] = sap.createBody();
+                RMDL_CHECK(reference.createBody() == ids[slot]);
+                randomizeBody(*sap.getBody(ids[slot]), random, 60.0f);
+            }
+        }
+
+        // Au pas 75 tout se resserre le long de Z : l'axe de plus grande variance change
+        for (uint32_t id : ids)
+        {
+            PhysicsBody* body = sap.getBody(id);
+            if (step == 75)
+                body->position = simd::make_float3(body->position.x * 0.05f, body->position.y, body->position.z * 4.0f);
+            else
+                body->position += simd::make_float3(random.uniform(-0.5f, 0.5f), random.uniform(-0.5f, 0.5f), random.uniform(-0.5f, 0.5f));
+            mirrorBody(sap, reference, id);
+        }
+
+        sap.fixedUpdate();
+        reference.fixedUpdate();
+
+        PairList sapPairs = sortedPairs(sap.getCandidatePairs());
+        PairList referencePairs = sortedPairs(reference.getCandidatePairs());
+        mismatches += sapPairs != referencePairs;
+        duplicates += std::adjacent_find(sapPairs.begin(), sapPairs.end()) != sapPairs.end();
+        totalPairs += referencePairs.size();
+        RMDL_CHECK(sap.getBroadPhaseStats().pairsTested <= reference.getBroadPhaseStats().pairsTested);
+    }
+    RMDL_CHECK(mismatches == 0);
+    RMDL_CHECK(duplicates == 0);
+    RMDL_CHECK(totalPairs > 0);
+}
+
+// Broad phase à 1k, 5k et 20k bodies, densité constante (même volume par body), petits déplacements
+// à chaque pas : paires testées, paires trouvées et ms par pas complet (fixedUpdate), sweep and prune
+// contre toutes les paires sur les mêmes pas (moins de pas quand les bodies sont nombreux)
+RMDL_BENCH(sweepAndPruneVersusAllPairs)
+{
+    for (int count : { 1000, 5000, 20000 })
+    {
+        for (BroadPhaseMode mode : { BroadPhaseMode::SweepAndPrune, BroadPhaseMode::AllPairs })
+        {
+            rmdltest::Random random;
+            PhysicsSystem physics(nullptr);
+            physics.setBroadPhaseMode(mode);
+            physics.setGravity(simd::make_float3(0.0f));
+            float spread = 2.0f * sqrtf((float)count);
+
+            std::vector<uint32_t> ids;
+            for (int i = 0; i < count; i++)
+            {
+                uint32_t id = physics.createBody();
+                randomizeBody(*physics.getBody(id), random, spread);
+                ids.push_back(id);
+            }
+            physics.fixedUpdate();
+
+            int steps = std::max(2, (int)(30000000ll / ((long long)count * count)));
+            uint64_t tested = 0;
+            uint64_t found = 0;
+            double stepMs = 0.0;
+            for (int step = 0; step < steps; step++)
+            {
+                for (uint32_t id : ids)
+                    physics.getBody(id)->position += simd::make_float3(random.uniform(-0.2f, 0.2f), random.uniform(-0.2f, 0.2f), random.uniform(-0.2f, 0.2f));
+                rmdltest::Stopwatch stopwatch;
+                physics.fixedUpdate();
+                stepMs += stopwatch.elapsedMs();
+                tested += physics.getBroadPhaseStats().pairsTested;
+                found += physics.getBroadPhaseStats().pairsFound;
+            }
+            printf("%5d bodies, %-14s : %10llu paires testées, %6llu trouvées, %8.2f ms/pas\n", count,
+                   mode == BroadPhaseMode::SweepAndPrune ? "sweep and prune" : "toutes paires",
+                   (unsigned long long)(tested / steps), (unsigned long long)(found / steps), stepMs / steps);
+        }
+    }
+}
+
+// applyForce et applyImpulse écrivent dans le store quand aucune vue n'est ouverte : même résultat au bit
+// près qu'à travers une vue getBody() ouverte, et rien sur un body statique ou détruit
+RMDL_TEST(forcesWithoutViewMatchOpenView)
+{
+    rmdltest::Random random;
+    PhysicsSystem direct(nullptr);
+    PhysicsSystem viewed(nullptr);
+    std::vector<uint32_t> ids;
+    for (int i = 0; i < 64; i++)
+    {
+        uint32_t id = direct.createBody();
+        RMDL_CHECK(viewed.createBody() == id);
+        PhysicsBody* body = direct.getBody(id);
+        randomizeBody(*body, random, 30.0f);
+        body->mass = random.uniform(0.5f, 4.0f);
+        body->invMass = 1.0f / body->mass;
+        *viewed.getBody(id) = *body;
+        ids.push_back(id);
+    }
+    direct.destroyBody(ids[5]);
+    viewed.destroyBody(ids[5]);
+    direct.integrate(OfficialConfig::PHYSICS_TIMESTEP);
+    viewed.integrate(OfficialConfig::PHYSICS_TIMESTEP);
+
+    std::map<uint32_t, simd::float3> statics;
+    for (uint32_t id : ids)
+        if (PhysicsBody* body = direct.getBody(id); body && body->isStatic)
+            statics[id] = body->position;
+
+    for (int step = 0; step < 50; step++)
+    {
+        for (uint32_t id : ids)
+        {
+            simd::float3 force = simd::make_float3(random.uniform(-5, 5), random.uniform(-5, 5), random.uniform(-5, 5));
+            simd::float3 impulse = simd::make_float3(random.uniform(-1, 1), random.uniform(-1, 1), random.uniform(-1, 1));
+            viewed.getBody(id);
+            for (PhysicsSystem* physics : { &direct, &viewed })
+            {
+                physics->applyForce(id, force);
+                if (step % 7 == 0)
+                    physics->applyImpulse(id, impulse);
+            }
+        }
+        direct.integrate(OfficialConfig::PHYSICS_TIMESTEP);
+        viewed.integrate(OfficialConfig::PHYSICS_TIMESTEP);
+    }
+
+    int mismatches = 0;
+    int movedStatics = 0;
+    for (uint32_t id : ids)
+    {
+        PhysicsBody* a = direct.getBody(id);
+        PhysicsBody* b = viewed.getBody(id);
+        if (!a || !b)
+        {
+            mismatches += a != b;
+            continue;
+        }
+        mismatches += std::memcmp(&a->position, &b->position, sizeof(simd::float3)) != 0
+                      || std::memcmp(&a->linearVelocity, &b->linearVelocity, sizeof(simd::float3)) != 0;
+        if (statics.count(id))
+            movedStatics += std::memcmp(&a->position, &statics[id], sizeof(simd::float3)) != 0;
+    }
+    RMDL_CHECK(mismatches == 0);
+    RMDL_CHECK(movedStatics == 0 && !statics.empty());
+    RMDL_CHECK(direct.getBody(ids[5]) == nullptr);
+}
+
+namespace
+{
+
+// Intégration d'avant PhysicsBodyStore : un body à la fois sur le vecteur de PhysicsBody entiers
+void integratePerBody(std::vector<PhysicsBody>& bodies, simd::float3 gravity, float dt)
+{
+    for (PhysicsBody& body : bodies)
+    {
+        if (!body.active || body.isStatic) continue;
+        if (body.useGravity)
+            body.linearVelocity += gravity * dt;
+        body.linearVelocity += body.accumulatedForce * body.invMass * dt;
+        body.angularVelocity += body.accumulatedTorque * body.invInertia * dt;
+        body.linearVelocity *= (1.0f - body.linearDamping * dt);
+        body.angularVelocity *= (1.0f - body.angularDamping * dt);
+    }
+    for (PhysicsBody& body : bodies)
+    {
+        if (!body.active || body.isStatic) continue;
+        body.position += body.linearVelocity * dt;
+        if (simd::length(body.angularVelocity) > 0.001f)
+        {
+            float angle = simd::length(body.angularVelocity) * dt;
+            simd::quatf deltaRot = simd::quatf(angle, simd::normalize(body.angularVelocity));
+            body.rotation = simd::normalize(deltaRot * body.rotation);
+        }
+    }
+    for (PhysicsBody& body : bodies)
+        body.accumulatedForce = simd::make_float3(0.0f);
+}
+
+}
+
+// Pas d'intégration seul (PhysicsSystem::integrate) sur le store SoA, par blocs de 4 et body par body,
+// contre l'ancienne boucle sur les PhysicsBody entiers, en bodies/ms. Bodies sans rotation, un sur
+// sept statique, une force par body à chaque pas
+RMDL_BENCH(soaIntegrationVersusPerBody)
+{
+    const float dt = OfficialConfig::PHYSICS_TIMESTEP;
+    const int steps = 200;
+    for (int count : { 1000, 20000, 100000 })
+    {
+        for (IntegrationMode mode : { IntegrationMode::Simd, IntegrationMode::Scalar })
+        {
+            rmdltest::Random random;
+            PhysicsSystem physics(nullptr);
+            physics.setIntegrationMode(mode);
+            std::vector<uint32_t> ids;
+            for (int i = 0; i < count; i++)
+            {
+                uint32_t id = physics.createBody();
+                randomizeBody(*physics.getBody(id), random, 100.0f);
+                ids.push_back(id);
+            }
+            physics.integrate(dt);
+
+            double integrateMs = 0.0;
+            for (int step = 0; step < steps; step++)
+            {
+                for (uint32_t id : ids)
+                    physics.applyForce(id, simd::make_float3(0.0f, 1.0f, 0.0f));
+                rmdltest::Stopwatch stopwatch;
+                physics.integrate(dt);
+                integrateMs += stopwatch.elapsedMs();
+            }
+            printf("%6d bodies, store SoA %-6s : %8.0f bodies/ms\n", count, mode == IntegrationMode::Simd ? "simd" : "scalaire",
+                   (double)count * steps / integrateMs);
+        }
+
+        rmdltest::Random random;
+        PhysicsSystem physics(nullptr);
+        std::vector<PhysicsBody> bodies;
+        for (int i = 0; i < count; i++)
+        {
+            uint32_t id = physics.createBody();
+            randomizeBody(*physics.getBody(id), random, 100.0f);
+            bodies.push_back(*physics.getBody(id));
+        }
+
+        double integrateMs = 0.0;
+        for (int step = 0; step < steps; step++)
+        {
+            for (PhysicsBody& body : bodies)
+                body.accumulatedForce += simd::make_float3(0.0f, 1.0f, 0.0f);
+            rmdltest::Stopwatch stopwatch;
+            integratePerBody(bodies, physics.getGravity(), dt);
+            integrateMs += stopwatch.elapsedMs();
+        }
+        printf("%6d bodies, PhysicsBody     : %8.0f bodies/ms (%.1f)\n", count, (double)count * steps / integrateMs,
+               bodies[count / 2].position.y);
+    }
+}
+
+namespace
+{
+
+struct ReplayTrace
+{
+    std::vector<uint32_t>   substeps;
+    std::vector<float>      alphas;
+    std::vector<float>      state;      // positions et vitesses finales des bodies
+};
+
+ReplayTrace replay(const std::vector<float>& frameTimes)
+{
+    ReplayTrace trace;
+    SimulationClock clock;
+    PhysicsSystem physics(nullptr);
+
+    // Un tas de bodies serrés : contacts et résolution à chaque pas
+    rmdltest::Random random;
+    std::vector<uint32_t> ids;
+    for (int i = 0; i < 64; i++)
+    {
+        uint32_t id = physics.createBody();
+        randomizeBody(*physics.getBody(id), random, 6.0f);
+        ids.push_back(id);
+    }
+
+    for (float frameTime : frameTimes)
+    {
+        trace.substeps.push_back(clock.advance(frameTime));
+        trace.alphas.push_back(clock.alpha());
+        physics.update(frameTime);
+    }
+
+    for (uint32_t id : ids)
+    {
+        const PhysicsBody* body = physics.getBody(id);
+        for (simd::float3 value : { body->position, body->linearVelocity })
+            trace.state.insert(trace.state.end(), { value.x, value.y, value.z });
+    }
+    return trace;
+}
+
+}
+
+// Pas fixes : rejouer la même suite de temps de frame (irrégulière, avec un gros à-coup) redonne
+// les mêmes pas, le même alpha et le même état physique au bit près
+RMDL_TEST(fixedStepReplayIsDeterministic)
+{
+    rmdltest::Random random;
+    std::vector<float> frameTimes;
+    for (int i = 0; i < 600; i++)
+        frameTimes.push_back(random.uniform(0.004f, 0.040f));
+    frameTimes[200] = 0.5f;
+
+    ReplayTrace first = replay(frameTimes);
+    ReplayTrace second = replay(frameTimes);
+
+    RMDL_CHECK(first.substeps == second.substeps);
+    RMDL_CHECK(first.alphas.size() == second.alphas.size()
+               && std::memcmp(first.alphas.data(), second.alphas.data(), first.alphas.size() * sizeof(float)) == 0);
+    RMDL_CHECK(first.state.size() == second.state.size()
+               && std::memcmp(first.state.data(), second.state.data(), first.state.size() * sizeof(float)) == 0);
+
+    // Le retard au-delà du plafond est abandonné, et alpha reste une fraction de pas
+    RMDL_CHECK(first.substeps[200] == OfficialConfig::MAX_PHYSICS_SUBSTEPS);
+    int outOfRange = 0;
+    uint32_t totalSteps = 0;
+    for (size_t i = 0; i < frameTimes.size(); i++)
+    {
+        outOfRange += first.substeps[i] > OfficialConfig::MAX_PHYSICS_SUBSTEPS || first.alphas[i] < 0.0f || first.alphas[i] >= 1.0f;
+        totalSteps += first.substeps[i];
+    }
+    RMDL_CHECK(outOfRange == 0);
+    RMDL_CHECK(totalSteps > 0);
+}
+
+namespace
+{
+
+// Le tas doit toujours être un tas min et chaque requête rangée là où l'index la voit
+bool heapIsConsistent(const TerrainRequestQueue& queue)
+{
+    const std::vector<TerrainGenerationRequest>& heap = queue.requests();
+    for (size_t i = 1; i < heap.size(); i++)
+        if (heap[(i - 1) / 2].priority > heap[i].priority)
+            return false;
+    for (const TerrainGenerationRequest& request : heap)
+        if (!queue.contains(request.coord.hash()))
+            return false;
+    return true;
+}
+
+}
+
+// File de requêtes terrain contre un modèle trivial (clé -> priorité) : après des push, des
+// remplacements, des annulations et des changements de priorité (vers le haut et vers le bas),
+// les pop sortent par priorité croissante et exactement les requêtes encore en attente
+RMDL_TEST(terrainRequestQueueCancelsAndReprioritizes)
+{
+    rmdltest::Random random;
+    TerrainRequestQueue queue;
+    std::map<uint64_t, uint32_t> model;
+    std::map<uint64_t, Types::ChunkCoord> coords;
+
+    auto randomCoord = [&]() {
+        return Types::ChunkCoord{ random.range(-12, 12), random.range(-12, 12) };
+    };
+
+    int modelMismatches = 0;
+    int heapErrors = 0;
+    int orderErrors = 0;
+    int pops = 0;
+    for (int round = 0; round < 40; round++)
+    {
+        for (int op = 0; op < 200; op++)
+        {
+            Types::ChunkCoord coord = randomCoord();
+            uint64_t key = coord.hash();
+            uint32_t priority = (uint32_t)random.range(0, 1000);
+            switch (random.range(0, 3))
+            {
+                case 0:
+                case 1:
+                {
+                    bool inserted = queue.push({ coord, priority, nullptr });
+                    modelMismatches += inserted == (model.count(key) != 0);
+                    model[key] = priority;
+                    coords[key] = coord;
+                    break;
+                }
+                case 2:
+                    modelMismatches += queue.remove(key) != (model.erase(key) != 0);
+                    break;
+                default:
+                {
+                    auto it = model.find(key);
+                    modelMismatches += queue.updatePriority(key, priority) != (it != model.end());
+                    if (it != model.end())
+                        it->second = priority;
+                    break;
+                }
+            }
+            heapErrors += !heapIsConsistent(queue);
+        }
+        modelMismatches += queue.size() != model.size();
+
+        // Vide la moitié de la file : chaque pop doit être un minimum courant du modèle
+        uint32_t previous = 0;
+        for (size_t n = model.size() / 2; n > 0; n--)
+        {
+            TerrainGenerationRequest request = queue.pop();
+            uint64_t key = request.coord.hash();
+            auto it = model.find(key);
+            uint32_t minimum = UINT32_MAX;
+            for (const auto& [_, priority] : model)
+                minimum = std::min(minimum, priority);
+            orderErrors += it == model.end() || it->second != request.priority || request.priority != minimum
+                           || request.priority < previous || !(coords[key] == request.coord) || queue.contains(key);
+            previous = request.priority;
+            if (it != model.end())
+                model.erase(it);
+            pops++;
+        }
+        heapErrors += !heapIsConsistent(queue);
+    }
+
+    while (!queue.empty())
+    {
+        TerrainGenerationRequest request = queue.pop();
+        orderErrors += model.erase(request.coord.hash()) != 1;
+        pops++;
+    }
+    RMDL_CHECK(modelMismatches == 0);
+    RMDL_CHECK(heapErrors == 0);
+    RMDL_CHECK(orderErrors == 0);
+    RMDL_CHECK(model.empty());
+    RMDL_CHECK(pops > 1000);
+}
+
+namespace
+{
+
+struct FlythroughStats
+{
+    uint32_t generated = 0;
+    uint32_t wasted = 0;        // générés puis déchargés sans être jamais entrés dans le rayon de vue
+    uint32_t cancelled = 0;
+    double missing = 0.0;       // chunks absents du rayon de vue, en moyenne par frame
+};
+
+// Même distance que TerrainManager::calculatePriority et ChunkMap::updateDistance
+uint32_t chunkDistance(Types::ChunkCoord coord, simd::float2 camera)
+{
+    float dx = (coord.x + 0.5f) * OfficialConfig::CHUNK_SIZE - camera.x;
+    float dz = (coord.z + 0.5f) * OfficialConfig::CHUNK_SIZE - camera.y;
+    return (uint32_t)std::sqrt(dx * dx + dz * dz);
+}
+
+// TerrainManager::update sans Metal : requêtes dans le rayon de vue (plafond MAX_LOADED_CHUNKS),
+// refreshRequests si refresh, generatedPerFrame chunks sortis de la file par frame (les workers),
+// déchargement au-delà de CHUNK_UNLOAD_DISTANCE. La caméra suit waypoints à speed unités par frame
+FlythroughStats flyOverTerrain(const std::vector<simd::float2>& waypoints, float speed, uint32_t generatedPerFrame, bool refresh)
+{
+    struct LoadedChunk
+    {
+        Types::ChunkCoord coord;
+        bool seen;
+    };
+
+    FlythroughStats stats;
+    TerrainRequestQueue queue;
+    std::unordered_map<uint64_t, LoadedChunk> loaded;
+    std::unordered_map<uint64_t, Types::ChunkCoord> pending;
+    const int32_t viewDist = (int32_t)OfficialConfig::VIEW_DISTANCE_CHUNKS;
+    const float viewRadius = (float)(OfficialConfig::VIEW_DISTANCE_CHUNKS * OfficialConfig::CHUNK_SIZE);
+
+    simd::float2 camera = waypoints[0];
+    uint32_t frames = 0;
+    for (size_t next = 1; next < waypoints.size(); frames++)
+    {
+        simd::float2 toNext = waypoints[next] - camera;
+        float remaining = simd::length(toNext);
+        if (remaining <= speed)
+            camera = waypoints[next++];
+        else
+            camera += toNext * (speed / remaining);
+
+        if (refresh)
+        {
+            std::vector<std::pair<Types::ChunkCoord, uint32_t>> updates;
+            std::vector<Types::ChunkCoord> cancelled;
+            for (const TerrainGenerationRequest& request : queue.requests())
+            {
+                uint32_t priority = chunkDistance(request.coord, camera);
+                if (priority > OfficialConfig::CHUNK_UNLOAD_DISTANCE)
+                    cancelled.push_back(request.coord);
+                else if (priority != request.priority)
+                    updates.emplace_back(request.coord, priority);
+            }
+            for (Types::ChunkCoord coord : cancelled)
+            {
+                queue.remove(coord.hash());
+                pending.erase(coord.hash());
+            }
+            for (const auto& [coord, priority] : updates)
+                queue.updatePriority(coord.hash(), priority);
+            stats.cancelled += (uint32_t)cancelled.size();
+        }
+
+        Types::ChunkCoord cameraChunk = { (int32_t)std::floor(camera.x / OfficialConfig::CHUNK_SIZE),
+                                          (int32_t)std::floor(camera.y / OfficialConfig::CHUNK_SIZE) };
+        uint32_t missing = 0;
+        for (int32_t dz = -viewDist; dz <= viewDist; dz++)
+        {
+            for (int32_t dx = -viewDist; dx <= viewDist; dx++)
+            {
+                if (std::sqrt((float)(dx * dx + dz * dz)) > viewDist)
+                    continue;
+                Types::ChunkCoord coord = { cameraChunk.x + dx, cameraChunk.z + dz };
+                uint64_t key = coord.hash();
+                if (loaded.count(key))
+                    continue;
+                missing++;
+                if (pending.count(key) || loaded.size() + pending.size() >= OfficialConfig::MAX_LOADED_CHUNKS)
+                    continue;
+                pending.emplace(key, coord);
+                queue.push({ coord, chunkDistance(coord, camera), nullptr });
+            }
+        }
+        stats.missing += missing;
+
+        for (uint32_t g = 0; g < generatedPerFrame && !queue.empty(); g++)
+        {
+            TerrainGenerationRequest request = queue.pop();
+            pending.erase(request.coord.hash());
+            loaded[request.coord.hash()] = { request.coord, false };
+            stats.generated++;
+        }
+
+        for (auto it = loaded.begin(); it != loaded.end();)
+        {
+            uint32_t distance = chunkDistance(it->second.coord, camera);
+            it->second.seen |= distance <= viewRadius;
+            if (distance > OfficialConfig::CHUNK_UNLOAD_DISTANCE)
+            {
+                stats.wasted += !it->second.seen;
+                it = loaded.erase(it);
+            }
+            else
+                ++it;
+        }
+    }
+    stats.missing /= frames;
+    return stats;
+}
+
+}
+
+// Survol scripté (ligne droite, virage, demi-tour) à plusieurs vitesses, workers à débit fixe : générations
+// gaspillées (chunk généré puis déchargé sans avoir été dans le rayon de vue) et trous dans le rayon de vue,
+// avec refreshRequests (priorités recalculées, annulation au-delà du rayon de déchargement) et sans
+// (priorité figée à la requête, rien n'est annulé)
+RMDL_BENCH(terrainFlythroughWastedGenerations)
+{
+    const std::vector<simd::float2> waypoints = { { 0, 0 }, { 1600, 0 }, { 1600, 800 }, { 400, 800 }, { 400, -400 } };
+    const uint32_t generatedPerFrame = 6;
+    for (float speed : { 1.0f, 3.0f, 6.0f })
+    {
+        for (bool refresh : { false, true })
+        {
+            FlythroughStats stats = flyOverTerrain(waypoints, speed, generatedPerFrame, refresh);
+            printf("%.0f u/frame, %-22s : %6u générés, %5u gaspillés (%4.1f %%), %5u annulés, %5.1f chunks manquants/frame\n",
+                   speed, refresh ? "avec refreshRequests" : "priorités figées", stats.generated, stats.wasted,
+                   100.0 * stats.wasted / std::max(1u, stats.generated), stats.cancelled, stats.missing);
+        }
+    }
+}
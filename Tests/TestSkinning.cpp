@@ -0,0 +1,165 @@
+//
+//  TestSkinning.cpp
+//  Spammy
+//
+//  Created by Rémy on 17/10/2026.
+//
+
+#include "RMDLTest.hpp"
+#include "RMDLSkinning.hpp"
+#include "RMDLBlender.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace
+{
+
+// Palette plausible : rotation, échelle non uniforme et translation par bone
+std::vector<simd::float4x4> randomPalette(rmdltest::Random& random, uint32_t boneCount)
+{
+    std::vector<simd::float4x4> palette(boneCount);
+    for (simd::float4x4& bone : palette)
+    {
+        simd::float3 axis = simd::normalize(simd::float3{ random.uniform(-1.0f, 1.0f), random.uniform(-1.0f, 1.0f), random.uniform(0.1f, 1.0f) });
+        bone = simd::float4x4(simd_quaternion(random.uniform(-3.0f, 3.0f), axis));
+        for (int c = 0; c < 3; c++)
+            bone.columns[c] *= random.uniform(0.5f, 2.0f);
+        bone.columns[3] = simd::float4{ random.uniform(-5.0f, 5.0f), random.uniform(-5.0f, 5.0f), random.uniform(-5.0f, 5.0f), 1.0f };
+    }
+    return palette;
+}
+
+// Une à quatre influences normalisées, plus quelques joints hors palette (-1 ou trop grands)
+// que prepare doit ignorer comme le fait le shader
+std::vector<VertexBlenderFull> randomVertices(rmdltest::Random& random, size_t count, uint32_t boneCount)
+{
+    std::vector<VertexBlenderFull> vertices(count);
+    for (VertexBlenderFull& v : vertices)
+    {
+        v.position = simd::float3{ random.uniform(-1.0f, 1.0f), random.uniform(0.0f, 2.0f), random.uniform(-1.0f, 1.0f) };
+        v.normal = simd::normalize(simd::float3{ random.uniform(-1.0f, 1.0f), random.uniform(-1.0f, 1.0f), random.uniform(-1.0f, 1.0f) });
+        v.texCoord = simd::float2{ 0.0f, 0.0f };
+        int influences = random.range(1, 4);
+        float total = 0.0f;
+        for (int k = 0; k < 4; k++)
+        {
+            v.joints[k] = k < influences ? random.range(0, (int)boneCount - 1) : -1;
+            v.weights[k] = k < influences ? random.uniform(0.1f, 1.0f) : 0.0f;
+            total += v.weights[k];
+        }
+        for (int k = 0; k < 4; k++)
+            v.weights[k] /= total;
+        if (random.range(0, 20) == 0)
+            v.joints[random.range(0, 3)] = random.range(0, 1) ? -1 : (int)boneCount + random.range(0, 5);
+    }
+    return vertices;
+}
+
+// Référence scalaire : la formule du shader élément par élément, sans float4 ni lot
+void referenceSkin(const VertexBlenderFull& v, const std::vector<simd::float4x4>& palette, float position[3], float normal[3])
+{
+    float skin[4][4] = {};
+    for (int k = 0; k < 4; k++)
+    {
+        if (v.joints[k] < 0 || v.joints[k] >= (int)palette.size() || v.weights[k] <= 0.0f)
+            continue;
+        for (int c = 0; c < 4; c++)
+            for (int r = 0; r < 4; r++)
+                skin[c][r] += palette[v.joints[k]].columns[c][r] * v.weights[k];
+    }
+    float p[3] = { v.position.x, v.position.y, v.position.z };
+    float n[3] = { v.normal.x, v.normal.y, v.normal.z };
+    float lengthSq = 0.0f;
+    for (int r = 0; r < 3; r++)
+    {
+        position[r] = skin[3][r];
+        normal[r] = 0.0f;
+        for (int c = 0; c < 3; c++)
+        {
+            position[r] += skin[c][r] * p[c];
+            normal[r] += skin[c][r] * n[c];
+        }
+        lengthSq += normal[r] * normal[r];
+    }
+    float inverseLength = lengthSq > 0.0f ? 1.0f / std::sqrt(lengthSq) : 0.0f;
+    for (int r = 0; r < 3; r++)
+        normal[r] *= inverseLength;
+}
+
+}
+
+// skin (lots de BATCH_SIZE, float4) contre la référence scalaire : positions, normales et boîte,
+// pour des tailles qui tombent pile sur un lot, juste à côté, ou sous un lot
+RMDL_TEST(skinMatchesScalarReference)
+{
+    rmdltest::Random random;
+    int positionErrors = 0;
+    int normalErrors = 0;
+    int boundsErrors = 0;
+    for (size_t count : { (size_t)1, (size_t)37, skinning::BATCH_SIZE, skinning::BATCH_SIZE + 1, 5 * skinning::BATCH_SIZE - 3 })
+    {
+        uint32_t boneCount = (uint32_t)random.range(1, 80);
+        std::vector<simd::float4x4> palette = randomPalette(random, boneCount);
+        std::vector<VertexBlenderFull> vertices = randomVertices(random, count, boneCount);
+
+        skinning::SkinStream stream;
+        skinning::prepare(vertices.data(), vertices.size(), boneCount, stream);
+        std::vector<simd::float4> positions(count), normals(count);
+        skinning::Bounds bounds = skinning::skin(stream, palette.data(), positions.data(), normals.data());
+
+        simd::float3 lo = { INFINITY, INFINITY, INFINITY }, hi = -lo;
+        for (size_t i = 0; i < count; i++)
+        {
+            float position[3], normal[3];
+            referenceSkin(vertices[i], palette, position, normal);
+            simd::float3 expected = { position[0], position[1], position[2] };
+            lo = simd::min(lo, expected);
+            hi = simd::max(hi, expected);
+            positionErrors += simd::distance(positions[i].xyz, expected) > 1e-4f * (1.0f + simd::length(expected));
+            normalErrors += simd::distance(normals[i].xyz, simd::float3{ normal[0], normal[1], normal[2] }) > 1e-4f || normals[i].w != 0.0f;
+        }
+        boundsErrors += simd::distance(bounds.min, lo) > 1e-3f || simd::distance(bounds.max, hi) > 1e-3f;
+
+        // Un lot isolé donne les mêmes positions et sa propre boîte
+        std::vector<simd::float4> batch(count);
+        size_t first = count / 3;
+        skinning::Bounds partial = skinning::skinBatch(stream, palette.data(), first, count - first, batch.data(), nullptr);
+        for (size_t i = first; i < count; i++)
+            positionErrors += simd::any(batch[i] != positions[i]);
+        boundsErrors += partial.empty() || simd::any(partial.min < bounds.min) || simd::any(partial.max > bounds.max);
+    }
+    RMDL_CHECK(positionErrors == 0);
+    RMDL_CHECK(normalErrors == 0);
+    RMDL_CHECK(boundsErrors == 0);
+}
+
+// Débit du skinning CPU sur un personnage de 60k vertices et 96 bones, avec et sans normales
+RMDL_BENCH(skinSixtyThousandVertices)
+{
+    rmdltest::Random random;
+    const uint32_t boneCount = 96;
+    const size_t count = 60000;
+    std::vector<simd::float4x4> palette = randomPalette(random, boneCount);
+    std::vector<VertexBlenderFull> vertices = randomVertices(random, count, boneCount);
+    skinning::SkinStream stream;
+    skinning::prepare(vertices.data(), vertices.size(), boneCount, stream);
+    std::vector<simd::float4> positions(count), normals(count);
+
+    const int frames = 200;
+    for (bool withNormals : { true, false })
+    {
+        float checksum = 0.0f;
+        rmdltest::Stopwatch stopwatch;
+        for (int frame = 0; frame < frames; frame++)
+        {
+            palette[frame % boneCount].columns[3].y += 0.001f;
+            skinning::Bounds bounds = skinning::skin(stream, palette.data(), positions.data(), withNormals ? normals.data() : nullptr);
+            checksum += bounds.max.y;
+        }
+        double ms = stopwatch.elapsedMs() / frames;
+        printf("skinning %zu vertices %s : %.3f ms/frame, %.1f M vertices/s (%.1f)\n", count,
+               withNormals ? "positions + normales" : "positions seules", ms, count / (ms * 1e3), checksum);
+    }
+}
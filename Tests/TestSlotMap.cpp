@@ -0,0 +1,193 @@
+//
+//  TestSlotMap.cpp
+//  Spammy
+//
+//  Created by Rémy on 17/10/2026.
+//
+
+#include "RMDLTest.hpp"
+#include "RMDLSlotMap.hpp"
+
+#include <algorithm>
+#include <unordered_map>
+#include <vector>
+
+namespace
+{
+
+// Même forme que BlockInstance côté slot map : l'id plus une position de grille
+struct Item
+{
+    uint32_t id;
+    int64_t cell;
+};
+
+}
+
+// Ajouts et retraits aléatoires contre un modèle naïf (vecteur d'ids vivants) : les ids vivants
+// se retrouvent, les ids retirés sont refusés, le stockage reste dense et sans doublon
+RMDL_TEST(slotMapMatchesNaiveModel)
+{
+    rmdltest::Random random;
+    SlotMap<Item> items;
+    std::vector<Item> alive;
+    std::vector<uint32_t> removed;
+    int lookupErrors = 0;
+    int staleErrors = 0;
+    int denseErrors = 0;
+
+    for (int step = 0; step < 20000; step++)
+    {
+        if (alive.empty() || random.range(0, 2) != 0)
+        {
+            Item* added = items.insert({ 0, (int64_t)step });
+            lookupErrors += added == nullptr || added->id == 0;
+            if (added)
+                alive.push_back(*added);
+        }
+        else
+        {
+            size_t index = (size_t)random.range(0, (int)alive.size() - 1);
+            lookupErrors += !items.erase(alive[index].id);
+            removed.push_back(alive[index].id);
+            alive[index] = alive.back();
+            alive.pop_back();
+        }
+
+        if (step % 97 == 0)
+        {
+            for (const Item& item : alive)
+            {
+                const Item* found = items.get(item.id);
+                lookupErrors += found == nullptr || found->cell != item.cell;
+            }
+            for (uint32_t id : removed)
+                staleErrors += items.get(id) != nullptr;
+            staleErrors += items.erase(0) || items.get(0) != nullptr;
+
+            std::vector<uint32_t> ids;
+            for (const Item& item : items)
+                ids.push_back(item.id);
+            std::sort(ids.begin(), ids.end());
+            denseErrors += ids.size() != alive.size() || std::adjacent_find(ids.begin(), ids.end()) != ids.end();
+        }
+    }
+    RMDL_CHECK(lookupErrors == 0);
+    RMDL_CHECK(staleErrors == 0);
+    RMDL_CHECK(denseErrors == 0);
+}
+
+// Un même slot recyclé au-delà des 4095 générations : l'id gardé depuis le début reste refusé
+// tant que son slot est libre ou occupé par un autre id, et la génération ne vaut jamais 0
+RMDL_TEST(slotMapGenerationWraps)
+{
+    SlotMap<Item> items;
+    uint32_t first = items.insert({ 0, 1 })->id;
+    uint32_t second = items.insert({ 0, 2 })->id;
+    uint32_t keeper = items.insert({ 0, 3 })->id;
+    items.insert({ 0, 4 });
+    // Le slot libre de first chaîne celui de second : son denseIndex (1) tombe sur un bloc vivant
+    RMDL_CHECK(items.erase(second) && items.erase(first));
+
+    int staleErrors = 0;
+    int generationErrors = 0;
+    uint32_t id = first;
+    for (int cycle = 0; cycle < 10000; cycle++)
+    {
+        Item* added = items.insert({ 0, cycle });
+        generationErrors += (added->id & SlotMap<Item>::kSlotMask) != (first & SlotMap<Item>::kSlotMask) || (added->id >> SlotMap<Item>::kSlotBits) == 0;
+        staleErrors += added->id != first && items.get(first) != nullptr;
+        staleErrors += items.get(id) != nullptr && id != added->id;
+        id = added->id;
+        items.erase(id);
+        staleErrors += items.get(id) != nullptr || items.get(first) != nullptr;
+    }
+    RMDL_CHECK(staleErrors == 0);
+    RMDL_CHECK(generationErrors == 0);
+    RMDL_CHECK(items.size() == 2 && items.get(keeper) != nullptr && items.get(keeper)->cell == 3);
+}
+
+// Churn d'un vaisseau de 50k blocs comme BlockSystem : slot map + table de grille, retrait et
+// ajout à chaque pas, recherches d'ids vivants et périmés. En regard, l'ancienne recherche
+// linéaire (find_if sur le vecteur) sur moins d'opérations, ramenée au coût par opération.
+RMDL_BENCH(slotMapFiftyThousandChurn)
+{
+    const int blockCount = 50000;
+    const int operations = 1000000;
+    rmdltest::Random random;
+
+    SlotMap<Item> items;
+    std::unordered_map<int64_t, uint32_t> gridMap;
+    std::vector<uint32_t> ids;
+    gridMap.reserve(blockCount);
+    ids.reserve(blockCount);
+
+    rmdltest::Stopwatch stopwatch;
+    for (int i = 0; i < blockCount; i++)
+    {
+        Item* added = items.insert({ 0, i });
+        gridMap[i] = added->id;
+        ids.push_back(added->id);
+    }
+    double fillMs = stopwatch.elapsedMs();
+
+    int64_t nextCell = blockCount;
+    uint64_t checksum = 0;
+    uint32_t stale = 0;
+    stopwatch.restart();
+    for (int op = 0; op < operations; op++)
+    {
+        size_t index = (size_t)random.range(0, blockCount - 1);
+        switch (op & 3)
+        {
+            case 0:
+            {
+                // Retrait puis pose ailleurs : l'id retiré devient l'id périmé de référence
+                const Item* item = items.get(ids[index]);
+                gridMap.erase(item->cell);
+                stale = ids[index];
+                items.erase(ids[index]);
+                Item* added = items.insert({ 0, nextCell });
+                gridMap[nextCell++] = added->id;
+                ids[index] = added->id;
+                break;
+            }
+            case 3:
+                checksum += items.get(stale) != nullptr;
+                break;
+            default:
+                checksum += (uint64_t)items.get(ids[index])->cell;
+                break;
+        }
+    }
+    double churnMs = stopwatch.elapsedMs();
+
+    // Ancien BlockSystem : vecteur de blocs, recherche linéaire par id
+    std::vector<Item> linear;
+    linear.reserve(blockCount);
+    for (int i = 0; i < blockCount; i++)
+        linear.push_back({ (uint32_t)i + 1, i });
+    uint32_t nextId = blockCount + 1;
+    const int linearOperations = 4000;
+    stopwatch.restart();
+    for (int op = 0; op < linearOperations; op++)
+    {
+        uint32_t id = linear[(size_t)random.range(0, blockCount - 1)].id;
+        auto it = std::find_if(linear.begin(), linear.end(), [id](const Item& item) { return item.id == id; });
+        if ((op & 3) == 0)
+        {
+            *it = linear.back();
+            linear.pop_back();
+            linear.push_back({ nextId++, nextCell++ });
+        }
+        else
+            checksum += (uint64_t)it->cell;
+    }
+    double linearMs = stopwatch.elapsedMs();
+
+    printf("slot map %d blocs : remplissage %.2f ms, churn %.1f ns/op (%d ops, %zu vivants)\n",
+           blockCount, fillMs, churnMs * 1e6 / operations, operations, items.size());
+    printf("recherche linéaire %d blocs : %.1f ns/op, %.0fx plus lent (%llu)\n",
+           blockCount, linearMs * 1e6 / linearOperations, (linearMs / linearOperations) / (churnMs / operations),
+           (unsigned long long)checksum);
+}
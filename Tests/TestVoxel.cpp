@@ -0,0 +1,713 @@
+//
+//  TestVoxel.cpp
+//  Spammy
+//
+//  Created by Rémy on 17/10/2026.
+//
+
+#include "RMDLTest.hpp"
+#include "VoronoiVoxel4D.hpp"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <ctime>
+#include <limits>
+#include <map>
+#include <memory>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace
+{
+
+constexpr int kCellsPerFace = CHUNK_SIZE * CHUNK_HEIGHT * CHUNK_SIZE;
+
+int faceFromNormal(simd::float3 normal)
+{
+    if (normal.y > 0.5f)  return 0;
+    if (normal.y < -0.5f) return 1;
+    if (normal.z < -0.5f) return 2;
+    if (normal.z > 0.5f)  return 3;
+    if (normal.x > 0.5f)  return 4;
+    return 5;
+}
+
+int faceAxis(int face)
+{
+    static const int axis[6] = { 1, 1, 2, 2, 0, 0 };
+    return axis[face];
+}
+
+// Cellules (face, x, y, z) locales couvertes par chaque quad d'un maillage : un quad de w x h blocs
+// s'étend sur w - 1 + VOXELSIZE, et sa coordonnée sur la normale tombe dans le bloc d'origine.
+// coverage compte les recouvrements ; onQuad reçoit la liste des cellules de chaque quad.
+template<typename OnQuad>
+void collectCells(const Chunk& chunk, const std::vector<VoxelVertex>& vertices, const std::vector<uint32_t>& indices,
+                  std::vector<uint8_t>& coverage, OnQuad onQuad)
+{
+    coverage.assign(6 * kCellsPerFace, 0);
+    RMDL_CHECK(vertices.size() % 4 == 0);
+    RMDL_CHECK(indices.size() == vertices.size() / 4 * 6);
+
+    std::vector<int> cells;
+    int outside = 0;
+    for (size_t q = 0; q + 3 < vertices.size(); q += 4)
+    {
+        int face = faceFromNormal(vertices[q].normal);
+        simd::float3 lo = vertices[q].position;
+        simd::float3 hi = vertices[q].position;
+        for (int i = 1; i < 4; i++)
+        {
+            lo = simd::min(lo, vertices[q + i].position);
+            hi = simd::max(hi, vertices[q + i].position);
+        }
+
+        int base[3], count[3];
+        const float origin[3] = { lo.x - chunk.chunkX * CHUNK_SIZE, lo.y, lo.z - chunk.chunkZ * CHUNK_SIZE };
+        const float extent[3] = { hi.x - lo.x, hi.y - lo.y, hi.z - lo.z };
+        for (int a = 0; a < 3; a++)
+        {
+            base[a] = (int)std::floor(origin[a] + 0.001f);
+            count[a] = a == faceAxis(face) ? 1 : (int)std::lround(extent[a] - VOXELSIZE) + 1;
+        }
+
+        cells.clear();
+        for (int x = base[0]; x < base[0] + count[0]; x++)
+            for (int y = base[1]; y < base[1] + count[1]; y++)
+                for (int z = base[2]; z < base[2] + count[2]; z++)
+                {
+                    if (x < 0 || x >= CHUNK_SIZE || y < 0 || y >= CHUNK_HEIGHT || z < 0 || z >= CHUNK_SIZE)
+                    {
+                        outside++;
+                        continue;
+                    }
+                    int cell = face * kCellsPerFace + (x * CHUNK_HEIGHT + y) * CHUNK_SIZE + z;
+                    coverage[cell]++;
+                    cells.push_back(cell);
+                }
+        onQuad(cells);
+    }
+    RMDL_CHECK(outside == 0);
+}
+
+void fillRandom(Chunk& chunk, rmdltest::Random& random, int density)
+{
+    static const BlockType kTypes[3] = { BlockType::STONE, BlockType::METAL, BlockType::ORGANIC };
+    for (int x = 0; x < CHUNK_SIZE; x++)
+        for (int z = 0; z < CHUNK_SIZE; z++)
+        {
+            // Un sol plein sous une hauteur aléatoire (grandes faces à fusionner), du bruit au-dessus
+            int ground = random.range(0, CHUNK_HEIGHT / 4);
+            for (int y = 0; y < CHUNK_HEIGHT; y++)
+            {
+                bool solid = y < ground || random.range(0, 99) < density;
+                chunk.blocks[x][y][z] = solid ? kTypes[random.range(0, y < ground ? 0 : 2)] : BlockType::AIR;
+            }
+        }
+}
+
+BlockType cellType(const Chunk& chunk, int cell)
+{
+    int local = cell % kCellsPerFace;
+    return chunk.blocks[local / (CHUNK_HEIGHT * CHUNK_SIZE)][(local / CHUNK_SIZE) % CHUNK_HEIGHT][local % CHUNK_SIZE];
+}
+
+}
+
+// Le mailleur glouton doit couvrir exactement les faces du naïf (même ensemble, sans recouvrement),
+// chaque rectangle ne portant qu'un type de bloc, avec ou sans voisins chargés
+RMDL_TEST(greedyMeshMatchesNaive)
+{
+    rmdltest::Random random;
+    for (int round = 0; round < 12; round++)
+    {
+        auto chunk = std::make_unique<Chunk>(3, -2);
+        auto negX = std::make_unique<Chunk>(2, -2);
+        auto posX = std::make_unique<Chunk>(4, -2);
+        auto negZ = std::make_unique<Chunk>(3, -3);
+        auto posZ = std::make_unique<Chunk>(3, -1);
+        int density = (round % 4) * 15;
+        fillRandom(*chunk, random, density);
+        fillRandom(*negX, random, density);
+        fillRandom(*posX, random, density);
+        fillRandom(*negZ, random, density);
+        fillRandom(*posZ, random, density);
+
+        ChunkNeighbors neighbors;
+        if (round % 2)
+            neighbors = { negX.get(), posX.get(), negZ.get(), posZ.get() };
+
+        std::vector<VoxelVertex> naiveVertices, greedyVertices;
+        std::vector<uint32_t> naiveIndices, greedyIndices;
+        chunk->buildMeshNaive(naiveVertices, naiveIndices, neighbors);
+        chunk->buildMeshGreedy(greedyVertices, greedyIndices, neighbors);
+
+        std::vector<uint8_t> naiveCoverage, greedyCoverage;
+        int oversizedNaiveQuads = 0;
+        int mixedGreedyQuads = 0;
+        collectCells(*chunk, naiveVertices, naiveIndices, naiveCoverage, [&](const std::vector<int>& cells) {
+            oversizedNaiveQuads += cells.size() != 1;
+        });
+        collectCells(*chunk, greedyVertices, greedyIndices, greedyCoverage, [&](const std::vector<int>& cells) {
+            for (int cell : cells)
+            {
+                if (cellType(*chunk, cell) != cellType(*chunk, cells[0]))
+                {
+                    mixedGreedyQuads++;
+                    break;
+                }
+            }
+        });
+        RMDL_CHECK(oversizedNaiveQuads == 0);
+        RMDL_CHECK(mixedGreedyQuads == 0);
+
+        int mismatches = 0;
+        for (size_t cell = 0; cell < naiveCoverage.size(); cell++)
+            mismatches += naiveCoverage[cell] > 1 || naiveCoverage[cell] != greedyCoverage[cell];
+        RMDL_CHECK(mismatches == 0);
+        RMDL_CHECK(greedyIndices.size() <= naiveIndices.size());
+    }
+}
+
+namespace
+{
+
+// Même remplissage que VoxelWorld::generateChunkBlocks sans BiomeGenerator
+void fillTerrain(Chunk& chunk, VoronoiVoxel4D& generator)
+{
+    generator.generateSitesForRegion(chunk.chunkX, chunk.chunkZ, 0.0f);
+    for (int x = 0; x < CHUNK_SIZE; x++)
+        for (int z = 0; z < CHUNK_SIZE; z++)
+            for (int y = 0; y < CHUNK_HEIGHT; y++)
+            {
+                BlockType type = generator.getBlockAtPosition(chunk.chunkX * CHUNK_SIZE + x, y, chunk.chunkZ * CHUNK_SIZE + z, 0.0f);
+                chunk.blocks[x][y][z] = (y < 5 || y > 100) ? BlockType::AIR : type;
+            }
+}
+
+}
+
+// Glouton contre naïf, par chunk : vertices, indices et µs de maillage CPU, sur le terrain Voronoi
+// de VoxelWorld et sur le remplissage aléatoire du test (sol plein + bruit)
+RMDL_BENCH(greedyVersusNaiveMeshing)
+{
+    const int chunkCount = 24;
+    const int repeats = 10;
+    rmdltest::Random random;
+    VoronoiVoxel4D generator(WORLD_SEED);
+
+    for (int terrain = 0; terrain < 2; terrain++)
+    {
+        std::vector<std::unique_ptr<Chunk>> chunks;
+        for (int c = 0; c < chunkCount; c++)
+        {
+            chunks.push_back(std::make_unique<Chunk>(c % 6 - 3, c / 6 - 2));
+            if (terrain == 0)
+                fillTerrain(*chunks.back(), generator);
+            else
+                fillRandom(*chunks.back(), random, 10);
+        }
+
+        for (MeshingMode mode : { MeshingMode::Naive, MeshingMode::Greedy })
+        {
+            std::vector<VoxelVertex> vertices;
+            std::vector<uint32_t> indices;
+            size_t vertexCount = 0;
+            size_t indexCount = 0;
+            rmdltest::Stopwatch stopwatch;
+            for (int r = 0; r < repeats; r++)
+                for (const std::unique_ptr<Chunk>& chunk : chunks)
+                {
+                    vertices.clear();
+                    indices.clear();
+                    if (mode == MeshingMode::Greedy)
+                        chunk->buildMeshGreedy(vertices, indices);
+                    else
+                        chunk->buildMeshNaive(vertices, indices);
+                    vertexCount += vertices.size();
+                    indexCount += indices.size();
+                }
+            double us = stopwatch.elapsedMs() * 1000.0 / (chunkCount * repeats);
+            printf("%-9s %-7s : %7zu vertices, %7zu indices, %8.1f µs par chunk\n", terrain == 0 ? "terrain" : "aléatoire",
+                   mode == MeshingMode::Greedy ? "glouton" : "naïf", vertexCount / (chunkCount * repeats), indexCount / (chunkCount * repeats), us);
+        }
+    }
+}
+
+namespace
+{
+
+void fillBelow(Chunk& chunk, int height)
+{
+    for (int x = 0; x < CHUNK_SIZE; x++)
+        for (int y = 0; y < CHUNK_HEIGHT; y++)
+            for (int z = 0; z < CHUNK_SIZE; z++)
+                chunk.blocks[x][y][z] = y < height ? BlockType::STONE : BlockType::AIR;
+}
+
+// Nombre de faces (en cellules) d'une direction dans la tranche slice de l'axe de la face
+int countFaceCells(const Chunk& chunk, const ChunkNeighbors& neighbors, MeshingMode mode, int face, int slice)
+{
+    std::vector<VoxelVertex> vertices;
+    std::vector<uint32_t> indices;
+    if (mode == MeshingMode::Greedy)
+        chunk.buildMeshGreedy(vertices, indices, neighbors);
+    else
+        chunk.buildMeshNaive(vertices, indices, neighbors);
+
+    std::vector<uint8_t> coverage;
+    collectCells(chunk, vertices, indices, coverage, [](const std::vector<int>&) {});
+
+    int count = 0;
+    for (int x = 0; x < CHUNK_SIZE; x++)
+        for (int y = 0; y < CHUNK_HEIGHT; y++)
+            for (int z = 0; z < CHUNK_SIZE; z++)
+            {
+                int onAxis = faceAxis(face) == 0 ? x : z;
+                if (onAxis == slice)
+                    count += coverage[face * kCellsPerFace + (x * CHUNK_HEIGHT + y) * CHUNK_SIZE + z];
+            }
+    return count;
+}
+
+}
+
+// Patch plein de 3x3 chunks : aucune face sur les coutures internes (bords et coins du patch compris),
+// une face par bloc de bord sur le pourtour, et exactement une face en face d'un trou du voisin
+RMDL_TEST(filledChunkPatchHasNoSeamFaces)
+{
+    const int height = 40;
+    const MeshingMode modes[2] = { MeshingMode::Naive, MeshingMode::Greedy };
+    // Faces latérales et tranche de bord correspondante : -Z (2), +Z (3), +X (4), -X (5)
+    const int sideFaces[4] = { 2, 3, 4, 5 };
+    const int sideSlices[4] = { 0, CHUNK_SIZE - 1, CHUNK_SIZE - 1, 0 };
+    const int sideOffsets[4][2] = { { 0, -1 }, { 0, 1 }, { 1, 0 }, { -1, 0 } };
+
+    std::unique_ptr<Chunk> patch[3][3];
+    for (int i = 0; i < 3; i++)
+        for (int j = 0; j < 3; j++)
+        {
+            patch[i][j] = std::make_unique<Chunk>(i - 2, j + 4);
+            fillBelow(*patch[i][j], height);
+        }
+    auto at = [&](int i, int j) -> const Chunk* {
+        return i >= 0 && i < 3 && j >= 0 && j < 3 ? patch[i][j].get() : nullptr;
+    };
+    auto neighborsAt = [&](int i, int j) {
+        return ChunkNeighbors{ at(i - 1, j), at(i + 1, j), at(i, j - 1), at(i, j + 1) };
+    };
+
+    for (MeshingMode mode : modes)
+    {
+        int seamFaces = 0;
+        int missingBorderFaces = 0;
+        for (int i = 0; i < 3; i++)
+            for (int j = 0; j < 3; j++)
+                for (int side = 0; side < 4; side++)
+                {
+                    int cells = countFaceCells(*patch[i][j], neighborsAt(i, j), mode, sideFaces[side], sideSlices[side]);
+                    if (at(i + sideOffsets[side][0], j + sideOffsets[side][1]))
+                        seamFaces += cells;
+                    else
+                        missingBorderFaces += cells != CHUNK_SIZE * height;
+                }
+        RMDL_CHECK(seamFaces == 0);
+        RMDL_CHECK(missingBorderFaces == 0);
+    }
+
+    // Un trou dans le voisin +X du centre, sur la couture : le centre y expose une face et une seule,
+    // le coin (2, 2) voisin du troué ne voit rien changer
+    patch[2][1]->blocks[0][height / 2][7] = BlockType::AIR;
+    for (MeshingMode mode : modes)
+    {
+        RMDL_CHECK(countFaceCells(*patch[1][1], neighborsAt(1, 1), mode, 4, CHUNK_SIZE - 1) == 1);
+        RMDL_CHECK(countFaceCells(*patch[2][1], neighborsAt(2, 1), mode, 5, 0) == 0);
+        RMDL_CHECK(countFaceCells(*patch[2][2], neighborsAt(2, 2), mode, 2, 0) == 0);
+    }
+}
+
+// Coût du re-maillage des voisins quand un chunk arrive (markNeighborsDirty les remaille en entier, sur les
+// workers) comparé à la génération du chunk lui-même, sur le terrain Voronoi. En vol droit, un chunk qui
+// entre par le bord de la fenêtre n'a qu'un voisin déjà maillé : c'est le coût d'un voisin qui compte.
+RMDL_BENCH(neighborRemeshCost)
+{
+    const int repeats = 10;
+    VoronoiVoxel4D generator(WORLD_SEED);
+    std::unique_ptr<Chunk> patch[3][3];
+    for (int i = 0; i < 3; i++)
+        for (int j = 0; j < 3; j++)
+        {
+            patch[i][j] = std::make_unique<Chunk>(i + 7, j - 3);
+            fillTerrain(*patch[i][j], generator);
+        }
+    auto neighborsAt = [&](int i, int j) {
+        return ChunkNeighbors{ i > 0 ? patch[i - 1][j].get() : nullptr, i < 2 ? patch[i + 1][j].get() : nullptr,
+                               j > 0 ? patch[i][j - 1].get() : nullptr, j < 2 ? patch[i][j + 1].get() : nullptr };
+    };
+
+    rmdltest::Stopwatch stopwatch;
+    for (int r = 0; r < repeats; r++)
+        fillTerrain(*patch[1][1], generator);
+    double generateUs = stopwatch.elapsedMs() * 1000.0 / repeats;
+
+    const int around[4][2] = { { 0, 1 }, { 2, 1 }, { 1, 0 }, { 1, 2 } };
+    for (MeshingMode mode : { MeshingMode::Naive, MeshingMode::Greedy })
+    {
+        std::vector<VoxelVertex> vertices;
+        std::vector<uint32_t> indices;
+        stopwatch.restart();
+        for (int r = 0; r < repeats; r++)
+            for (const auto& n : around)
+            {
+                vertices.clear();
+                indices.clear();
+                if (mode == MeshingMode::Greedy)
+                    patch[n[0]][n[1]]->buildMeshGreedy(vertices, indices, neighborsAt(n[0], n[1]));
+                else
+                    patch[n[0]][n[1]]->buildMeshNaive(vertices, indices, neighborsAt(n[0], n[1]));
+            }
+        double remeshUs = stopwatch.elapsedMs() * 1000.0 / (repeats * 4);
+        printf("chunk chargé : génération %.0f µs, re-maillage complet d'un voisin (%s) %.0f µs (%.0f %%), des 4 voisins %.0f %%\n",
+               generateUs, mode == MeshingMode::Greedy ? "glouton" : "naïf", remeshUs, 100.0 * remeshUs / generateUs, 400.0 * remeshUs / generateUs);
+    }
+}
+
+// k-d tree contre scan exhaustif : mêmes index (départage par le plus petit), mêmes distances au bit près.
+// Coordonnées entières sur une petite grille pour provoquer égalités et doublons, et tailles autour d'une feuille
+RMDL_TEST(siteTreeMatchesLinearScan)
+{
+    rmdltest::Random random;
+    const int sizes[] = { 0, 1, 2, 7, 8, 9, 17, 64, 500 };
+
+    for (int count : sizes)
+    {
+        for (int grid = 0; grid < 2; grid++)
+        {
+            std::vector<VoronoiSite4D> sites(count);
+            for (VoronoiSite4D& site : sites)
+            {
+                if (grid)
+                    site.position = { (float)random.range(-4, 4), (float)random.range(-4, 4), (float)random.range(-4, 4), (float)random.range(-2, 2) };
+                else
+                    site.position = { random.uniform(-40, 40), random.uniform(0, 128), random.uniform(-40, 40), random.uniform(-10, 10) };
+                site.blockType = BlockType::STONE;
+                site.influence = 1.0f;
+            }
+            VoronoiSiteTree tree;
+            tree.build(sites);
+
+            int mismatches = 0;
+            for (int q = 0; q < 400; q++)
+            {
+                simd::float4 p = grid ? simd::float4{ (float)random.range(-5, 5), (float)random.range(-5, 5), (float)random.range(-5, 5), (float)random.range(-3, 3) }
+                                      : simd::float4{ random.uniform(-60, 60), random.uniform(-20, 150), random.uniform(-60, 60), random.uniform(-12, 12) };
+
+                int expected = -1;
+                float expectedDists[2] = { std::numeric_limits<float>::max(), std::numeric_limits<float>::max() };
+                for (int i = 0; i < count; i++)
+                {
+                    simd::float4 d = p - sites[i].position;
+                    float dist = sqrtf(d.x * d.x + d.y * d.y + d.z * d.z + d.w * d.w);
+                    if (dist < expectedDists[0])
+                    {
+                        expectedDists[1] = expectedDists[0];
+                        expectedDists[0] = dist;
+                        expected = i;
+                    }
+                    else if (dist < expectedDists[1])
+                        expectedDists[1] = dist;
+                }
+
+                float dist;
+                float dists[2];
+                int index = tree.findNearest(p, dist);
+                tree.findNearestTwo(p, dists);
+                mismatches += index != expected || dist != expectedDists[0] || dists[0] != expectedDists[0] || dists[1] != expectedDists[1];
+            }
+            RMDL_CHECK(mismatches == 0);
+        }
+    }
+}
+
+// Mêmes vérifications à travers VoronoiVoxel4D, sur les sites qu'il génère lui-même
+RMDL_TEST(voronoiQueriesMatchLinearReference)
+{
+    rmdltest::Random random;
+    VoronoiVoxel4D voronoi(89);
+
+    int mismatches = 0;
+    for (int region = 0; region < 20; region++)
+    {
+        int chunkX = random.range(-50, 50);
+        int chunkZ = random.range(-50, 50);
+        float time = random.uniform(0.0f, 20.0f);
+        voronoi.generateSitesForRegion(chunkX, chunkZ, time);
+
+        for (int q = 0; q < 500; q++)
+        {
+            simd::float3 p = { chunkX * CHUNK_SIZE + random.uniform(-32, 48), random.uniform(0, CHUNK_HEIGHT), chunkZ * CHUNK_SIZE + random.uniform(-32, 48) };
+            float t = time + random.uniform(-5, 5);
+            mismatches += voronoi.findClosestSite(p, t) != voronoi.findClosestSiteLinear(p, t);
+            mismatches += voronoi.worleyNoise2(p, t) != voronoi.worleyNoise2Linear(p, t);
+        }
+    }
+    RMDL_CHECK(mismatches == 0);
+}
+
+// k-d tree contre scan linéaire en requêtes/s. D'abord à travers VoronoiVoxel4D sur ses propres régions
+// (50 à 80 sites, ce que voit la génération), puis l'arbre seul sur des tailles plus grandes
+RMDL_BENCH(siteTreeVersusLinearScan)
+{
+    rmdltest::Random random;
+    const int regions = 20;
+    const int queries = 20000;
+
+    VoronoiVoxel4D voronoi(89);
+    std::vector<simd::float3> points(queries);
+    std::vector<float> times(queries);
+    double treeMs = 0.0;
+    double linearMs = 0.0;
+    double treeWorleyMs = 0.0;
+    double linearWorleyMs = 0.0;
+    float checksum = 0.0f;
+    for (int region = 0; region < regions; region++)
+    {
+        int chunkX = random.range(-50, 50);
+        int chunkZ = random.range(-50, 50);
+        float time = random.uniform(0.0f, 20.0f);
+        voronoi.generateSitesForRegion(chunkX, chunkZ, time);
+        for (int q = 0; q < queries; q++)
+        {
+            points[q] = { chunkX * CHUNK_SIZE + random.uniform(0, CHUNK_SIZE), random.uniform(5, 100), chunkZ * CHUNK_SIZE + random.uniform(0, CHUNK_SIZE) };
+            times[q] = time;
+        }
+
+        rmdltest::Stopwatch stopwatch;
+        for (int q = 0; q < queries; q++)
+            checksum += voronoi.findClosestSite(points[q], times[q])->influence;
+        treeMs += stopwatch.elapsedMs();
+        stopwatch.restart();
+        for (int q = 0; q < queries; q++)
+            checksum += voronoi.findClosestSiteLinear(points[q], times[q])->influence;
+        linearMs += stopwatch.elapsedMs();
+        stopwatch.restart();
+        for (int q = 0; q < queries; q++)
+            checksum += voronoi.worleyNoise2(points[q], times[q]);
+        treeWorleyMs += stopwatch.elapsedMs();
+        stopwatch.restart();
+        for (int q = 0; q < queries; q++)
+            checksum += voronoi.worleyNoise2Linear(points[q], times[q]);
+        linearWorleyMs += stopwatch.elapsedMs();
+    }
+    double total = (double)regions * queries;
+    printf("régions générées (50-80 sites) : plus proche %.2f M req/s (arbre) contre %.2f (linéaire), "
+           "deux plus proches %.2f contre %.2f\n",
+           total / treeMs / 1000.0, total / linearMs / 1000.0, total / treeWorleyMs / 1000.0, total / linearWorleyMs / 1000.0);
+
+    for (int count : { 64, 150, 500, 2000 })
+    {
+        std::vector<VoronoiSite4D> sites(count);
+        for (VoronoiSite4D& site : sites)
+            site.position = { random.uniform(-24, 40), random.uniform(0, 128), random.uniform(-24, 40), random.uniform(-10, 10) };
+        VoronoiSiteTree tree;
+        tree.build(sites);
+        std::vector<simd::float4> queryPoints(queries);
+        for (simd::float4& p : queryPoints)
+            p = { random.uniform(0, CHUNK_SIZE), random.uniform(0, 128), random.uniform(0, CHUNK_SIZE), random.uniform(-10, 10) };
+
+        rmdltest::Stopwatch stopwatch;
+        for (const simd::float4& p : queryPoints)
+        {
+            float dist;
+            checksum += (float)tree.findNearest(p, dist) + dist;
+        }
+        double treeQueryMs = stopwatch.elapsedMs();
+        stopwatch.restart();
+        for (const simd::float4& p : queryPoints)
+        {
+            int best = -1;
+            float bestDist = std::numeric_limits<float>::max();
+            for (int i = 0; i < count; i++)
+            {
+                simd::float4 d = p - sites[i].position;
+                float dist = sqrtf(d.x * d.x + d.y * d.y + d.z * d.z + d.w * d.w);
+                if (dist < bestDist)
+                {
+                    bestDist = dist;
+                    best = i;
+                }
+            }
+            checksum += (float)best + bestDist;
+        }
+        double linearQueryMs = stopwatch.elapsedMs();
+        printf("arbre seul, %4d sites : %.2f M req/s contre %.2f (linéaire), x%.1f\n", count,
+               queries / treeQueryMs / 1000.0, queries / linearQueryMs / 1000.0, linearQueryMs / treeQueryMs);
+    }
+    printf("(%g)\n", checksum);
+}
+
+namespace
+{
+
+// Toute la fenêtre autour de la caméra est maillée et uploadée, plus rien en vol
+bool windowSettled(VoxelWorld& world, simd::float3 camera)
+{
+    if (world.getQueuedJobCount() != 0)
+        return false;
+    int camChunkX = (int)floorf(camera.x / CHUNK_SIZE);
+    int camChunkZ = (int)floorf(camera.z / CHUNK_SIZE);
+    for (int x = -RENDER_DISTANCE; x <= RENDER_DISTANCE; x++)
+        for (int z = -RENDER_DISTANCE; z <= RENDER_DISTANCE; z++)
+        {
+            Chunk* chunk = world.getChunk(camChunkX + x, camChunkZ + z);
+            if (chunk->state != VoxelChunkState::Ready || chunk->needsRebuild || chunk->pinCount != 0)
+                return false;
+        }
+    return true;
+}
+
+}
+
+// Pipeline de workers sous contrainte, à lancer aussi sous TSan (voir CMakeLists.txt) : la caméra saute
+// au-delà du rayon de déchargement pendant que génération et maillage sont en vol, avec des éditions
+// (souvent en bord de chunk) à chaque frame. Une fois la caméra posée, tout doit converger : fenêtre
+// Ready, plus aucun épinglage, et la dernière écriture de chaque bloc édité visible.
+RMDL_TEST(workerPoolSurvivesEditsAndUnloads)
+{
+    NS::SharedPtr<MTL::Device> device = NS::TransferPtr(MTL::CreateSystemDefaultDevice());
+    RMDL_CHECK(device.get() != nullptr);
+    if (!device.get())
+        return;
+
+    VoxelWorld world(device.get(), MTL::PixelFormatBGRA8Unorm, MTL::PixelFormatDepth32Float, nullptr);
+    rmdltest::Random random;
+    const BlockType kEditTypes[3] = { BlockType::AIR, BlockType::METAL, BlockType::GLOWING };
+
+    auto editNear = [&](simd::float3 camera, int radius) {
+        int x = (int)camera.x + random.range(-radius, radius);
+        int z = (int)camera.z + random.range(-radius, radius);
+        // Un tiers sur un bord de chunk, qui touche aussi le voisin
+        if (random.range(0, 2) == 0)
+            x = (x / CHUNK_SIZE) * CHUNK_SIZE + (random.range(0, 1) ? 0 : CHUNK_SIZE - 1);
+        int y = random.range(5, 100);
+        BlockType type = kEditTypes[random.range(0, 2)];
+        world.setBlock(x, y, z, type);
+        return std::make_pair(std::array<int, 3>{ x, y, z }, type);
+    };
+
+    simd::float3 camera = { 0.0f, 60.0f, 0.0f };
+    for (int frame = 0; frame < 120; frame++)
+    {
+        if (frame == 30 || frame == 70)
+            camera.x += (RENDER_DISTANCE + 6) * CHUNK_SIZE * (frame == 30 ? 1.0f : -1.0f);
+        else
+            camera.z += 1.0f;
+
+        for (int e = 0; e < 8; e++)
+            editNear(camera, RENDER_DISTANCE * CHUNK_SIZE);
+        world.getBlock((int)camera.x + random.range(-64, 64), random.range(0, CHUNK_HEIGHT - 1), (int)camera.z + random.range(-64, 64));
+        world.update(0.016f, camera, device.get());
+        std::this_thread::sleep_for(std::chrono::microseconds(500));
+    }
+
+    // Caméra posée : éditions pendant que la nouvelle fenêtre se génère encore
+    std::map<std::array<int, 3>, BlockType> expected;
+    for (int frame = 0; frame < 60; frame++)
+    {
+        for (int e = 0; e < 8; e++)
+        {
+            auto edit = editNear(camera, (RENDER_DISTANCE - 1) * CHUNK_SIZE);
+            expected[edit.first] = edit.second;
+        }
+        world.update(0.016f, camera, device.get());
+        std::this_thread::sleep_for(std::chrono::microseconds(500));
+    }
+
+    bool settled = false;
+    for (int i = 0; i < 60000 && !settled; i++)
+    {
+        world.update(0.016f, camera, device.get());
+        settled = windowSettled(world, camera);
+        if (!settled)
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    RMDL_CHECK(settled);
+
+    int lostEdits = 0;
+    for (const auto& [position, type] : expected)
+        lostEdits += world.getBlock(position[0], position[1], position[2]) != type;
+    RMDL_CHECK(lostEdits == 0);
+}
+
+namespace
+{
+
+// Temps CPU du thread appelant : ce que update() coûte vraiment au thread principal, sans les
+// préemptions par les workers quand la machine a moins de cœurs que de threads
+double threadCpuUs()
+{
+    timespec now;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &now);
+    return now.tv_sec * 1e6 + now.tv_nsec / 1e3;
+}
+
+}
+
+// Vol droit de 10k chunks à 4 blocs par frame, 16 ms par frame : temps de update() sur le thread principal
+// (médiane, p99, max, temps CPU et temps mur) contre le coût du budget d'uploads, kMaxMeshUploadsPerUpdate
+// maillages de terrain uploadés d'affilée. Le premier frame crée toute la fenêtre, il est compté à part
+RMDL_BENCH(flythroughUpdateTime)
+{
+    NS::SharedPtr<MTL::Device> device = NS::TransferPtr(MTL::CreateSystemDefaultDevice());
+    if (!device.get())
+        return;
+
+    // Coût d'un upload de chunk de terrain, au pire de quelques essais
+    VoronoiVoxel4D generator(WORLD_SEED);
+    Chunk uploaded(3, -2);
+    fillTerrain(uploaded, generator);
+    uploaded.buildMesh({});
+    double uploadUs = 0.0;
+    for (int i = 0; i < 8; i++)
+    {
+        double before = threadCpuUs();
+        uploaded.uploadMesh(device.get());
+        uploadUs = std::max(uploadUs, threadCpuUs() - before);
+    }
+
+    VoxelWorld world(device.get(), MTL::PixelFormatBGRA8Unorm, MTL::PixelFormatDepth32Float, nullptr);
+    const int window = 2 * RENDER_DISTANCE + 1;
+    const int chunkCount = 10000;
+    const int crossedChunks = (chunkCount - window * window) / window;
+    const float speed = 4.0f;
+    const int frames = (int)(crossedChunks * CHUNK_SIZE / speed);
+
+    std::vector<double> cpuUs;
+    std::vector<double> wallUs;
+    simd::float3 camera = { 8.0f, 60.0f, 8.0f };
+    for (int frame = 0; frame < frames; frame++)
+    {
+        camera.z += speed;
+        double before = threadCpuUs();
+        rmdltest::Stopwatch stopwatch;
+        world.update(0.016f, camera, device.get());
+        double frameUs = stopwatch.elapsedMs() * 1000.0;
+        cpuUs.push_back(threadCpuUs() - before);
+        wallUs.push_back(frameUs);
+        if (frameUs < 16000.0)
+            std::this_thread::sleep_for(std::chrono::microseconds((int)(16000.0 - frameUs)));
+    }
+
+    printf("vol de %d chunks (%d frames), premier frame %.0f µs CPU\n", window * window + crossedChunks * window, frames, cpuUs[0]);
+    for (std::vector<double>* times : { &cpuUs, &wallUs })
+    {
+        std::sort(times->begin() + 1, times->end());
+        int count = frames - 1;
+        printf("update() %s : médiane %.0f µs, p99 %.0f µs, max %.0f µs\n", times == &cpuUs ? "CPU" : "mur",
+               (*times)[1 + count / 2], (*times)[1 + count * 99 / 100], times->back());
+    }
+    printf("budget : %d uploads x %.0f µs = %.0f µs\n", kMaxMeshUploadsPerUpdate, uploadUs, kMaxMeshUploadsPerUpdate * uploadUs);
+}